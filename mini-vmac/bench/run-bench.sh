@@ -0,0 +1,93 @@
+#!/bin/sh
+# Runs the scenarios in scenarios.txt with BlahBlobBench (see
+# ../linux-headless-x86_64) and checks the results against
+# thresholds.txt. Full results of each run are left in
+# results/. Exits with status 1 if any threshold is missed.
+#
+# usage: run-bench.sh [scenario ...]
+#
+# BENCH, DISKS and OUT in the environment override where the
+# benchmark program, the ROM and disk images, and the results
+# are.
+
+cd "$(dirname "$0")" || exit 2
+
+BENCH=${BENCH:-../linux-headless-x86_64/BlahBlobBench}
+DISKS=${DISKS:-../blah-blob-resources}
+OUT=${OUT:-results}
+
+if [ ! -x "$BENCH" ]; then
+	echo "$BENCH not found, run make in linux-headless-x86_64" >&2
+	exit 2
+fi
+
+mkdir -p "$OUT"
+rm -f "$OUT/.failed" # left behind if a run was interrupted
+
+wanted=" $* "
+status=0
+
+grep -v '^#' scenarios.txt | while read -r name seconds recording; do
+	[ -z "$name" ] && continue
+	if [ "$wanted" != "  " ]; then
+		case "$wanted" in
+			*" $name "*) ;;
+			*) continue ;;
+		esac
+	fi
+
+	if [ "$recording" = "-" ]; then
+		set -- -d "$DISKS" --seconds "$seconds"
+	elif [ -f "$recording" ]; then
+		set -- -d "$DISKS" --seconds "$seconds" --replay "$recording"
+	else
+		echo "$name: FAILED, no $recording"
+		echo 1 > "$OUT/.failed"
+		continue
+	fi
+
+	if ! "$BENCH" "$@" > "$OUT/$name.txt" 2>&1; then
+		echo "$name: FAILED to run, see $OUT/$name.txt"
+		echo 1 > "$OUT/.failed"
+		continue
+	fi
+
+	awk -v sc="$name" '
+		NR == FNR {
+			if ($1 == sc) {
+				n++; m[n] = $2; op[n] = $3; v[n] = $4
+			}
+			next
+		}
+		{
+			k = $1; sub(":$", "", k); r[k] = $2
+		}
+		END {
+			printf "%s: %s MIPS, %s s wall, %s frames,", sc,
+				r["mips"], r["wall_seconds"], r["frames_drawn"]
+			printf " %s/%s bytes disk r/w, %s KB peak rss\n",
+				r["disk_read_bytes"], r["disk_write_bytes"],
+				r["peak_rss_kb"]
+			bad = 0
+			for (i = 1; i <= n; i++) {
+				x = r[m[i]]
+				if (x == "" \
+					|| (op[i] == "min" && x + 0 < v[i] + 0) \
+					|| (op[i] == "max" && x + 0 > v[i] + 0) \
+					|| (op[i] == "eq" && x != v[i]))
+				{
+					printf "  FAIL %s %s %s (got %s)\n",
+						m[i], op[i], v[i], x
+					bad = 1
+				}
+			}
+			exit bad
+		}' thresholds.txt "$OUT/$name.txt" || echo 1 > "$OUT/.failed"
+done
+
+if [ -f "$OUT/.failed" ]; then
+	rm -f "$OUT/.failed"
+	status=1
+fi
+
+exit $status
@@ -0,0 +1,45 @@
+/*
+	see comment in OSGCOMUD.h
+
+	This file is automatically generated by the build system,
+	which tries to know what options are valid in what
+	combinations. Avoid changing this file manually unless
+	you know what you're doing.
+*/
+
+#define MySoundEnabled 1
+
+#define MySoundRecenterSilence 0
+#define kLn2SoundSampSz 3
+
+#define dbglog_HAVE 0
+#define WantAbnormalReports 0
+
+#define NumDrives 6
+#define NonDiskProtect 1
+#define IncludeSonyRawMode 1
+#define IncludeSonyGetName 1
+#define IncludeSonyNew 1
+#define IncludeSonyNameNew 1
+
+#define vMacScreenHeight 342
+#define vMacScreenWidth 512
+#define vMacScreenDepth 0
+
+#define kROM_Size 0x00040000
+
+#define IncludePbufs 1
+#define NumPbufs 4
+
+#define EnableMouseMotion 1
+
+#define IncludeHostTextClipExchange 1
+#define EnableAutoSlow 1
+#define EmLocalTalk 0
+#define AutoLocation 1
+#define AutoTimeZone 1
+
+#define WantInstructionCount 1
+#define WantLagStats 1
+#define WantSliceStats 1
+#define WantSoundSubTick 1
@@ -0,0 +1,68 @@
+/*
+	see comment in OSGCOMUD.h
+
+	This file is automatically generated by the build system,
+	which tries to know what options are valid in what
+	combinations. Avoid changing this file manually unless
+	you know what you're doing.
+*/
+
+
+#define RomFileName "MacII.ROM"
+#define kCheckSumRom_Size 0x00040000
+#define kRomCheckSum1 0x9779D2C4
+#define kRomCheckSum2 0x97221136
+#define RomStartCheckSum 1
+#define SaveDialogEnable 1
+#define EnableAltKeysMode 0
+#define MKC_formac_Control MKC_CM
+#define MKC_formac_Command MKC_Command
+#define MKC_formac_Option MKC_Option
+#define MKC_formac_Shift MKC_Shift
+#define MKC_formac_CapsLock MKC_CapsLock
+#define MKC_formac_Escape MKC_Escape
+#define MKC_formac_BackSlash MKC_BackSlash
+#define MKC_formac_Slash MKC_Slash
+#define MKC_formac_Grave MKC_Grave
+#define MKC_formac_Enter MKC_Enter
+#define MKC_formac_PageUp MKC_PageUp
+#define MKC_formac_PageDown MKC_PageDown
+#define MKC_formac_Home MKC_Home
+#define MKC_formac_End MKC_End
+#define MKC_formac_Help MKC_Help
+#define MKC_formac_ForwardDel MKC_ForwardDel
+#define MKC_formac_F1 MKC_Option
+#define MKC_formac_F2 MKC_Command
+#define MKC_formac_F3 MKC_F3
+#define MKC_formac_F4 MKC_F4
+#define MKC_formac_F5 MKC_F5
+#define MKC_formac_RControl MKC_CM
+#define MKC_formac_RCommand MKC_Command
+#define MKC_formac_ROption MKC_Option
+#define MKC_formac_RShift MKC_Shift
+#define MKC_UnMappedKey  MKC_Control
+#define VarFullScreen 0
+#define WantInitFullScreen 0
+#define MayFullScreen 0
+#define MayNotFullScreen 1
+#define WantInitMagnify 0
+#define EnableMagnify 0
+#define WantInitRunInBackground 0
+#define WantInitNotAutoSlow 0
+#define WantInitSpeedValue -1
+#define WantEnblCtrlInt 1
+#define WantEnblCtrlRst 1
+#define WantEnblCtrlKtg 1
+#define UseControlKeys 0
+#define UseActvCode 0
+#define EnableDemoMsg 0
+#define EnableEvtReplay 1
+#define EnableScrnCapt 1
+#define EnableScrnVrfy 1
+#define EnableSndCapt 1
+
+/* version and other info to display to user */
+
+#define NeedIntlChars 0
+
+#define kBldOpts "-br 37 -t lx64 -m II -hres 512 -vres 342 -depth 0 -magnify 1 -speed a"
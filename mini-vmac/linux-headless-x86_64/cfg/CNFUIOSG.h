@@ -0,0 +1,24 @@
+/*
+	see comment in OSGCOMUI.h
+
+	This file is automatically generated by the build system,
+	which tries to know what options are valid in what
+	combinations. Avoid changing this file manually unless
+	you know what you're doing.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#define WantOSGLUNUL 1
+
+#define kStrAppName "Mini vMac"
+#define kAppVariationStr "Blah Blob"
+#define kStrCopyrightYear "2020"
+#define kMaintainerName "unknown"
+#define kStrHomePage "(unknown)"
@@ -0,0 +1,8 @@
+/*
+	see comment in PICOMMON.h
+
+	This file is automatically generated by the build system,
+	which tries to know what options are valid in what
+	combinations. Avoid changing this file manually unless
+	you know what you're doing.
+*/
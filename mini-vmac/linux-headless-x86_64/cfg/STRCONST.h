@@ -0,0 +1 @@
+#include "STRCNENG.h"
@@ -13,6 +13,9 @@
 #include <string.h>
 
 #define EnableDragDrop 1
+#define MayUseScrnScal 1
+#define MayUseFrmPace 1
+#define WantFrameStats 1
 #define WantOSGLUSDL 1
 
 #define kStrAppName "Mini vMac"
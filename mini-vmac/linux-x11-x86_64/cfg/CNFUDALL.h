@@ -21,6 +21,7 @@
 #define IncludeSonyGetName 1
 #define IncludeSonyNew 1
 #define IncludeSonyNameNew 1
+#define IncludeSonyAsync 1
 
 #define vMacScreenHeight 342
 #define vMacScreenWidth 512
@@ -38,3 +39,6 @@
 #define EmLocalTalk 0
 #define AutoLocation 1
 #define AutoTimeZone 1
+
+#define WantSoundSubTick 1
+#define WantSoundAutoSlow 1
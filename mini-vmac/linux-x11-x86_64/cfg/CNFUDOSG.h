@@ -58,6 +58,10 @@
 #define UseControlKeys 1
 #define UseActvCode 0
 #define EnableDemoMsg 0
+#define EnableEvtReplay 1
+#define EnableScrnCapt 1
+#define EnableScrnVrfy 1
+#define EnableSndCapt 1
 
 /* version and other info to display to user */
 
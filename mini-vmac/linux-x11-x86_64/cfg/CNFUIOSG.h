@@ -18,6 +18,9 @@
 #include <X11/keysym.h>
 #include <X11/keysymdef.h>
 #include <X11/Xatom.h>
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <errno.h>
@@ -30,6 +33,10 @@
 #define HaveSysctlPath 0
 
 #define EnableDragDrop 1
+#define MayUseXShm 1
+#define MayUseScrnScal 1
+#define MayUseFrmPace 1
+#define MayUseSoundThread 1
 #define WantOSGLUXWN 1
 
 #define kStrAppName "Mini vMac"
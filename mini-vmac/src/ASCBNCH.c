@@ -0,0 +1,304 @@
+/*
+	ASCBNCH.c
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	ASC BeNCHmark
+
+	Stand alone test and microbenchmark for ASCEMDEV.c, linked with
+	the same ASCEMDEV.o as BlahBlobBench, with the rest of the
+	emulator stubbed out.
+
+	First it makes two million random register writes, FIFO and
+	wave table buffer writes, volume changes and sub ticks, with
+	MySound_BeginWrite handing out short blocks at random, and
+	hashes every sample made and the interrupts raised. The hash
+	must match kGoldenHash, which came from the ASC_SubTick that
+	made each sample one at a time (before it made them a block
+	at a time), so any change to what the ASC plays shows up.
+
+	Then it times ASC_SubTick alone (guest FIFO writes are timed
+	apart) for FIFO mono, FIFO stereo and four voice wave table
+	sound, printing the fastest of 5 rounds of so many ticks:
+
+		AscBench [ticks]
+
+	It exits with status 1 if the hash differs.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "PICOMMON.h"
+#include "MINEM68K.h"
+#include "ASCEMDEV.h"
+
+#define BnchMoveBytesDecl GLOBALOSGLUPROC
+	/* ASCEMDEV.o calls it */
+#include "BNCHUTIL.h"
+
+#define kGoldenHash 0x96e942b8UL
+#define kGoldenInterrupts 3398
+
+#define kRandomSteps 2000000
+#define kTimeRounds 5 /* timings are the fastest round */
+
+LOCALVAR tbSoundSamp SampBuf[512];
+LOCALVAR tpSoundSamp SampPtr;
+LOCALVAR blnr ShortBlocks = falseblnr;
+LOCALVAR ui5b Hash = 2166136261UL; /* FNV-1a */
+LOCALVAR ui5r Interrupts = 0;
+
+LOCALPROC HashByte(ui3r b)
+{
+	Hash = (Hash ^ b) * 16777619UL;
+}
+
+/* --- the rest of the emulator, stubbed --- */
+
+GLOBALOSGLUFUNC tpSoundSamp MySound_BeginWrite(ui4r n, ui4r *actL)
+{
+	if (ShortBlocks && (n > 1)) {
+		n = 1 + NextRnd() % n;
+	}
+	*actL = n;
+	SampPtr = SampBuf;
+	return SampPtr;
+}
+
+GLOBALOSGLUPROC MySound_EndWrite(ui4r actL)
+{
+	ui4r i;
+
+	if (ShortBlocks) {
+		for (i = 0; i < actL; ++i) {
+#if 3 == kLn2SoundSampSz
+			HashByte(SampPtr[i]);
+#else
+			HashByte(SampPtr[i] & 0xFF);
+			HashByte(SampPtr[i] >> 8);
+#endif
+		}
+	}
+}
+
+EXPORTPROC ASC_interrupt_PulseNtfy(void);
+
+GLOBALPROC ASC_interrupt_PulseNtfy(void)
+{
+	++Interrupts;
+}
+
+#if UseLazySubTick
+EXPORTPROC SubTickTaskSync(void);
+
+GLOBALPROC SubTickTaskSync(void)
+{
+	/* each sub tick here is made when called for */
+}
+#endif
+
+GLOBALOSGLUPROC ReserveAllocOneBlock(ui3p *p, uimr n, ui3r align,
+	blnr FillOnes)
+{
+	UnusedParam(align);
+	UnusedParam(FillOnes);
+	*p = (ui3p)malloc(n);
+}
+
+GLOBALFUNC ui3p get_real_address0(ui5b L, blnr WritableMem, CPTR addr,
+	ui5b *actL)
+{
+	UnusedParam(L);
+	UnusedParam(WritableMem);
+	UnusedParam(addr);
+	*actL = 0;
+	return nullpr;
+}
+
+GLOBALFUNC ui4r get_vm_word(CPTR addr)
+{
+	UnusedParam(addr);
+	return 0;
+}
+
+GLOBALFUNC ui5r get_vm_long(CPTR addr)
+{
+	UnusedParam(addr);
+	return 0;
+}
+
+GLOBALPROC put_vm_word(CPTR addr, ui4r w)
+{
+	UnusedParam(addr);
+	UnusedParam(w);
+}
+
+GLOBALPROC put_vm_long(CPTR addr, ui5r l)
+{
+	UnusedParam(addr);
+	UnusedParam(l);
+}
+
+/* --- equivalence --- */
+
+LOCALPROC RandomStep(void)
+{
+	ui5r r = NextRnd();
+	ui5r i;
+	ui5r n;
+	CPTR a;
+
+	switch (r % 16) {
+		case 0:
+			(void) ASC_Access(NextRnd() % 3, trueblnr, 0x801);
+			break;
+		case 1:
+			(void) ASC_Access(NextRnd() & 2, trueblnr, 0x802);
+			break;
+		case 2:
+			(void) ASC_Access(NextRnd() & 0x80, trueblnr, 0x803);
+			break;
+		case 3:
+			HashByte(ASC_Access(0, falseblnr, 0x804));
+			break;
+		case 4:
+			(void) ASC_Access((NextRnd() % 8) << 5, trueblnr, 0x806);
+			break;
+		case 5:
+		case 6:
+			/* wave table phase or frequency, small ones mostly */
+			(void) ASC_Access((0 == (NextRnd() & 3))
+				? (NextRnd() & 0xFF) : (NextRnd() & 0x03),
+				trueblnr, 0x810 + NextRnd() % 0x20);
+			break;
+		case 7:
+		case 8:
+		case 9:
+			/* a burst to the FIFO (or buffer), A or B */
+			n = NextRnd() % 0x300;
+			a = NextRnd() & 0x400;
+			for (i = 0; i < n; ++i) {
+				(void) ASC_Access(NextRnd() & 0xFF, trueblnr,
+					a + (i & 0x3FF));
+			}
+			break;
+		default:
+			ASC_SubTick(NextRnd() % kNumSubTicks);
+			break;
+	}
+}
+
+/* --- timing --- */
+
+LOCALPROC TopUp(CPTR a)
+{
+	ui5r i;
+
+	/* a tick's worth, as a sound driver would */
+	for (i = 0; i < 370; ++i) {
+		(void) ASC_Access(NextRnd() & 0xFF, trueblnr, a);
+	}
+}
+
+LOCALPROC Time(char *name, ui3r mode, ui3r control, long n)
+{
+	long i;
+	int j;
+	int k;
+	double t;
+	double tw;
+	double t0;
+	double best = 0;
+	double bestw = 0;
+
+	(void) ASC_Access(0, trueblnr, 0x801);
+	(void) ASC_Access(control, trueblnr, 0x802);
+	(void) ASC_Access(mode, trueblnr, 0x801);
+	(void) ASC_Access(0xA0, trueblnr, 0x806);
+	if (2 == mode) {
+		for (j = 0; j < 0x800; ++j) {
+			(void) ASC_Access(NextRnd() & 0xFF, trueblnr, j);
+		}
+		for (j = 0; j < 4; ++j) {
+			/* frequency 0x10000 - 0x40000, 87 - 348 Hz */
+			(void) ASC_Access(1 + j, trueblnr, 0x815 + 8 * j);
+		}
+	} else {
+		TopUp(0);
+		TopUp(0x400);
+	}
+
+	for (k = 0; k < kTimeRounds; ++k) {
+		t = 0;
+		tw = 0;
+		for (i = 0; i < n; ++i) {
+			if (1 == mode) {
+				t0 = Now();
+				TopUp(0);
+				if (0 != control) {
+					TopUp(0x400);
+				}
+				tw += Now() - t0;
+			}
+			t0 = Now();
+			for (j = 0; j < kNumSubTicks; ++j) {
+				ASC_SubTick(j);
+			}
+			t += Now() - t0;
+		}
+		if ((0 == k) || (t < best)) {
+			best = t;
+		}
+		if ((0 == k) || (tw < bestw)) {
+			bestw = tw;
+		}
+	}
+
+	printf("%-14s %6.3f us/tick sub ticks", name, best * 1e6 / n);
+	if (1 == mode) {
+		printf(", %7.3f us/tick FIFO writes", bestw * 1e6 / n);
+	}
+	printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	long n = (argc > 1) ? atol(argv[1]) : 100000;
+	long i;
+	blnr ok;
+
+	if (n <= 0) {
+		fprintf(stderr, "usage: %s [ticks]\n", argv[0]);
+		return 2;
+	}
+
+	ShortBlocks = trueblnr;
+	for (i = 0; i < kRandomSteps; ++i) {
+		RandomStep();
+	}
+	ShortBlocks = falseblnr;
+
+	ok = (kGoldenHash == Hash) && (kGoldenInterrupts == Interrupts);
+	printf("samples hash %08lx, %lu interrupts: %s\n",
+		(unsigned long)Hash, (unsigned long)Interrupts,
+		ok ? "matched" : "DIFFERED");
+
+	Time("FIFO mono", 1, 0, n);
+	Time("FIFO stereo", 1, 2, n);
+	Time("wave table", 2, 0, n);
+
+	return ok ? 0 : 1;
+}
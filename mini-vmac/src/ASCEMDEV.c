@@ -23,8 +23,18 @@
 #if EmASC
 
 #include "VIAEMDEV.h"
+#if IncludeExtnModPlayer
+#include "MINEM68K.h"
+#endif
 
 #include "ASCEMDEV.h"
+#if UseLazySubTick
+#include "PROGMAIN.h"
+#endif
+
+#if IncludeExtnModPlayer
+#include "MODPLAYR.h"
+#endif
 
 /*
 	ReportAbnormalID unused 0x0F0E, 0x0F1E - 0x0FFF
@@ -98,6 +108,10 @@ LOCALPROC ASC_ClearFIFO(void)
 
 GLOBALFUNC ui5b ASC_Access(ui5b Data, blnr WriteMem, CPTR addr)
 {
+#if UseLazySubTick
+	SubTickTaskSync(); /* the sub ticks before this access */
+#endif
+
 	if (addr < 0x800) {
 		if (WriteMem) {
 			if (1 == SoundReg801) {
@@ -505,6 +519,10 @@ GLOBALFUNC ui5b ASC_Access(ui5b Data, blnr WriteMem, CPTR addr)
 		ReportAbnormalID(0x0F19, "unknown ASC reg");
 	}
 
+#if UseLazySubTick
+	SubTickTaskSync(); /* may now be seen, such as FIFO filled */
+#endif
+
 	return Data;
 }
 
@@ -535,13 +553,172 @@ LOCALVAR const ui3r SubTick_n[kNumSubTicks] = {
 	23,  23,  23,  23,  23,  23,  23,  24
 };
 
+#if MySoundEnabled
+
+/*
+	The samples of a sub tick are made a block at a time rather
+	than one at a time, the FIFO in at most two runs (it wraps
+	at 0x400). The stereo average and the volume scaling use
+	SSE2 where there is one, which AscBench (ASCBNCH.c) measured
+	faster for FIFO sound; the wave table loop stays plain C,
+	as a vector version was no faster there.
+*/
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define ASC_SSE2 1
+#include <emmintrin.h>
+#else
+#define ASC_SSE2 0
+#endif
+
+LOCALPROC ASC_Fill(tpSoundSamp p, ui4r n, trSoundSamp v)
+{
+	ui4r i;
+
+	for (i = 0; i < n; i++) {
+		p[i] = v;
+	}
+}
+
+LOCALPROC ASC_StereoRun(tpSoundSamp p, ui3p a, ui4r n)
+{
+	/* average of channel A at a, and channel B 0x400 after */
+	ui4r i = 0;
+	ui3p b = a + 0x400;
+
+#if (3 == kLn2SoundSampSz) && ASC_SSE2
+	__m128i one = _mm_set1_epi8(1);
+
+	for (; i + 16 <= n; i += 16) {
+		__m128i va = _mm_loadu_si128((__m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((__m128i *)(b + i));
+
+		/* _mm_avg_epu8 rounds up, this rounds down */
+		_mm_storeu_si128((__m128i *)(p + i),
+			_mm_sub_epi8(_mm_avg_epu8(va, vb),
+				_mm_and_si128(_mm_xor_si128(va, vb), one)));
+	}
+#endif
+
+	for (; i < n; i++) {
+		p[i] = ((a[i] + b[i])
+#if 4 == kLn2SoundSampSz
+			<< 8
+#endif
+			) >> 1;
+	}
+}
+
+LOCALPROC ASC_MonoRun(tpSoundSamp p, ui3p a, ui4r n)
+{
+#if 3 == kLn2SoundSampSz
+	MyMoveBytes((anyp)a, (anyp)p, n);
+#else
+	ui4r i;
+
+	for (i = 0; i < n; i++) {
+		p[i] = a[i] << 8;
+	}
+#endif
+}
+
+LOCALPROC ASC_FIFOOut(tpSoundSamp p, ui4r n, blnr stereo)
+{
+	/* n samples from ASC_FIFO_Out on, which isn't changed */
+	ui4r j = ASC_FIFO_Out & 0x3FF;
+	ui4r k;
+
+	while (n > 0) {
+		k = 0x400 - j;
+		if (k > n) {
+			k = n;
+		}
+		if (stereo) {
+			ASC_StereoRun(p, ASC_SampBuff + j, k);
+		} else {
+			ASC_MonoRun(p, ASC_SampBuff + j, k);
+		}
+		p += k;
+		n -= k;
+		j = 0;
+	}
+}
+
+LOCALPROC ASC_WaveOut(tpSoundSamp p, ui4r n, ui5b *phase, ui5b *freq)
+{
+	/*
+		four wavetable channels, of 0x200 samples each,
+		indexed at ((phase + 0x4000) >> 15) & 0x1FF.
+	*/
+	ui4r i;
+	ui5b ph0 = phase[0];
+	ui5b ph1 = phase[1];
+	ui5b ph2 = phase[2];
+	ui5b ph3 = phase[3];
+
+	for (i = 0; i < n; i++) {
+		ph0 += freq[0];
+		ph1 += freq[1];
+		ph2 += freq[2];
+		ph3 += freq[3];
+		p[i] = (ASC_SampBuff[((ph0 + 0x4000) >> 15) & 0x1FF]
+			+ ASC_SampBuff[0x0200 + (((ph1 + 0x4000) >> 15) & 0x1FF)]
+			+ ASC_SampBuff[0x0400 + (((ph2 + 0x4000) >> 15) & 0x1FF)]
+			+ ASC_SampBuff[0x0600 + (((ph3 + 0x4000) >> 15) & 0x1FF)])
+			>> 2;
+	}
+	phase[0] = ph0;
+	phase[1] = ph1;
+	phase[2] = ph2;
+	phase[3] = ph3;
+}
+
+LOCALPROC ASC_VolumeRun(tpSoundSamp p, ui4r n, ui3r SoundVolume)
+{
+	ui4r i = 0;
+	ui5b mult = (ui5b)vol_mult[SoundVolume];
+	trSoundSamp offset = vol_offset[SoundVolume];
+
+	/* (x * mult) >> 16 is the high half of a 16 bit multiply */
+#if ASC_SSE2
+	__m128i vm = _mm_set1_epi16((short)mult);
+#if 3 == kLn2SoundSampSz
+	__m128i vo = _mm_set1_epi8((char)offset);
+	__m128i z = _mm_setzero_si128();
+
+	for (; i + 16 <= n; i += 16) {
+		__m128i x = _mm_loadu_si128((__m128i *)(p + i));
+
+		_mm_storeu_si128((__m128i *)(p + i), _mm_add_epi8(
+			_mm_packus_epi16(
+				_mm_mulhi_epu16(_mm_unpacklo_epi8(x, z), vm),
+				_mm_mulhi_epu16(_mm_unpackhi_epi8(x, z), vm)),
+			vo));
+	}
+#else
+	__m128i vo = _mm_set1_epi16((short)offset);
+
+	for (; i + 8 <= n; i += 8) {
+		_mm_storeu_si128((__m128i *)(p + i), _mm_add_epi16(
+			_mm_mulhi_epu16(_mm_loadu_si128((__m128i *)(p + i)), vm),
+			vo));
+	}
+#endif
+#endif
+
+	for (; i < n; i++) {
+		p[i] = (trSoundSamp)((ui5b)(p[i]) * mult >> 16) + offset;
+	}
+}
+
+#endif /* MySoundEnabled */
+
 GLOBALPROC ASC_SubTick(int SubTick)
 {
 	ui4r actL;
 #if MySoundEnabled
 	tpSoundSamp p;
 #endif
-	ui4r i;
 	ui4r n = SubTick_n[SubTick];
 #if MySoundEnabled
 	ui3b SoundVolume = SoundReg_Volume;
@@ -556,11 +733,10 @@ label_retry:
 	if (actL > 0) {
 
 		if (1 == SoundReg801) {
-#if MySoundEnabled
-			ui3p addr;
-#endif
+			ui4r k = 0;
+			blnr stereo = (0 != (SoundReg802 & 2));
 
-			if (0 != (SoundReg802 & 2)) {
+			if (stereo) {
 
 			if (! ASC_Playing) {
 				if (((ui4b)(ASC_FIFO_InA - ASC_FIFO_Out)) >= 0x200) {
@@ -590,48 +766,6 @@ label_retry:
 				}
 			}
 
-			for (i = 0; i < actL; i++) {
-				if (((ui4b)(ASC_FIFO_InA - ASC_FIFO_Out)) == 0) {
-					ASC_Playing = falseblnr;
-				}
-				if (((ui4b)(ASC_FIFO_InB - ASC_FIFO_Out)) == 0) {
-					ASC_Playing = falseblnr;
-				}
-				if (! ASC_Playing) {
-#if MySoundEnabled
-					*p++ = 0x80;
-#endif
-				} else
-				{
-
-#if MySoundEnabled
-				addr = ASC_SampBuff + (ASC_FIFO_Out & 0x3FF);
-
-#if ASC_dolog && 1
-				dbglog_StartLine();
-				dbglog_writeCStr("out sound ");
-				dbglog_writeCStr("[");
-				dbglog_writeHex(ASC_FIFO_Out);
-				dbglog_writeCStr("]");
-				dbglog_writeCStr(" = ");
-				dbglog_writeHex(*addr);
-				dbglog_writeCStr(" , ");
-				dbglog_writeHex(addr[0x400]);
-				dbglog_writeReturn();
-#endif
-
-				*p++ = ((addr[0] + addr[0x400])
-#if 4 == kLn2SoundSampSz
-					<< 8
-#endif
-					) >> 1;
-#endif /* MySoundEnabled */
-
-				ASC_FIFO_Out += 1;
-
-				}
-			}
-
 			} else {
 
 			/* mono */
@@ -647,148 +781,91 @@ label_retry:
 				}
 			}
 
-			for (i = 0; i < actL; i++) {
-				if (((ui4b)(ASC_FIFO_InA - ASC_FIFO_Out)) == 0) {
+			}
+
+			/*
+				Nothing is put in the FIFO during a sub tick, so
+				playing goes on until a channel runs out, then
+				stops, with silence for the rest.
+			*/
+			if (ASC_Playing) {
+				k = (ui4b)(ASC_FIFO_InA - ASC_FIFO_Out);
+				if (stereo
+					&& (((ui4b)(ASC_FIFO_InB - ASC_FIFO_Out)) < k))
+				{
+					k = (ui4b)(ASC_FIFO_InB - ASC_FIFO_Out);
+				}
+				if (k < actL) {
 					ASC_Playing = falseblnr;
+				} else {
+					k = actL;
 				}
-				if (! ASC_Playing) {
-#if MySoundEnabled
-					*p++ = 0x80;
-#endif
-				} else
-				{
-
-#if MySoundEnabled
-				addr = ASC_SampBuff + (ASC_FIFO_Out & 0x3FF);
+			}
 
 #if ASC_dolog && 1
-				dbglog_StartLine();
-				dbglog_writeCStr("out sound ");
-				dbglog_writeCStr("[");
-				dbglog_writeHex(ASC_FIFO_Out);
-				dbglog_writeCStr("]");
-				dbglog_writeCStr(" = ");
-				dbglog_writeHex(*addr);
-				dbglog_writeCStr(", in buff: ");
-				dbglog_writeHex((ui4b)(ASC_FIFO_InA - ASC_FIFO_Out));
-				dbglog_writeReturn();
+			dbglog_StartLine();
+			dbglog_writeCStr("out sound ");
+			dbglog_writeCStr("[");
+			dbglog_writeHex(ASC_FIFO_Out);
+			dbglog_writeCStr("], count ");
+			dbglog_writeHex(k);
+			dbglog_writeReturn();
 #endif
 
-				*p++ = (addr[0])
-#if 4 == kLn2SoundSampSz
-					<< 8
+#if MySoundEnabled
+			ASC_FIFOOut(p, k, stereo);
+			ASC_Fill(p + k, actL - k, 0x80);
 #endif
-					;
-#endif /* MySoundEnabled */
 
-				/* Move the address on */
-				/* *addr = 0x80; */
-				/* addr += 2; */
-				ASC_FIFO_Out += 1;
-
-				}
-			}
+			ASC_FIFO_Out += k;
+		} else if (2 == SoundReg801) {
+			ui5b phase[4];
+			ui5b freq[4];
+			int j;
 
+			for (j = 0; j < 4; j++) {
+				freq[j] = do_get_mem_long(ASC_ChanA[j].freq);
+				phase[j] = do_get_mem_long(ASC_ChanA[j].phase);
 			}
-		} else if (2 == SoundReg801) {
-#if MySoundEnabled
-			ui4r v;
-			ui4r i0;
-			ui4r i1;
-			ui4r i2;
-			ui4r i3;
-#endif
-			ui5r freq0 = do_get_mem_long(ASC_ChanA[0].freq);
-			ui5r freq1 = do_get_mem_long(ASC_ChanA[1].freq);
-			ui5r freq2 = do_get_mem_long(ASC_ChanA[2].freq);
-			ui5r freq3 = do_get_mem_long(ASC_ChanA[3].freq);
-			ui5r phase0 = do_get_mem_long(ASC_ChanA[0].phase);
-			ui5r phase1 = do_get_mem_long(ASC_ChanA[1].phase);
-			ui5r phase2 = do_get_mem_long(ASC_ChanA[2].phase);
-			ui5r phase3 = do_get_mem_long(ASC_ChanA[3].phase);
 #if ASC_dolog && 1
 			dbglog_writeCStr("freq0=");
-			dbglog_writeNum(freq0);
+			dbglog_writeNum(freq[0]);
 			dbglog_writeCStr(", freq1=");
-			dbglog_writeNum(freq1);
+			dbglog_writeNum(freq[1]);
 			dbglog_writeCStr(", freq2=");
-			dbglog_writeNum(freq2);
+			dbglog_writeNum(freq[2]);
 			dbglog_writeCStr(", freq3=");
-			dbglog_writeNum(freq3);
+			dbglog_writeNum(freq[3]);
 			dbglog_writeReturn();
 #endif
-			for (i = 0; i < actL; i++) {
-
-				phase0 += freq0;
-				phase1 += freq1;
-				phase2 += freq2;
-				phase3 += freq3;
-
 #if MySoundEnabled
-
-#if 1
-				i0 = ((phase0 + 0x4000) >> 15) & 0x1FF;
-				i1 = ((phase1 + 0x4000) >> 15) & 0x1FF;
-				i2 = ((phase2 + 0x4000) >> 15) & 0x1FF;
-				i3 = ((phase3 + 0x4000) >> 15) & 0x1FF;
+			ASC_WaveOut(p, actL, phase, freq);
 #else
-				i0 = ((phase0 + 0x8000) >> 16) & 0x1FF;
-				i1 = ((phase1 + 0x8000) >> 16) & 0x1FF;
-				i2 = ((phase2 + 0x8000) >> 16) & 0x1FF;
-				i3 = ((phase3 + 0x8000) >> 16) & 0x1FF;
-#endif
-
-				v = ASC_SampBuff[i0]
-					+ ASC_SampBuff[0x0200 + i1]
-					+ ASC_SampBuff[0x0400 + i2]
-					+ ASC_SampBuff[0x0600 + i3];
-
-#if ASC_dolog && 1
-				dbglog_StartLine();
-				dbglog_writeCStr("i0=");
-				dbglog_writeNum(i0);
-				dbglog_writeCStr(", i1=");
-				dbglog_writeNum(i1);
-				dbglog_writeCStr(", i2=");
-				dbglog_writeNum(i2);
-				dbglog_writeCStr(", i3=");
-				dbglog_writeNum(i3);
-				dbglog_writeCStr(", output sound v=");
-				dbglog_writeNum(v);
-				dbglog_writeReturn();
+			for (j = 0; j < 4; j++) {
+				phase[j] += freq[j] * actL;
+			}
 #endif
-
-				*p++ = (v >> 2);
-#endif /* MySoundEnabled */
+			for (j = 0; j < 4; j++) {
+				do_put_mem_long(ASC_ChanA[j].phase, phase[j]);
 			}
-
-			do_put_mem_long(ASC_ChanA[0].phase, phase0);
-			do_put_mem_long(ASC_ChanA[1].phase, phase1);
-			do_put_mem_long(ASC_ChanA[2].phase, phase2);
-			do_put_mem_long(ASC_ChanA[3].phase, phase3);
 		} else {
 #if MySoundEnabled
-			for (i = 0; i < actL; i++) {
-				*p++ = kCenterSound;
-			}
+			ASC_Fill(p, actL, kCenterSound);
 #endif
 		}
 
 
 #if MySoundEnabled
+#if IncludeExtnModPlayer
+		ModPlayr_Mix(p, actL);
+#endif
+
 		if (SoundVolume < 7) {
 			/*
 				Usually have volume at 7, so this
 				is just for completeness.
 			*/
-			ui5b mult = (ui5b)vol_mult[SoundVolume];
-			trSoundSamp offset = vol_offset[SoundVolume];
-
-			p -= actL;
-			for (i = 0; i < actL; i++) {
-				*p = (trSoundSamp)((ui5b)(*p) * mult >> 16) + offset;
-				++p;
-			}
+			ASC_VolumeRun(p, actL, SoundVolume);
 		}
 
 		MySound_EndWrite(actL);
@@ -870,4 +947,174 @@ label_retry:
 #endif
 }
 
+#if UseLazySubTick
+GLOBALFUNC blnr ASC_SubTickSeen(void)
+{
+	/*
+		Whether the emulated program could tell when the next
+		sub tick is made, other than by accessing the ASC or
+		the mod player, which first bring the sub ticks up to
+		date. It can when playing from the FIFO, or about to
+		start, as then a sub tick can set a FIFO flag and
+		interrupt. Otherwise a sub tick only changes what the
+		ASC registers read (the wave table phases), and makes
+		samples for the host, so it can be made later.
+	*/
+	return (1 == SoundReg801)
+		&& (ASC_Playing
+			|| (((ui4b)(ASC_FIFO_InA - ASC_FIFO_Out)) >= 0x200));
+}
+#endif
+
+#if WantSoundAutoSlow
+GLOBALFUNC ui5r ASC_SubTicksFor(ui5r n)
+{
+	/*
+		For AutoSlow. How many sub ticks it takes the ASC
+		to make n samples, or 0 if it is only making silence
+		(FIFO mode and not playing, or wave table mode with
+		all four frequencies 0), so not worth running faster for.
+	*/
+	blnr Active = falseblnr;
+
+	if (1 == SoundReg801) {
+		Active = ASC_Playing;
+	} else if (2 == SoundReg801) {
+		int j;
+
+		for (j = 0; j < 4; ++j) {
+			if (0 != do_get_mem_long(ASC_ChanA[j].freq)) {
+				Active = trueblnr;
+			}
+		}
+	}
+
+	if (! Active) {
+		return 0;
+	}
+
+	/* 370 samples per tick, see SubTick_n */
+	return (n * kNumSubTicks + 369) / 370;
+}
+#endif
+
+#if IncludeExtnModPlayer
+#define kCmndModPlayerFeatures 1
+#define kCmndModPlayerLoad 2
+#define kCmndModPlayerPlay 3
+#define kCmndModPlayerStop 4
+#define kCmndModPlayerSetVolume 5
+#define kCmndModPlayerGetPosition 6
+#define kCmndModPlayerUnload 7
+#endif
+
+#if IncludeExtnModPlayer
+GLOBALPROC ExtnModPlayer_Access(CPTR p)
+{
+	tMacErr result = mnvm_controlErr;
+
+#if UseLazySubTick
+	SubTickTaskSync(); /* the position it has played to */
+#endif
+
+	switch (get_vm_word(p + ExtnDat_commnd)) {
+		case kCmndVersion:
+			put_vm_word(p + ExtnDat_version, 1);
+			result = mnvm_noErr;
+			break;
+		case kCmndModPlayerFeatures:
+			put_vm_long(p + ExtnDat_params + 0, 0);
+			result = mnvm_noErr;
+			break;
+		case kCmndModPlayerLoad:
+			{
+				CPTR Buffera = get_vm_long(p + ExtnDat_params + 0);
+				ui5r count = get_vm_long(p + ExtnDat_params + 4);
+				ui5r i = 0;
+				ui5b contig;
+				ui3p Buffer;
+
+				ModPlayr_Unload();
+				result = mnvm_noErr;
+				if (count > kModPlayrMaxSz) {
+					result = mnvm_paramErr;
+				}
+				while ((mnvm_noErr == result) && (i < count)) {
+					/* copied, so the guest may free it at once */
+					Buffer = get_real_address0(count - i, falseblnr,
+						Buffera + i, &contig);
+					if ((nullpr == Buffer) || (0 == contig)) {
+						result = mnvm_paramErr;
+					} else {
+						MyMoveBytes((anyp)Buffer,
+							(anyp)(ModPlayrBuff + i), contig);
+						i += contig;
+					}
+				}
+				if (mnvm_noErr == result) {
+					result = ModPlayr_Load(ModPlayrBuff, count);
+				}
+				if (mnvm_noErr == result) {
+					put_vm_word(p + ExtnDat_params + 8,
+						ModPlayrNumChans);
+					put_vm_word(p + ExtnDat_params + 10,
+						ModPlayrSongLen);
+				}
+			}
+			break;
+		case kCmndModPlayerPlay:
+			{
+				ui4r order = get_vm_word(p + ExtnDat_params + 0);
+				blnr loop = (get_vm_word(p + ExtnDat_params + 2) != 0);
+
+				if ((order < 128) && ModPlayr_Play(order, loop)) {
+					result = mnvm_noErr;
+				} else {
+					result = mnvm_paramErr;
+				}
+			}
+			break;
+		case kCmndModPlayerStop:
+			ModPlayr_Stop();
+			result = mnvm_noErr;
+			break;
+		case kCmndModPlayerSetVolume:
+			{
+				ui4r v = get_vm_word(p + ExtnDat_params + 0);
+
+				ModPlayrVolume = (v > 256) ? 256 : v;
+				result = mnvm_noErr;
+			}
+			break;
+		case kCmndModPlayerGetPosition:
+			put_vm_word(p + ExtnDat_params + 0, ModPlayrOrder);
+			put_vm_word(p + ExtnDat_params + 2, ModPlayrRow);
+			put_vm_word(p + ExtnDat_params + 4,
+				ModPlayrPlaying ? 1 : 0);
+			result = mnvm_noErr;
+			break;
+		case kCmndModPlayerUnload:
+			ModPlayr_Unload();
+			result = mnvm_noErr;
+			break;
+	}
+
+	put_vm_word(p + ExtnDat_result, result);
+}
+#endif
+
+#if IncludeExtnModPlayer
+GLOBALPROC ExtnModPlayer_ReserveAlloc(void)
+{
+	ReserveAllocOneBlock(&ModPlayrBuff, kModPlayrMaxSz, 5, falseblnr);
+}
+#endif
+
+#if IncludeExtnModPlayer
+GLOBALPROC ExtnModPlayer_Reset(void)
+{
+	ModPlayr_Unload();
+}
+#endif
+
 #endif /* EmASC */
@@ -22,3 +22,17 @@
 
 EXPORTFUNC ui5b ASC_Access(ui5b Data, blnr WriteMem, CPTR addr);
 EXPORTPROC ASC_SubTick(int SubTick);
+
+#if UseLazySubTick
+EXPORTFUNC blnr ASC_SubTickSeen(void);
+#endif
+
+#if WantSoundAutoSlow
+EXPORTFUNC ui5r ASC_SubTicksFor(ui5r n);
+#endif
+
+#if IncludeExtnModPlayer
+EXPORTPROC ExtnModPlayer_Access(CPTR p);
+EXPORTPROC ExtnModPlayer_ReserveAlloc(void);
+EXPORTPROC ExtnModPlayer_Reset(void);
+#endif
@@ -0,0 +1,67 @@
+/*
+	BNCHUTIL.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	BeNCH UTILities
+
+	What the stand alone tests and microbenchmarks (MAPRBNCH.c,
+	CHNGBNCH.c, ASCBNCH.c) share: MyMoveBytes, a repeatable
+	random number generator (NextRnd, restarted by setting Rnd
+	to 1), and a clock for timing (Now, in seconds).
+
+	Included after the types and the LOCALxxx macros, which
+	each bench gets its own way, and before whatever code under
+	test uses MyMoveBytes. That is a LOCALPROC, unless
+	BnchMoveBytesDecl says otherwise, for a bench linked with
+	emulator code that calls it.
+*/
+
+#ifdef BNCHUTIL_H
+#error "header already included"
+#else
+#define BNCHUTIL_H
+#endif
+
+#include <string.h>
+#include <time.h>
+
+#ifndef BnchMoveBytesDecl
+#define BnchMoveBytesDecl LOCALPROC
+#endif
+
+BnchMoveBytesDecl MyMoveBytes(anyp srcPtr, anyp destPtr, si5b byteCount)
+{
+	(void) memcpy((char *)destPtr, (char *)srcPtr, byteCount);
+}
+
+LOCALVAR ui5b Rnd = 1;
+
+LOCALFUNC ui5r NextRnd(void)
+{
+	/* xorshift32 */
+	Rnd ^= Rnd << 13;
+	Rnd ^= Rnd >> 17;
+	Rnd ^= Rnd << 5;
+	return Rnd;
+}
+
+LOCALFUNC double Now(void)
+{
+	struct timespec t;
+
+	(void) clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
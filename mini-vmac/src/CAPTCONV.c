@@ -0,0 +1,409 @@
+/*
+	CAPTCONV.c
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	CAPTure CONVerter
+
+	Stand alone tool that plays back a screen capture made
+	with --capture (see SCRNCAPT.h) and writes it out either
+	as a y4m video, one frame per emulated tick (so 60.15 frames
+	per second, repeating frames when nothing changed), or as
+	numbered PNG files, one per captured frame.
+
+		CaptConv --y4m out.y4m capture.cap
+		CaptConv --png dir/frame capture.cap
+
+	The second writes dir/frame000000.png and so on. No
+	libraries are needed, the PNG files are stored uncompressed
+	(as 1 bit gray, that is still only about 22K each).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned char ui3b;
+typedef unsigned long ui5b;
+
+#define kCaptVersion 1
+
+static FILE *CaptFile;
+static int CaptAtEOF = 0;
+
+static ui5b CaptWidth;
+static ui5b CaptHeight;
+static ui5b CaptByteWidth;
+static ui3b *CaptScreen;
+
+static ui3b *OutRow;
+	/* scratch, big enough for one output row */
+
+/* --- reading the capture --- */
+
+static ui5b CaptGet1(void)
+{
+	int c = getc(CaptFile);
+
+	if (EOF == c) {
+		CaptAtEOF = 1;
+		c = 0;
+	}
+
+	return c;
+}
+
+static ui5b CaptGet2(void)
+{
+	ui5b v = CaptGet1();
+
+	return v | (CaptGet1() << 8);
+}
+
+static ui5b CaptGet4(void)
+{
+	ui5b v = CaptGet2();
+
+	return v | (CaptGet2() << 16);
+}
+
+static int CaptGetFrame(void)
+{
+	/* apply the rectangles of a frame record to CaptScreen */
+	ui5b n = CaptGet1();
+	ui5b top;
+	ui5b left;
+	ui5b bottom;
+	ui5b right;
+	ui5b v;
+
+	while (0 != n--) {
+		top = CaptGet2();
+		left = CaptGet2();
+		bottom = CaptGet2();
+		right = CaptGet2();
+		if (CaptAtEOF || (top > bottom) || (bottom > CaptHeight)
+			|| (left > right) || (right > CaptWidth)
+			|| (0 != (left & 7)) || (0 != (right & 7)))
+		{
+			return 0;
+		}
+		for (v = top; v < bottom; ++v) {
+			if ((right - left) / 8 != fread(
+				CaptScreen + v * CaptByteWidth + left / 8,
+				1, (right - left) / 8, CaptFile))
+			{
+				return 0;
+			}
+		}
+	}
+
+	return ! CaptAtEOF;
+}
+
+/* --- PNG --- */
+
+static ui5b CrcTable[256];
+
+static void CrcInit(void)
+{
+	ui5b c;
+	int n;
+	int k;
+
+	for (n = 0; n < 256; ++n) {
+		c = n;
+		for (k = 0; k < 8; ++k) {
+			c = (c & 1) ? (0xEDB88320UL ^ (c >> 1)) : (c >> 1);
+		}
+		CrcTable[n] = c;
+	}
+}
+
+static ui5b CrcAdd(ui5b c, ui3b *p, ui5b n)
+{
+	while (0 != n--) {
+		c = CrcTable[(c ^ *p++) & 0xFF] ^ (c >> 8);
+	}
+
+	return c;
+}
+
+struct PngOut {
+	FILE *f;
+	ui5b crc;
+	ui5b adler_a;
+	ui5b adler_b;
+};
+typedef struct PngOut PngOut;
+
+static void PngPut(PngOut *o, ui3b *p, ui5b n)
+{
+	(void) fwrite(p, 1, n, o->f);
+	o->crc = CrcAdd(o->crc, p, n);
+}
+
+static void PngPut4(PngOut *o, ui5b v)
+{
+	ui3b b[4];
+
+	b[0] = (v >> 24) & 0xFF;
+	b[1] = (v >> 16) & 0xFF;
+	b[2] = (v >> 8) & 0xFF;
+	b[3] = v & 0xFF;
+	PngPut(o, b, 4);
+}
+
+static void PngChunkBegin(PngOut *o, ui5b n, char *kind)
+{
+	PngPut4(o, n);
+	o->crc = 0xFFFFFFFFUL;
+	PngPut(o, (ui3b *)kind, 4);
+}
+
+static void PngChunkEnd(PngOut *o)
+{
+	PngPut4(o, o->crc ^ 0xFFFFFFFFUL);
+}
+
+static void PngPutData(PngOut *o, ui3b *p, ui5b n)
+{
+	/* raw image data, also summed for the zlib trailer */
+	ui5b i;
+
+	for (i = 0; i < n; ++i) {
+		o->adler_a = (o->adler_a + p[i]) % 65521;
+		o->adler_b = (o->adler_b + o->adler_a) % 65521;
+	}
+	PngPut(o, p, n);
+}
+
+static int WritePng(char *path)
+{
+	/*
+		1 bit gray, one stored deflate block per row,
+		white is 1 in PNG but 0 on the Mac, so invert.
+	*/
+	PngOut o;
+	ui5b RowSz = CaptByteWidth + 1;
+	ui5b v;
+	ui5b i;
+	ui3b *s;
+	ui3b b[5];
+	static ui3b Sig[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+
+	o.f = fopen(path, "wb");
+	if (NULL == o.f) {
+		fprintf(stderr, "Couldn't create %s\n", path);
+		return 0;
+	}
+	(void) fwrite(Sig, 1, 8, o.f);
+
+	PngChunkBegin(&o, 13, "IHDR");
+	PngPut4(&o, CaptWidth);
+	PngPut4(&o, CaptHeight);
+	b[0] = 1; /* bit depth */
+	b[1] = 0; /* gray */
+	b[2] = 0; /* deflate */
+	b[3] = 0; /* adaptive filtering */
+	b[4] = 0; /* not interlaced */
+	PngPut(&o, b, 5);
+	PngChunkEnd(&o);
+
+	PngChunkBegin(&o, 2 + CaptHeight * (5 + RowSz) + 4, "IDAT");
+	b[0] = 0x78;
+	b[1] = 0x01;
+	PngPut(&o, b, 2);
+	o.adler_a = 1;
+	o.adler_b = 0;
+	for (v = 0; v < CaptHeight; ++v) {
+		b[0] = (v + 1 == CaptHeight) ? 1 : 0; /* last block */
+		b[1] = RowSz & 0xFF;
+		b[2] = (RowSz >> 8) & 0xFF;
+		b[3] = ~ b[1];
+		b[4] = ~ b[2];
+		PngPut(&o, b, 5);
+
+		s = CaptScreen + v * CaptByteWidth;
+		OutRow[0] = 0; /* no filter */
+		for (i = 0; i < CaptByteWidth; ++i) {
+			OutRow[1 + i] = ~ s[i];
+		}
+		PngPutData(&o, OutRow, RowSz);
+	}
+	PngPut4(&o, (o.adler_b << 16) | o.adler_a);
+	PngChunkEnd(&o);
+
+	PngChunkBegin(&o, 0, "IEND");
+	PngChunkEnd(&o);
+
+	if (0 != fclose(o.f)) {
+		fprintf(stderr, "Couldn't write %s\n", path);
+		return 0;
+	}
+
+	return 1;
+}
+
+/* --- y4m --- */
+
+static int WriteY4mFrame(FILE *f)
+{
+	/* black 16, white 235, no color */
+	ui5b v;
+	ui5b h;
+	ui3b *s;
+	ui5b n = ((CaptWidth + 1) / 2) * ((CaptHeight + 1) / 2);
+
+	(void) fputs("FRAME\n", f);
+	for (v = 0; v < CaptHeight; ++v) {
+		s = CaptScreen + v * CaptByteWidth;
+		for (h = 0; h < CaptWidth; ++h) {
+			OutRow[h] = (0 != (s[h >> 3] & (0x80 >> (h & 7))))
+				? 16 : 235;
+		}
+		(void) fwrite(OutRow, 1, CaptWidth, f);
+	}
+	memset(OutRow, 128, CaptWidth);
+	for (v = 0; v < 2 * n; v += h) {
+		h = 2 * n - v;
+		if (h > CaptWidth) {
+			h = CaptWidth;
+		}
+		(void) fwrite(OutRow, 1, h, f);
+	}
+
+	return ! ferror(f);
+}
+
+/* --- main --- */
+
+int main(int argc, char **argv)
+{
+	char magic[8];
+	char *mode;
+	char *out;
+	FILE *y4m = NULL;
+	char *path = NULL;
+	ui5b frames = 0;
+	ui5b tick = 0;
+	ui5b t;
+	int tag;
+	int started = 0;
+	int IsOk = 0;
+
+	if ((4 != argc) || ((0 != strcmp(argv[1], "--y4m"))
+		&& (0 != strcmp(argv[1], "--png"))))
+	{
+		fprintf(stderr,
+			"usage: %s --y4m out.y4m | --png prefix capture\n",
+			argv[0]);
+		return 2;
+	}
+	mode = argv[1];
+	out = argv[2];
+
+	CaptFile = fopen(argv[3], "rb");
+	if (NULL == CaptFile) {
+		fprintf(stderr, "Couldn't open %s\n", argv[3]);
+		return 1;
+	}
+
+	if ((8 != fread(magic, 1, 8, CaptFile))
+		|| (0 != memcmp(magic, "MnvMCapt", 8))
+		|| (kCaptVersion != CaptGet4()))
+	{
+		fprintf(stderr, "%s is not a usable capture\n", argv[3]);
+		return 1;
+	}
+	CaptWidth = CaptGet2();
+	CaptHeight = CaptGet2();
+	CaptByteWidth = (CaptWidth + 7) / 8;
+	CaptScreen = (ui3b *)calloc(1, CaptByteWidth * CaptHeight);
+	OutRow = (ui3b *)malloc(CaptWidth + 1);
+	path = (char *)malloc(strlen(out) + 16);
+	if ((NULL == CaptScreen) || (NULL == OutRow) || (NULL == path)) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	if (0 == strcmp(mode, "--y4m")) {
+		y4m = fopen(out, "wb");
+		if (NULL == y4m) {
+			fprintf(stderr, "Couldn't create %s\n", out);
+			return 1;
+		}
+		fprintf(y4m, "YUV4MPEG2 W%lu H%lu F60147420:1000000 Ip A1:1"
+			" C420jpeg\n", CaptWidth, CaptHeight);
+	}
+	CrcInit();
+
+	for (; ; ) {
+		tag = CaptGet1();
+		if (CaptAtEOF) {
+			fprintf(stderr, "capture ends early\n");
+			break;
+		}
+		if (('F' != tag) && ('E' != tag)) {
+			fprintf(stderr, "bad record in capture\n");
+			break;
+		}
+		t = CaptGet4();
+
+		if (NULL != y4m) {
+			/*
+				the screen so far was shown from tick
+				until t, one video frame per tick.
+			*/
+			if (! started) {
+				tick = t;
+				started = 1;
+			}
+			for (; tick < t; ++tick) {
+				if (! WriteY4mFrame(y4m)) {
+					goto label_fail;
+				}
+			}
+		}
+
+		if ('E' == tag) {
+			IsOk = 1;
+			break;
+		}
+
+		if (! CaptGetFrame()) {
+			fprintf(stderr, "bad frame in capture\n");
+			break;
+		}
+
+		if (NULL == y4m) {
+			sprintf(path, "%s%06lu.png", out, frames);
+			if (! WritePng(path)) {
+				goto label_fail;
+			}
+		}
+		++frames;
+	}
+
+label_fail:
+	if (NULL != y4m) {
+		if (0 != fclose(y4m)) {
+			IsOk = 0;
+		}
+	}
+	fprintf(stderr, "%lu frames\n", frames);
+
+	return IsOk ? 0 : 1;
+}
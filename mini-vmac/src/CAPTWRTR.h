@@ -0,0 +1,190 @@
+/*
+	CAPTWRTR.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	CAPTure WRiTeR
+
+	What the screen and sound captures (SCRNCAPT.h, SNDCAPT.h)
+	share. Each has a CaptWrtrR, a ring buffer between the
+	emulation and a thread of its own that writes the file, so
+	the emulation never waits on the disk unless the buffer
+	fills up. CaptWrtr_Put hands bytes to it, CaptPut2 and
+	CaptPut4 put together the little endian numbers the files
+	are made of.
+
+	CaptWrtr_Start is called once anything the file starts with
+	has been written, and CaptWrtr_Stop waits until everything
+	put has been written, after which the file is the caller's
+	again.
+
+	The OSGLUxxx file includes this before SCRNCAPT.h and
+	SNDCAPT.h.
+*/
+
+#ifdef CAPTWRTR_H
+#error "header already included"
+#else
+#define CAPTWRTR_H
+#endif
+
+#include <pthread.h>
+
+struct CaptWrtrR {
+	FILE *File;
+	ui3p Buff;
+	ui5r BuffSz;
+	ui5r In;
+	ui5r Out;
+		/* In - Out bytes are waiting */
+	blnr Started;
+	blnr Done;
+	blnr Failed; /* a write failed */
+	pthread_t Thread;
+	pthread_mutex_t Mutex;
+	pthread_cond_t Cond;
+
+	ui5r StatWaits; /* times Put had to wait for room */
+	unsigned long long StatBytes;
+};
+typedef struct CaptWrtrR CaptWrtrR;
+
+LOCALFUNC void *CaptWrtr_Thread(void *arg)
+{
+	CaptWrtrR *w = (CaptWrtrR *)arg;
+	ui5r n;
+	ui5r i;
+
+	pthread_mutex_lock(&w->Mutex);
+	for (; ; ) {
+		n = w->In - w->Out;
+		if (0 == n) {
+			if (w->Done) {
+				break;
+			}
+			pthread_cond_wait(&w->Cond, &w->Mutex);
+		} else {
+			i = w->Out % w->BuffSz;
+			if (n > w->BuffSz - i) {
+				n = w->BuffSz - i;
+			}
+			pthread_mutex_unlock(&w->Mutex);
+
+			if (n != fwrite(w->Buff + i, 1, n, w->File)) {
+				w->Failed = trueblnr;
+			}
+
+			pthread_mutex_lock(&w->Mutex);
+			w->Out += n;
+			pthread_cond_signal(&w->Cond);
+		}
+	}
+	pthread_mutex_unlock(&w->Mutex);
+
+	return NULL;
+}
+
+LOCALFUNC blnr CaptWrtr_Start(CaptWrtrR *w, FILE *f, ui5r BuffSz)
+{
+	w->File = f;
+	w->BuffSz = BuffSz;
+	w->In = 0;
+	w->Out = 0;
+	w->Done = falseblnr;
+	w->Failed = falseblnr;
+	w->StatWaits = 0;
+	w->StatBytes = 0;
+
+	w->Buff = (ui3p)malloc(BuffSz);
+	if (NULL == w->Buff) {
+		fprintf(stderr, "out of memory\n");
+		return falseblnr;
+	}
+
+	(void) pthread_mutex_init(&w->Mutex, NULL);
+	(void) pthread_cond_init(&w->Cond, NULL);
+	if (0 != pthread_create(&w->Thread, NULL, CaptWrtr_Thread, w)) {
+		fprintf(stderr, "Couldn't start capture thread\n");
+		return falseblnr;
+	}
+	w->Started = trueblnr;
+
+	return trueblnr;
+}
+
+LOCALPROC CaptWrtr_Put(CaptWrtrR *w, ui3p p, ui5r n)
+{
+	/* hand n bytes to the writer, waiting for room if need be */
+	ui5r i;
+	ui5r m;
+
+	w->StatBytes += n;
+
+	pthread_mutex_lock(&w->Mutex);
+	while (0 != n) {
+		m = w->BuffSz - (w->In - w->Out);
+		if (0 == m) {
+			++w->StatWaits;
+			pthread_cond_wait(&w->Cond, &w->Mutex);
+		} else {
+			i = w->In % w->BuffSz;
+			if (m > w->BuffSz - i) {
+				m = w->BuffSz - i;
+			}
+			if (m > n) {
+				m = n;
+			}
+			MyMoveBytes((anyp)p, (anyp)(w->Buff + i), m);
+			p += m;
+			n -= m;
+			w->In += m;
+			pthread_cond_signal(&w->Cond);
+		}
+	}
+	pthread_mutex_unlock(&w->Mutex);
+}
+
+LOCALPROC CaptWrtr_Stop(CaptWrtrR *w)
+{
+	/* also frees what Start allocated, if it got that far */
+	if (w->Started) {
+		pthread_mutex_lock(&w->Mutex);
+		w->Done = trueblnr;
+		pthread_cond_signal(&w->Cond);
+		pthread_mutex_unlock(&w->Mutex);
+		(void) pthread_join(w->Thread, NULL);
+		(void) pthread_cond_destroy(&w->Cond);
+		(void) pthread_mutex_destroy(&w->Mutex);
+		w->Started = falseblnr;
+	}
+
+	MyMayFree((char *)w->Buff);
+	w->Buff = nullpr;
+}
+
+LOCALFUNC ui3p CaptPut2(ui3p p, ui4r v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+
+	return p + 2;
+}
+
+LOCALFUNC ui3p CaptPut4(ui3p p, ui5r v)
+{
+	p = CaptPut2(p, v & 0xFFFF);
+
+	return CaptPut2(p, (v >> 16) & 0xFFFF);
+}
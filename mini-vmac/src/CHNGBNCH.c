@@ -0,0 +1,375 @@
+/*
+	CHNGBNCH.c
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	screen CHaNGes BeNCHmark
+
+	Stand alone test and microbenchmark for SCRNCHNG.h. Checks
+	ScreenFindMonoRects, with each row mask kernel the cpu has,
+	against the older ScreenFindChanges over many random frame
+	pairs: random screen contents, changed in a few random
+	places (single pixels, short runs, boxes, whole rows, or
+	not at all). For each pair:
+
+		every changed pixel, so every run of changed pixels in
+		a row, must be inside one of the rectangles returned,
+
+		the box around all the rectangles must be the box the
+		old code finds,
+
+		and the compare buffer must end up equal to the frame.
+
+	Half the pairs are found as when lagging, a quarter of the
+	rows at a time, where each call must also stop at the same
+	row as the old code.
+
+	Then it times finding that an unchanged 512x342 frame has not
+	changed, with the old code and with each kernel:
+
+		ChngBench [frames]
+
+	Exits with status 1 if any check fails.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef unsigned char ui3b;
+typedef unsigned short ui4b;
+typedef unsigned int ui5b;
+typedef signed char si3b;
+typedef short si4b;
+typedef unsigned int ui3r;
+typedef unsigned int ui4r;
+typedef unsigned int ui5r;
+typedef int si5b;
+typedef ui5r uimr;
+typedef ui3b *ui3p;
+typedef unsigned char blnr;
+#define trueblnr 1
+#define falseblnr 0
+#define anyp ui3p
+#define nullpr ((void *) 0)
+#define LOCALVAR static
+#define LOCALFUNC static
+#define LOCALPROC static void
+
+#define LittleEndianUnaligned 0
+#define BigEndianUnaligned 0
+
+/*
+	a screen that could show color, shown in black and white, so
+	that both ScreenFindChanges and ScreenFindMonoRects are
+	there and both look at the same 1 bit frame.
+*/
+#define vMacScreenWidth 512
+#define vMacScreenHeight 342
+#define vMacScreenDepth 3
+#define vMacScreenBitWidth ((long)vMacScreenWidth << vMacScreenDepth)
+#define vMacScreenByteWidth (vMacScreenBitWidth / 8)
+#define vMacScreenMonoByteWidth ((long)vMacScreenWidth / 8)
+#define vMacScreenMonoNumBytes (vMacScreenMonoByteWidth * vMacScreenHeight)
+
+LOCALVAR blnr UseColorMode = falseblnr;
+LOCALVAR blnr ColorMappingChanged = falseblnr;
+
+#include "BNCHUTIL.h"
+#include "SCRNCHNG.h"
+
+#define kRandomFrames 5000
+#define kTimeRounds 5 /* timings are the fastest round */
+
+LOCALVAR ui3b Frame[vMacScreenMonoNumBytes];
+LOCALVAR ui3b Prev[vMacScreenMonoNumBytes];
+LOCALVAR ui3b CmpOld[vMacScreenMonoNumBytes];
+LOCALVAR ui3b CmpNew[vMacScreenMonoNumBytes];
+LOCALVAR ui5r Failures = 0;
+
+LOCALFUNC blnr Pixel(ui3p p, int i, int j)
+{
+	return 0 != (p[i * vMacScreenMonoByteWidth + (j >> 3)]
+		& (0x80 >> (j & 7)));
+}
+
+LOCALPROC FlipPixel(ui3p p, int i, int j)
+{
+	p[i * vMacScreenMonoByteWidth + (j >> 3)] ^= (0x80 >> (j & 7));
+}
+
+LOCALPROC FlipBox(int top, int left, int bottom, int right)
+{
+	int i;
+	int j;
+
+	for (i = top; i < bottom; ++i) {
+		for (j = left; j < right; ++j) {
+			if (0 != (NextRnd() & 1)) {
+				FlipPixel(Frame, i, j);
+			}
+		}
+	}
+}
+
+LOCALPROC MakeFramePair(void)
+{
+	/* random Prev, then Frame is Prev changed in a few places */
+	int i;
+	int n;
+	int t;
+	int l;
+
+	for (i = 0; i < vMacScreenMonoNumBytes; ++i) {
+		Prev[i] = NextRnd();
+	}
+	MyMoveBytes(Prev, Frame, vMacScreenMonoNumBytes);
+
+	n = NextRnd() % 12; /* sometimes more than kMaxScrnRects */
+	for (i = 0; i < n; ++i) {
+		t = NextRnd() % vMacScreenHeight;
+		l = NextRnd() % vMacScreenWidth;
+		switch (NextRnd() % 4) {
+			case 0:
+				FlipPixel(Frame, t, l);
+				break;
+			case 1:
+				FlipBox(t, l, t + 1,
+					l + 1 + NextRnd() % (vMacScreenWidth - l));
+				break;
+			case 2:
+				FlipBox(t, l,
+					t + 1 + NextRnd() % 40 % (vMacScreenHeight - t),
+					l + 1 + NextRnd() % 80 % (vMacScreenWidth - l));
+				break;
+			default:
+				FlipBox(t, 0, t + 1 + NextRnd() % 3
+					% (vMacScreenHeight - t), vMacScreenWidth);
+				break;
+		}
+	}
+}
+
+LOCALPROC Fail(long f, char *what)
+{
+	if (Failures < 10) {
+		fprintf(stderr, "frame %ld: %s\n", f, what);
+	}
+	++Failures;
+}
+
+LOCALPROC CheckCovered(long f, ScrnRect *r, int n,
+	int top, int bottom)
+{
+	/*
+		each pixel changed from Prev to Frame in rows top to
+		bottom is inside one of the n rectangles.
+	*/
+	int i;
+	int j;
+	int k;
+
+	for (i = top; i < bottom; ++i) {
+		for (j = 0; j < vMacScreenWidth; ++j) {
+			if (Pixel(Prev, i, j) != Pixel(Frame, i, j)) {
+				for (k = 0; k < n; ++k) {
+					if ((i >= r[k].top) && (i < r[k].bottom)
+						&& (j >= r[k].left) && (j < r[k].right))
+					{
+						break;
+					}
+				}
+				if (k == n) {
+					Fail(f, "changed pixel not in a rectangle");
+					return;
+				}
+			}
+		}
+	}
+}
+
+LOCALPROC CheckFramePair(long f, si3b TimeAdjust)
+{
+	/*
+		find the changes with both, as many calls as it takes
+		to get through the frame when lagging.
+	*/
+	ScrnRect r[kMaxScrnRects];
+	ScrnRect b;
+	si4b top;
+	si4b left;
+	si4b bottom;
+	si4b right;
+	blnr HaveOld;
+	uimr NextOld = 0;
+	uimr NextNew = 0;
+	uimr StartRow;
+	int n;
+	int k;
+
+	MyMoveBytes(Prev, CmpOld, vMacScreenMonoNumBytes);
+	MyMoveBytes(Prev, CmpNew, vMacScreenMonoNumBytes);
+
+	do {
+		screencomparebuff = CmpOld;
+		NextDrawRow = NextOld;
+		HaveOld = ScreenFindChanges(Frame, TimeAdjust,
+			&top, &left, &bottom, &right);
+		NextOld = NextDrawRow;
+
+		screencomparebuff = CmpNew;
+		StartRow = NextDrawRow = NextNew;
+		n = ScreenFindChangedRects(Frame, TimeAdjust, r);
+		NextNew = NextDrawRow;
+
+		if (HaveOld != (0 != n)) {
+			Fail(f, "found changes where the old code did not,"
+				" or the other way round");
+			return;
+		}
+		if (NextOld != NextNew) {
+			Fail(f, "stopped at a different row");
+			return;
+		}
+		if (0 == n) {
+			break;
+		}
+
+		b = r[0];
+		for (k = 0; k < n; ++k) {
+			if ((r[k].top >= r[k].bottom) || (r[k].left >= r[k].right)
+				|| (r[k].top < 0) || (r[k].left < 0)
+				|| (r[k].bottom > vMacScreenHeight)
+				|| (r[k].right > vMacScreenWidth))
+			{
+				Fail(f, "bad rectangle");
+				return;
+			}
+			if (r[k].top < b.top) {
+				b.top = r[k].top;
+			}
+			if (r[k].left < b.left) {
+				b.left = r[k].left;
+			}
+			if (r[k].bottom > b.bottom) {
+				b.bottom = r[k].bottom;
+			}
+			if (r[k].right > b.right) {
+				b.right = r[k].right;
+			}
+		}
+		if ((b.top != top) || (b.left != left)
+			|| (b.bottom != bottom) || (b.right != right))
+		{
+			Fail(f, "box around the rectangles differs");
+			return;
+		}
+
+		/* rows after the first change up to where it stopped */
+		CheckCovered(f, r, n, StartRow,
+			(0 == NextNew) ? vMacScreenHeight : NextNew);
+	} while (0 != NextNew);
+
+	if (0 != memcmp(CmpNew, Frame, vMacScreenMonoNumBytes)) {
+		Fail(f, "compare buffer differs from the frame");
+	}
+	if (0 != memcmp(CmpOld, CmpNew, vMacScreenMonoNumBytes)) {
+		Fail(f, "compare buffer differs from the old code's");
+	}
+}
+
+LOCALPROC Check(char *name, long frames)
+{
+	long f;
+	ui5r Failures0 = Failures;
+
+	Rnd = 1;
+	for (f = 0; f < frames; ++f) {
+		MakeFramePair();
+		CheckFramePair(f, (0 != (f & 1)) ? 6 : 0);
+	}
+
+	printf("%-6s %ld frames: %s\n", name, frames,
+		(Failures0 == Failures) ? "same" : "DIFFERED");
+}
+
+/* --- timing --- */
+
+LOCALPROC Time(char *name, blnr old, long n)
+{
+	ScrnRect r[kMaxScrnRects];
+	si4b top;
+	si4b left;
+	si4b bottom;
+	si4b right;
+	long i;
+	int k;
+	double t;
+	double best = 0;
+
+	screencomparebuff = CmpNew;
+	MyMoveBytes(Frame, CmpNew, vMacScreenMonoNumBytes);
+	NextDrawRow = 0;
+
+	for (k = 0; k < kTimeRounds; ++k) {
+		t = Now();
+		for (i = 0; i < n; ++i) {
+			if (old) {
+				(void) ScreenFindChanges(Frame, 0,
+					&top, &left, &bottom, &right);
+			} else {
+				(void) ScreenFindChangedRects(Frame, 0, r);
+			}
+		}
+		t = Now() - t;
+		if ((0 == k) || (t < best)) {
+			best = t;
+		}
+	}
+
+	printf("%-6s %6.2f us per unchanged frame\n", name, best * 1e6 / n);
+}
+
+LOCALPROC Kernel(char *name, ScrnRowMasksP p, long frames)
+{
+	ScrnRowMasks_Do = p;
+	Check(name, frames);
+	Time(name, falseblnr, frames);
+}
+
+int main(int argc, char **argv)
+{
+	long n = (argc > 1) ? atol(argv[1]) : kRandomFrames;
+
+	if (n <= 0) {
+		fprintf(stderr, "usage: %s [frames]\n", argv[0]);
+		return 2;
+	}
+
+	Time("old", trueblnr, n);
+	Kernel("C", ScrnRowMasks_C, n);
+#if ScrnRowMasks_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		Kernel("SSE2", ScrnRowMasks_SSE2, n);
+	}
+#if 0 == (ScrnRowChunks & 7)
+	if (__builtin_cpu_supports("avx2")) {
+		Kernel("AVX2", ScrnRowMasks_AVX2, n);
+	}
+#endif
+#endif
+
+	return (0 == Failures) ? 0 : 1;
+}
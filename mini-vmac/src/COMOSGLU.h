@@ -89,6 +89,10 @@ GLOBALVAR blnr WantMacReset = falseblnr;
 
 GLOBALVAR ui3b SpeedValue = WantInitSpeedValue;
 
+#if WantInstructionCount
+GLOBALVAR ui5r InstructionCount = 0;
+#endif
+
 #if EnableAutoSlow
 GLOBALVAR blnr WantNotAutoSlow = (WantInitNotAutoSlow != 0);
 #endif
@@ -134,6 +138,32 @@ GLOBALVAR ui5r LT_RxBuffSz = 0;
 #define GrabKeysMaxFullScreen 0
 #endif
 
+#ifndef EnableEvtReplay
+#define EnableEvtReplay 0
+#endif
+
+#ifndef EnableScrnCapt
+#define EnableScrnCapt 0
+#endif
+
+#define UseScrnCapt (EnableScrnCapt && (0 == vMacScreenDepth))
+
+#ifndef EnableScrnVrfy
+#define EnableScrnVrfy 0
+#endif
+
+#define UseScrnVrfy (EnableScrnVrfy && (0 == vMacScreenDepth))
+
+#ifndef WantScreenHash
+#define WantScreenHash (EnableEvtReplay || UseScrnVrfy)
+#endif
+
+#ifndef EnableSndCapt
+#define EnableSndCapt 0
+#endif
+
+#define UseSndCapt (EnableSndCapt && MySoundEnabled && WantSoundSubTick)
+
 #if IncludePbufs
 LOCALVAR ui5b PbufAllocatedMask;
 LOCALVAR ui5b PbufSize[NumPbufs];
@@ -254,387 +284,143 @@ LOCALPROC DiskEjectedNotify(tDrive Drive_No)
 	vSonyInsertedMask &= ~ ((ui5b)1 << Drive_No);
 }
 
-/*
-	block type - for operating on multiple ui3b elements
-		at a time.
-*/
+#include "SCRNCHNG.h"
 
-#if LittleEndianUnaligned || BigEndianUnaligned
-
-#define uibb ui5b
-#define uibr ui5r
-#define ln2uiblockn 2
+GLOBALVAR blnr EmVideoDisable = falseblnr;
+GLOBALVAR si3b EmLagTime = 0;
 
-#if 0
-#define uibb long long
-#define uibr long long
-#define ln2uiblockn 3
+#if WantLagStats
+GLOBALVAR ui5r LagStatHist[kLagStatHistSz];
+GLOBALVAR ui5r LagStatCatchUp = 0;
+GLOBALVAR ui5r LagStatDropped = 0;
 #endif
 
-#else
-
-#define uibb ui3b
-#define uibr ui3r
-#define ln2uiblockn 0
+#if WantSliceStats
+GLOBALVAR ui5r SliceStatCount = 0;
+GLOBALVAR ui5r SliceStatCycles = 0;
+#endif
 
+#if WantSoundSubTick
+GLOBALVAR ui3b SoundSubTick = 0;
 #endif
 
-#define uiblockn (1 << ln2uiblockn)
-#define ln2uiblockbitsn (3 + ln2uiblockn)
-#define uiblockbitsn (8 * uiblockn)
+GLOBALVAR ui5b OnTrueTime = 0;
+	/*
+		The time slice we are currently dealing
+		with, in the same units as TrueEmulatedTime.
+	*/
+
+LOCALVAR si4b ScreenChangedTop;
+LOCALVAR si4b ScreenChangedLeft;
+LOCALVAR si4b ScreenChangedBottom;
+LOCALVAR si4b ScreenChangedRight;
 
-LOCALFUNC blnr FindFirstChangeInLVecs(uibb *ptr1, uibb *ptr2,
-					uimr L, uimr *j)
-{
 /*
-	find index of first difference
+	Besides the bounding box above, the changes are kept as a
+	short list of disjoint rectangles, for glue that would rather
+	draw a few small areas than one big one. Rectangles that
+	overlap, or that cost little more to draw as one, are merged.
 */
-	uibb *p1 = ptr1;
-	uibb *p2 = ptr2;
-	uimr i;
 
-	for (i = L; i != 0; --i) {
-		if (*p1++ != *p2++) {
-			--p1;
-			*j = p1 - ptr1;
-			return trueblnr;
-		}
-	}
-	return falseblnr;
-}
+LOCALVAR ScrnRect ScreenDamage[kMaxScrnRects];
+LOCALVAR int ScreenDamageN = 0;
 
-LOCALPROC FindLastChangeInLVecs(uibb *ptr1, uibb *ptr2,
-					uimr L, uimr *j)
-{
-/*
-	find index of last difference, assuming there is one
-*/
-	uibb *p1 = ptr1 + L;
-	uibb *p2 = ptr2 + L;
+LOCALVAR ui5r ScreenChangedFrames = 0;
+	/* frames that changed something, for counting new ones */
 
-	while (*--p1 == *--p2) {
-	}
-	*j = p1 - ptr1;
-}
+#ifndef kScrnRectCost
+#define kScrnRectCost 1024
+#endif
+	/*
+		overhead of drawing one more rectangle,
+		counted in pixels.
+	*/
 
-LOCALPROC FindLeftRightChangeInLMat(uibb *ptr1, uibb *ptr2,
-	uimr width, uimr top, uimr bottom,
-	uimr *LeftMin0, uibr *LeftMask0,
-	uimr *RightMax0, uibr *RightMask0)
+LOCALFUNC ui5r ScrnRectArea(ScrnRect *r)
 {
-	uimr i;
-	uimr j;
-	uibb *p1;
-	uibb *p2;
-	uibr x;
-	ui5r offset = top * width;
-	uibb *p10 = (uibb *)ptr1 + offset;
-	uibb *p20 = (uibb *)ptr2 + offset;
-	uimr LeftMin = *LeftMin0;
-	uimr RightMax = *RightMax0;
-	uibr LeftMask = 0;
-	uibr RightMask = 0;
-	for (i = top; i < bottom; ++i) {
-		p1 = p10;
-		p2 = p20;
-		for (j = 0; j < LeftMin; ++j) {
-			x = *p1++ ^ *p2++;
-			if (0 != x) {
-				LeftMin = j;
-				LeftMask = x;
-				goto Label_3;
-			}
-		}
-		LeftMask |= (*p1 ^ *p2);
-Label_3:
-		p1 = p10 + RightMax;
-		p2 = p20 + RightMax;
-		RightMask |= (*p1++ ^ *p2++);
-		for (j = RightMax + 1; j < width; ++j) {
-			x = *p1++ ^ *p2++;
-			if (0 != x) {
-				RightMax = j;
-				RightMask = x;
-			}
-		}
+	return (ui5r)(r->bottom - r->top) * (ui5r)(r->right - r->left);
+}
 
-		p10 += width;
-		p20 += width;
+LOCALPROC ScrnRectUnion(ScrnRect *r, ScrnRect *a)
+{
+	if (a->top < r->top) {
+		r->top = a->top;
+	}
+	if (a->bottom > r->bottom) {
+		r->bottom = a->bottom;
+	}
+	if (a->left < r->left) {
+		r->left = a->left;
+	}
+	if (a->right > r->right) {
+		r->right = a->right;
 	}
-	*LeftMin0 = LeftMin;
-	*RightMax0 = RightMax;
-	*LeftMask0 = LeftMask;
-	*RightMask0 = RightMask;
 }
 
-LOCALVAR ui3p screencomparebuff = nullpr;
-
-LOCALVAR uimr NextDrawRow = 0;
-
-
-#if BigEndianUnaligned
-
-#define FlipCheckMonoBits (uiblockbitsn - 1)
-
-#else
-
-#define FlipCheckMonoBits 7
-
-#endif
-
-#define FlipCheckBits (FlipCheckMonoBits >> vMacScreenDepth)
-
-#ifndef WantColorTransValid
-#define WantColorTransValid 0
-#endif
-
-#if WantColorTransValid
-LOCALVAR blnr ColorTransValid = falseblnr;
-#endif
-
-LOCALFUNC blnr ScreenFindChanges(ui3p screencurrentbuff,
-	si3b TimeAdjust, si4b *top, si4b *left, si4b *bottom, si4b *right)
+LOCALFUNC ui5r ScrnRectMergeCost(ScrnRect *a, ScrnRect *b)
 {
-	uimr j0;
-	uimr j1;
-	uimr j0h;
-	uimr j1h;
-	uimr j0v;
-	uimr j1v;
-	uimr copysize;
-	uimr copyoffset;
-	uimr copyrows;
-	uimr LimitDrawRow;
-	uimr MaxRowsDrawnPerTick;
-	uimr LeftMin;
-	uimr RightMax;
-	uibr LeftMask;
-	uibr RightMask;
-	int j;
+	/*
+		extra pixels drawn if a and b are drawn as one,
+		0 if they overlap, since they must be merged then.
+	*/
+	ScrnRect u = *a;
+	ui5r ua;
+	ui5r ab;
 
-	if (TimeAdjust < 4) {
-		MaxRowsDrawnPerTick = vMacScreenHeight;
-	} else if (TimeAdjust < 6) {
-		MaxRowsDrawnPerTick = vMacScreenHeight / 2;
-	} else {
-		MaxRowsDrawnPerTick = vMacScreenHeight / 4;
+	if ((a->left < b->right) && (b->left < a->right)
+		&& (a->top < b->bottom) && (b->top < a->bottom))
+	{
+		return 0;
 	}
 
-#if 0 != vMacScreenDepth
-	if (UseColorMode) {
-		if (ColorMappingChanged) {
-			ColorMappingChanged = falseblnr;
-			j0h = 0;
-			j1h = vMacScreenWidth;
-			j0v = 0;
-			j1v = vMacScreenHeight;
-#if WantColorTransValid
-			ColorTransValid = falseblnr;
-#endif
-		} else {
-			if (! FindFirstChangeInLVecs(
-				(uibb *)screencurrentbuff
-					+ NextDrawRow * (vMacScreenBitWidth / uiblockbitsn),
-				(uibb *)screencomparebuff
-					+ NextDrawRow * (vMacScreenBitWidth / uiblockbitsn),
-				((uimr)(vMacScreenHeight - NextDrawRow)
-					* (uimr)vMacScreenBitWidth) / uiblockbitsn,
-				&j0))
-			{
-				NextDrawRow = 0;
-				return falseblnr;
-			}
-			j0v = j0 / (vMacScreenBitWidth / uiblockbitsn);
-			j0h = j0 - j0v * (vMacScreenBitWidth / uiblockbitsn);
-			j0v += NextDrawRow;
-			LimitDrawRow = j0v + MaxRowsDrawnPerTick;
-			if (LimitDrawRow >= vMacScreenHeight) {
-				LimitDrawRow = vMacScreenHeight;
-				NextDrawRow = 0;
-			} else {
-				NextDrawRow = LimitDrawRow;
-			}
-			FindLastChangeInLVecs((uibb *)screencurrentbuff,
-				(uibb *)screencomparebuff,
-				((uimr)LimitDrawRow
-					* (uimr)vMacScreenBitWidth) / uiblockbitsn,
-				&j1);
-			j1v = j1 / (vMacScreenBitWidth / uiblockbitsn);
-			j1h = j1 - j1v * (vMacScreenBitWidth / uiblockbitsn);
-			j1v++;
-
-			if (j0h < j1h) {
-				LeftMin = j0h;
-				RightMax = j1h;
-			} else {
-				LeftMin = j1h;
-				RightMax = j0h;
-			}
+	ScrnRectUnion(&u, b);
+	ua = ScrnRectArea(&u);
+	ab = ScrnRectArea(a) + ScrnRectArea(b);
 
-			FindLeftRightChangeInLMat((uibb *)screencurrentbuff,
-				(uibb *)screencomparebuff,
-				(vMacScreenBitWidth / uiblockbitsn),
-				j0v, j1v, &LeftMin, &LeftMask, &RightMax, &RightMask);
+	return (ua > ab) ? (ua - ab) : 0;
+}
 
-#if vMacScreenDepth > ln2uiblockbitsn
-			j0h =  (LeftMin >> (vMacScreenDepth - ln2uiblockbitsn));
-#elif ln2uiblockbitsn > vMacScreenDepth
-			for (j = 0; j < (1 << (ln2uiblockbitsn - vMacScreenDepth));
-				++j)
-			{
-				if (0 != (LeftMask
-					& (((((uibr)1) << (1 << vMacScreenDepth)) - 1)
-						<< ((j ^ FlipCheckBits) << vMacScreenDepth))))
-				{
-					goto Label_1c;
-				}
-			}
-Label_1c:
-			j0h =  (LeftMin << (ln2uiblockbitsn - vMacScreenDepth)) + j;
-#else
-			j0h =  LeftMin;
-#endif
+LOCALPROC ScreenDamageAdd(ScrnRect *r)
+{
+	ScrnRect t = *r;
+	int i;
+	int best;
+	ui5r cost;
+	ui5r bestcost;
 
-#if vMacScreenDepth > ln2uiblockbitsn
-			j1h = (RightMax >> (vMacScreenDepth - ln2uiblockbitsn)) + 1;
-#elif ln2uiblockbitsn > vMacScreenDepth
-			for (j = (uiblockbitsn >> vMacScreenDepth); --j >= 0; ) {
-				if (0 != (RightMask
-					& (((((uibr)1) << (1 << vMacScreenDepth)) - 1)
-						<< ((j ^ FlipCheckBits) << vMacScreenDepth))))
-				{
-					goto Label_2c;
-				}
-			}
-Label_2c:
-			j1h = (RightMax << (ln2uiblockbitsn - vMacScreenDepth))
-				+ j + 1;
-#else
-			j1h = RightMax + 1;
-#endif
+label_retry:
+	best = -1;
+	bestcost = (ui5r) -1;
+	for (i = 0; i < ScreenDamageN; ++i) {
+		cost = ScrnRectMergeCost(&t, &ScreenDamage[i]);
+		if (cost < bestcost) {
+			bestcost = cost;
+			best = i;
 		}
+	}
 
-		copyrows = j1v - j0v;
-		copyoffset = j0v * vMacScreenByteWidth;
-		copysize = copyrows * vMacScreenByteWidth;
-	} else
-#endif
+	if ((best >= 0) && ((bestcost <= kScrnRectCost)
+		|| (ScreenDamageN >= kMaxScrnRects)))
 	{
-#if 0 != vMacScreenDepth
-		if (ColorMappingChanged) {
-			ColorMappingChanged = falseblnr;
-			j0h = 0;
-			j1h = vMacScreenWidth;
-			j0v = 0;
-			j1v = vMacScreenHeight;
-#if WantColorTransValid
-			ColorTransValid = falseblnr;
-#endif
-		} else
-#endif
-		{
-			if (! FindFirstChangeInLVecs(
-				(uibb *)screencurrentbuff
-					+ NextDrawRow * (vMacScreenWidth / uiblockbitsn),
-				(uibb *)screencomparebuff
-					+ NextDrawRow * (vMacScreenWidth / uiblockbitsn),
-				((uimr)(vMacScreenHeight - NextDrawRow)
-					* (uimr)vMacScreenWidth) / uiblockbitsn,
-				&j0))
-			{
-				NextDrawRow = 0;
-				return falseblnr;
-			}
-			j0v = j0 / (vMacScreenWidth / uiblockbitsn);
-			j0h = j0 - j0v * (vMacScreenWidth / uiblockbitsn);
-			j0v += NextDrawRow;
-			LimitDrawRow = j0v + MaxRowsDrawnPerTick;
-			if (LimitDrawRow >= vMacScreenHeight) {
-				LimitDrawRow = vMacScreenHeight;
-				NextDrawRow = 0;
-			} else {
-				NextDrawRow = LimitDrawRow;
-			}
-			FindLastChangeInLVecs((uibb *)screencurrentbuff,
-				(uibb *)screencomparebuff,
-				((uimr)LimitDrawRow
-					* (uimr)vMacScreenWidth) / uiblockbitsn,
-				&j1);
-			j1v = j1 / (vMacScreenWidth / uiblockbitsn);
-			j1h = j1 - j1v * (vMacScreenWidth / uiblockbitsn);
-			j1v++;
-
-			if (j0h < j1h) {
-				LeftMin = j0h;
-				RightMax = j1h;
-			} else {
-				LeftMin = j1h;
-				RightMax = j0h;
-			}
-
-			FindLeftRightChangeInLMat((uibb *)screencurrentbuff,
-				(uibb *)screencomparebuff,
-				(vMacScreenWidth / uiblockbitsn),
-				j0v, j1v, &LeftMin, &LeftMask, &RightMax, &RightMask);
-
-			for (j = 0; j < uiblockbitsn; ++j) {
-				if (0 != (LeftMask
-					& (((uibr)1) << (j ^ FlipCheckMonoBits))))
-				{
-					goto Label_1;
-				}
-			}
-Label_1:
-			j0h = LeftMin * uiblockbitsn + j;
-
-			for (j = uiblockbitsn; --j >= 0; ) {
-				if (0 != (RightMask
-					& (((uibr)1) << (j ^ FlipCheckMonoBits))))
-				{
-					goto Label_2;
-				}
-			}
-Label_2:
-			j1h = RightMax * uiblockbitsn + j + 1;
-		}
-
-		copyrows = j1v - j0v;
-		copyoffset = j0v * vMacScreenMonoByteWidth;
-		copysize = copyrows * vMacScreenMonoByteWidth;
+		/*
+			merge, then the result may need
+			merging with another one.
+		*/
+		ScrnRectUnion(&t, &ScreenDamage[best]);
+		ScreenDamage[best] = ScreenDamage[--ScreenDamageN];
+		goto label_retry;
 	}
 
-	MyMoveBytes((anyp)screencurrentbuff + copyoffset,
-		(anyp)screencomparebuff + copyoffset,
-		copysize);
-
-	*top = j0v;
-	*left = j0h;
-	*bottom = j1v;
-	*right = j1h;
-
-	return trueblnr;
+	ScreenDamage[ScreenDamageN++] = t;
 }
 
-GLOBALVAR blnr EmVideoDisable = falseblnr;
-GLOBALVAR si3b EmLagTime = 0;
-
-GLOBALVAR ui5b OnTrueTime = 0;
-	/*
-		The time slice we are currently dealing
-		with, in the same units as TrueEmulatedTime.
-	*/
-
-LOCALVAR si4b ScreenChangedTop;
-LOCALVAR si4b ScreenChangedLeft;
-LOCALVAR si4b ScreenChangedBottom;
-LOCALVAR si4b ScreenChangedRight;
-
 LOCALPROC ScreenClearChanges(void)
 {
 	ScreenChangedTop = vMacScreenHeight;
 	ScreenChangedBottom = 0;
 	ScreenChangedLeft = vMacScreenWidth;
 	ScreenChangedRight = 0;
+	ScreenDamageN = 0;
 }
 
 LOCALPROC ScreenChangedAll(void)
@@ -643,6 +429,11 @@ LOCALPROC ScreenChangedAll(void)
 	ScreenChangedBottom = vMacScreenHeight;
 	ScreenChangedLeft = 0;
 	ScreenChangedRight = vMacScreenWidth;
+	ScreenDamage[0].top = 0;
+	ScreenDamage[0].left = 0;
+	ScreenDamage[0].bottom = vMacScreenHeight;
+	ScreenDamage[0].right = vMacScreenWidth;
+	ScreenDamageN = 1;
 }
 
 #if EnableAutoSlow
@@ -652,17 +443,44 @@ LOCALVAR si4b ScreenChangedQuietBottom = 0;
 LOCALVAR si4b ScreenChangedQuietRight = 0;
 #endif
 
+#if UseScrnCapt
+FORWARDPROC ScrnCapt_Frame(ScrnRect *r, int n);
+	/* in SCRNCAPT.h */
+#endif
+#if UseScrnVrfy
+FORWARDPROC ScrnVrfy_Frame(ui3p screencurrentbuff);
+	/* in SCRNVRFY.h */
+#endif
+
 GLOBALOSGLUPROC Screen_OutputFrame(ui3p screencurrentbuff)
 {
+	ScrnRect rects[kMaxScrnRects];
+	int n;
+	int i;
 	si4b top;
 	si4b left;
 	si4b bottom;
 	si4b right;
 
+#if UseScrnVrfy
+	ScrnVrfy_Frame(screencurrentbuff);
+#endif
 	if (! EmVideoDisable) {
-		if (ScreenFindChanges(screencurrentbuff, EmLagTime,
-			&top, &left, &bottom, &right))
-		{
+		n = ScreenFindChangedRects(screencurrentbuff, EmLagTime, rects);
+#if UseScrnCapt
+		ScrnCapt_Frame(rects, n);
+#endif
+		if (0 != n) {
+			++ScreenChangedFrames;
+		}
+		for (i = 0; i < n; ++i) {
+			top = rects[i].top;
+			left = rects[i].left;
+			bottom = rects[i].bottom;
+			right = rects[i].right;
+
+			ScreenDamageAdd(&rects[i]);
+
 			if (top < ScreenChangedTop) {
 				ScreenChangedTop = top;
 			}
@@ -706,6 +524,34 @@ GLOBALOSGLUPROC Screen_OutputFrame(ui3p screencurrentbuff)
 	}
 }
 
+#if WantScreenHash
+
+#define MyHashInit 2166136261UL
+
+LOCALFUNC ui5r MyHashBytes(ui3p p, uimr n, ui5r h)
+{
+	/* FNV-1a */
+	uimr i;
+
+	for (i = n + 1; 0 != --i; ) {
+		h = (h ^ *p++) * 16777619;
+	}
+
+	return h;
+}
+
+LOCALFUNC ui5r ScreenHash(void)
+{
+	/*
+		screencomparebuff holds what has been presented
+		so far, the same in every OSGLUxxx.
+	*/
+	return MyHashBytes(screencomparebuff, vMacScreenNumBytes,
+		MyHashInit);
+}
+
+#endif
+
 #if MayFullScreen
 LOCALVAR ui4r ViewHSize;
 LOCALVAR ui4r ViewVSize;
@@ -1042,9 +888,21 @@ GLOBALOSGLUPROC MyEvtQOutDone(void)
 LOCALVAR blnr MyEvtQNeedRecover = falseblnr;
 	/* events lost because of full queue */
 
+#if EnableEvtReplay
+LOCALVAR blnr MyEvtQLastSealed = falseblnr;
+	/* last event already recorded, don't coalesce into it */
+LOCALVAR blnr MyEvtQHostBlocked = falseblnr;
+	/* replaying, drop events from the host */
+#endif
+
 LOCALFUNC MyEvtQEl * MyEvtQElPreviousIn(void)
 {
 	MyEvtQEl *p = NULL;
+#if EnableEvtReplay
+	if (MyEvtQLastSealed || MyEvtQHostBlocked) {
+		return NULL;
+	}
+#endif
 	if (MyEvtQIn - MyEvtQOut != 0) {
 		p = &MyEvtQA[(MyEvtQIn - 1) & MyEvtQIMask];
 	}
@@ -1055,12 +913,20 @@ LOCALFUNC MyEvtQEl * MyEvtQElPreviousIn(void)
 LOCALFUNC MyEvtQEl * MyEvtQElAlloc(void)
 {
 	MyEvtQEl *p = NULL;
+#if EnableEvtReplay
+	if (MyEvtQHostBlocked) {
+		return NULL;
+	}
+#endif
 	if (MyEvtQIn - MyEvtQOut >= MyEvtQSz) {
 		MyEvtQNeedRecover = trueblnr;
 	} else {
 		p = &MyEvtQA[MyEvtQIn & MyEvtQIMask];
 
 		++MyEvtQIn;
+#if EnableEvtReplay
+		MyEvtQLastSealed = falseblnr;
+#endif
 	}
 
 	return p;
@@ -0,0 +1,775 @@
+/*
+	EVTRPLAY.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	EVenT RePLAY
+
+	Record everything the host hands to the emulated machine,
+	and exactly when, so the session can be played back later
+	with a bit for bit identical result.
+
+	The emulated machine only learns about the host through the
+	OSGLUAAA.h interface, and apart from disk data and the
+	clipboard, only in between calls to WaitForNextTick. So a
+	recording is a sequence of slices, one per return from
+	WaitForNextTick. For each slice is logged whatever changed
+	since the emulation last ran (new event queue entries,
+	inserted disks, QuietEnds, speed settings, the date), then
+	OnTrueTime and the number of times ExtraTimeNotOver answered
+	true before the slice ended. That count pins down how many
+	extra sub ticks got run, so on playback the host clock
+	(GetCurrentTicks) is not consulted at all, and playback
+	runs as fast as the host allows.
+
+	Disk images are not part of the recording. Playback must
+	start from the same images, which is checked.
+
+	The OSGLUxxx file includes this after COMOSGLU.h, PBUFSTDC.h
+	and its Sony_Insert1, and then calls EvtRply_TickBegin at the
+	start of WaitForNextTick, EvtRply_TickEnd just before it
+	returns, passes the result of ExtraTimeNotOver through
+	EvtRply_ExtraTime, inserts disks the user asks for with
+	EvtRply_Sony_Insert1, and lets EvtRply_ClipImport see
+	clipboard imports.
+*/
+
+#ifdef EVTRPLAY_H
+#error "header already included"
+#else
+#define EVTRPLAY_H
+#endif
+
+#define kEvtRplyOff 0
+#define kEvtRplyRecord 1
+#define kEvtRplyReplay 2
+
+#define kEvtRplyVersion 1
+
+/* record tags */
+#define kEvtRplyTagBegin 'B'
+#define kEvtRplyTagSlice 'S'
+#define kEvtRplyTagEvent 'E'
+#define kEvtRplyTagVar 'V'
+#define kEvtRplyTagQuiet 'Q'
+#define kEvtRplyTagDisk 'D'
+#define kEvtRplyTagImage 'I'
+#define kEvtRplyTagClip 'C'
+#define kEvtRplyTagCheck 'H'
+
+#ifndef EvtRplyCheckInterval
+#define EvtRplyCheckInterval 60
+	/* slices between screen checks, about a second */
+#endif
+
+#define EvtRplyClipQSz 4
+#define kEvtRplyNoClip 0xFFFFFFFF
+
+enum {
+	kEvtRplyVarSpeed,
+#if EnableAutoSlow
+	kEvtRplyVarNotAutoSlow,
+#endif
+	kEvtRplyVarInterrupt,
+	kEvtRplyVarReset,
+	kEvtRplyVarDate,
+#if AutoLocation
+	kEvtRplyVarLatitude,
+	kEvtRplyVarLongitude,
+#endif
+#if AutoTimeZone
+	kEvtRplyVarDelta,
+#endif
+
+	kNumEvtRplyVars
+};
+
+LOCALVAR int EvtRplyMode = kEvtRplyOff;
+LOCALVAR char *EvtRplyRecordPath = NULL;
+LOCALVAR char *EvtRplyReplayPath = NULL;
+LOCALVAR FILE *EvtRplyFile = NULL;
+
+LOCALVAR blnr EvtRplyInSlice = falseblnr;
+LOCALVAR blnr EvtRplyTimeOver;
+LOCALVAR ui5r EvtRplyExtraCount;
+	/*
+		when recording, number of times ExtraTimeNotOver
+		has said true in this slice. when replaying, number
+		of times it still should.
+	*/
+LOCALVAR ui5r EvtRplySliceCount = 0;
+LOCALVAR ui5r EvtRplyChecksDone = 0;
+LOCALVAR ui5r EvtRplyChecksFailed = 0;
+LOCALVAR ui5r EvtRplyFirstBadSlice = 0;
+
+LOCALVAR ui5r EvtRplyVarSave[kNumEvtRplyVars];
+#if EnableAutoSlow
+LOCALVAR ui5r EvtRplyQuietTimeSave;
+LOCALVAR ui5r EvtRplyQuietSubTicksSave;
+#endif
+
+LOCALVAR char *EvtRplyClipQ[EvtRplyClipQSz];
+LOCALVAR ui3r EvtRplyClipQIn = 0;
+LOCALVAR ui3r EvtRplyClipQOut = 0;
+
+LOCALFUNC ui5r EvtRplyGetVar(int i)
+{
+	switch (i) {
+		case kEvtRplyVarSpeed:
+			return SpeedValue;
+#if EnableAutoSlow
+		case kEvtRplyVarNotAutoSlow:
+			return WantNotAutoSlow;
+#endif
+		case kEvtRplyVarInterrupt:
+			return WantMacInterrupt;
+		case kEvtRplyVarReset:
+			return WantMacReset;
+		case kEvtRplyVarDate:
+			return CurMacDateInSeconds;
+#if AutoLocation
+		case kEvtRplyVarLatitude:
+			return CurMacLatitude;
+		case kEvtRplyVarLongitude:
+			return CurMacLongitude;
+#endif
+#if AutoTimeZone
+		case kEvtRplyVarDelta:
+			return CurMacDelta;
+#endif
+		default:
+			return 0;
+	}
+}
+
+LOCALPROC EvtRplySetVar(int i, ui5r v)
+{
+	switch (i) {
+		case kEvtRplyVarSpeed:
+			SpeedValue = v;
+			break;
+#if EnableAutoSlow
+		case kEvtRplyVarNotAutoSlow:
+			WantNotAutoSlow = (0 != v);
+			break;
+#endif
+		case kEvtRplyVarInterrupt:
+			WantMacInterrupt = (0 != v);
+			break;
+		case kEvtRplyVarReset:
+			WantMacReset = (0 != v);
+			break;
+		case kEvtRplyVarDate:
+			CurMacDateInSeconds = v;
+			break;
+#if AutoLocation
+		case kEvtRplyVarLatitude:
+			CurMacLatitude = v;
+			break;
+		case kEvtRplyVarLongitude:
+			CurMacLongitude = v;
+			break;
+#endif
+#if AutoTimeZone
+		case kEvtRplyVarDelta:
+			CurMacDelta = v;
+			break;
+#endif
+		default:
+			break;
+	}
+}
+
+/* --- file format, little endian --- */
+
+LOCALPROC EvtRplyPut1(ui3r v)
+{
+	(void) putc(v, EvtRplyFile);
+}
+
+LOCALPROC EvtRplyPut2(ui4r v)
+{
+	EvtRplyPut1(v & 0xFF);
+	EvtRplyPut1((v >> 8) & 0xFF);
+}
+
+LOCALPROC EvtRplyPut4(ui5r v)
+{
+	EvtRplyPut2(v & 0xFFFF);
+	EvtRplyPut2((v >> 16) & 0xFFFF);
+}
+
+LOCALVAR blnr EvtRplyAtEOF = falseblnr;
+
+LOCALFUNC ui3r EvtRplyGet1(void)
+{
+	int c = getc(EvtRplyFile);
+
+	if (EOF == c) {
+		EvtRplyAtEOF = trueblnr;
+		c = 0;
+	}
+
+	return c;
+}
+
+LOCALFUNC ui4r EvtRplyGet2(void)
+{
+	ui4r v = EvtRplyGet1();
+
+	return v | (EvtRplyGet1() << 8);
+}
+
+LOCALFUNC ui5r EvtRplyGet4(void)
+{
+	ui5r v = EvtRplyGet2();
+
+	return v | ((ui5r)EvtRplyGet2() << 16);
+}
+
+LOCALFUNC blnr EvtRplyImageCheck(tDrive Drive_No,
+	ui5r *Size, ui5r *Sum)
+{
+#define EvtRplyImageBuffSz 65536
+	ui5r L;
+	ui5r i;
+	ui5r n;
+	ui5r h = MyHashInit;
+	blnr IsOk = falseblnr;
+	ui3p buff = (ui3p)malloc(EvtRplyImageBuffSz);
+
+	if (NULL != buff) {
+		if (mnvm_noErr == vSonyGetSize(Drive_No, &L)) {
+			for (i = 0; i < L; i += n) {
+				n = L - i;
+				if (n > EvtRplyImageBuffSz) {
+					n = EvtRplyImageBuffSz;
+				}
+				if (mnvm_noErr != vSonyTransfer(falseblnr, buff,
+					Drive_No, i, n, nullpr))
+				{
+					goto label_fail;
+				}
+				h = MyHashBytes(buff, n, h);
+			}
+			*Size = L;
+			*Sum = h;
+			IsOk = trueblnr;
+		}
+label_fail:
+		free(buff);
+	}
+
+	return IsOk;
+}
+
+/* --- recording --- */
+
+LOCALPROC EvtRplyPutVar(int i, ui5r v)
+{
+	EvtRplyPut1(kEvtRplyTagVar);
+	EvtRplyPut1(i);
+	EvtRplyPut4(v);
+}
+
+LOCALPROC EvtRplyPutEvent(MyEvtQEl *p)
+{
+	EvtRplyPut1(kEvtRplyTagEvent);
+	EvtRplyPut1(p->kind);
+	switch (p->kind) {
+		case MyEvtQElKindKey:
+		case MyEvtQElKindMouseButton:
+			EvtRplyPut1(p->u.press.down);
+			EvtRplyPut1(p->u.press.key);
+			EvtRplyPut2(0);
+			break;
+		default:
+			EvtRplyPut2(p->u.pos.h);
+			EvtRplyPut2(p->u.pos.v);
+			break;
+	}
+}
+
+LOCALVAR ui4r EvtRplyEvtQLogged = 0;
+
+LOCALPROC EvtRplyRecordInputs(void)
+{
+	int i;
+
+	for (i = 0; i < kNumEvtRplyVars; ++i) {
+		ui5r v = EvtRplyGetVar(i);
+
+		if (v != EvtRplyVarSave[i]) {
+			EvtRplyPutVar(i, v);
+		}
+	}
+
+#if EnableAutoSlow
+	if ((0 == QuietTime) && (0 == QuietSubTicks)
+		&& ((0 != EvtRplyQuietTimeSave)
+			|| (0 != EvtRplyQuietSubTicksSave)))
+	{
+		EvtRplyPut1(kEvtRplyTagQuiet);
+	}
+#endif
+
+	while (EvtRplyEvtQLogged != MyEvtQIn) {
+		EvtRplyPutEvent(&MyEvtQA[EvtRplyEvtQLogged & MyEvtQIMask]);
+		++EvtRplyEvtQLogged;
+	}
+	MyEvtQLastSealed = trueblnr;
+}
+
+LOCALFUNC blnr EvtRplyStartRecord(void)
+{
+	int i;
+	ui5r Size;
+	ui5r Sum;
+
+	EvtRplyFile = fopen(EvtRplyRecordPath, "wb");
+	if (NULL == EvtRplyFile) {
+		fprintf(stderr, "Couldn't create recording %s\n",
+			EvtRplyRecordPath);
+		return falseblnr;
+	}
+
+	(void) fwrite("MnvMRply", 1, 8, EvtRplyFile);
+	EvtRplyPut4(kEvtRplyVersion);
+
+	for (i = 0; i < kNumEvtRplyVars; ++i) {
+		EvtRplyPutVar(i, EvtRplyGetVar(i));
+	}
+
+	for (i = 0; i < NumDrives; ++i) {
+		if (vSonyIsInserted(i) && EvtRplyImageCheck(i, &Size, &Sum)) {
+			EvtRplyPut1(kEvtRplyTagImage);
+			EvtRplyPut1(i);
+			EvtRplyPut4(Size);
+			EvtRplyPut4(Sum);
+		}
+	}
+
+	EvtRplyPut1(kEvtRplyTagBegin);
+
+	EvtRplyEvtQLogged = MyEvtQIn;
+	EvtRplyMode = kEvtRplyRecord;
+
+	return trueblnr;
+}
+
+LOCALPROC EvtRplyRecordSliceEnd(void)
+{
+	EvtRplyPut1(kEvtRplyTagSlice);
+	EvtRplyPut4(OnTrueTime);
+	EvtRplyPut4(EvtRplyExtraCount);
+
+	if (0 == (EvtRplySliceCount % EvtRplyCheckInterval)) {
+		EvtRplyPut1(kEvtRplyTagCheck);
+		EvtRplyPut4(ScreenHash());
+	}
+}
+
+/* --- replaying --- */
+
+LOCALVAR blnr EvtRplyHostBlocked = falseblnr;
+	/*
+		while replaying, ignore disk inserts that don't come
+		from the recording.
+	*/
+
+LOCALPROC EvtRplyGetEvent(void)
+{
+	MyEvtQEl e;
+
+	e.kind = EvtRplyGet1();
+	switch (e.kind) {
+		case MyEvtQElKindKey:
+		case MyEvtQElKindMouseButton:
+			e.u.press.down = EvtRplyGet1();
+			e.u.press.key = EvtRplyGet1();
+			(void) EvtRplyGet2();
+			break;
+		default:
+			e.u.pos.h = EvtRplyGet2();
+			e.u.pos.v = EvtRplyGet2();
+			break;
+	}
+
+	if (MyEvtQIn - MyEvtQOut >= MyEvtQSz) {
+		/* can't happen if replay is in sync */
+		MyEvtQNeedRecover = trueblnr;
+	} else {
+		MyEvtQA[MyEvtQIn & MyEvtQIMask] = e;
+		++MyEvtQIn;
+	}
+}
+
+LOCALPROC EvtRplyGetDisk(void)
+{
+	ui4r L = EvtRplyGet2();
+	char *s = (char *)malloc(L + 1);
+
+	if (NULL == s) {
+		(void) fseek(EvtRplyFile, L, SEEK_CUR);
+	} else {
+		if (L != fread(s, 1, L, EvtRplyFile)) {
+			EvtRplyAtEOF = trueblnr;
+		} else {
+			s[L] = 0;
+			if (! Sony_Insert1(s, falseblnr)) {
+				fprintf(stderr, "replay: couldn't insert %s\n", s);
+			}
+		}
+		free(s);
+	}
+}
+
+LOCALPROC EvtRplyGetClip(void)
+{
+	ui5r L = EvtRplyGet4();
+	char *s = NULL;
+
+	if (kEvtRplyNoClip != L) {
+		s = (char *)malloc(L + 1);
+		if (NULL == s) {
+			(void) fseek(EvtRplyFile, L, SEEK_CUR);
+		} else if (L != fread(s, 1, L, EvtRplyFile)) {
+			EvtRplyAtEOF = trueblnr;
+			free(s);
+			return;
+		} else {
+			s[L] = 0;
+		}
+	}
+
+	if ((ui3r)(EvtRplyClipQIn - EvtRplyClipQOut) >= EvtRplyClipQSz) {
+		MyMayFree(s);
+	} else {
+		EvtRplyClipQ[EvtRplyClipQIn % EvtRplyClipQSz] = s;
+		++EvtRplyClipQIn;
+	}
+}
+
+LOCALPROC EvtRplyCheckScreen(ui5r v)
+{
+	++EvtRplyChecksDone;
+	if (v != ScreenHash()) {
+		if (0 == EvtRplyChecksFailed) {
+			EvtRplyFirstBadSlice = EvtRplySliceCount;
+		}
+		++EvtRplyChecksFailed;
+	}
+}
+
+LOCALPROC EvtRplyGetImage(void)
+{
+	tDrive Drive_No = EvtRplyGet1();
+	ui5r Size = EvtRplyGet4();
+	ui5r Sum = EvtRplyGet4();
+	ui5r CurSize;
+	ui5r CurSum;
+
+	if ((Drive_No >= NumDrives) || ! vSonyIsInserted(Drive_No)
+		|| ! EvtRplyImageCheck(Drive_No, &CurSize, &CurSum)
+		|| (CurSize != Size) || (CurSum != Sum))
+	{
+		fprintf(stderr,
+			"replay: disk image %d differs from the recording\n",
+			(int)Drive_No);
+	}
+}
+
+LOCALFUNC blnr EvtRplyGetInputs(blnr Initial)
+{
+	/*
+		apply records up to and including the end of the
+		next slice (or the begin marker, for the initial ones).
+	*/
+	ui3r tag;
+
+	for (; ; ) {
+		tag = EvtRplyGet1();
+		if (EvtRplyAtEOF) {
+			return falseblnr;
+		}
+		switch (tag) {
+			case kEvtRplyTagVar:
+				{
+					int i = EvtRplyGet1();
+					EvtRplySetVar(i, EvtRplyGet4());
+				}
+				break;
+#if EnableAutoSlow
+			case kEvtRplyTagQuiet:
+				QuietEnds();
+				break;
+#endif
+			case kEvtRplyTagEvent:
+				EvtRplyGetEvent();
+				break;
+			case kEvtRplyTagDisk:
+				EvtRplyGetDisk();
+				break;
+			case kEvtRplyTagClip:
+				EvtRplyGetClip();
+				break;
+			case kEvtRplyTagCheck:
+				EvtRplyCheckScreen(EvtRplyGet4());
+				break;
+			case kEvtRplyTagImage:
+				EvtRplyGetImage();
+				break;
+			case kEvtRplyTagBegin:
+				if (Initial) {
+					return trueblnr;
+				}
+				goto label_bad;
+			case kEvtRplyTagSlice:
+				if (! Initial) {
+					OnTrueTime = EvtRplyGet4();
+					EvtRplyExtraCount = EvtRplyGet4();
+					return ! EvtRplyAtEOF;
+				}
+				goto label_bad;
+			default:
+label_bad:
+				fprintf(stderr, "replay: bad record\n");
+				return falseblnr;
+		}
+	}
+}
+
+LOCALFUNC blnr EvtRplyStartReplay(void)
+{
+	char magic[8];
+
+	EvtRplyFile = fopen(EvtRplyReplayPath, "rb");
+	if (NULL == EvtRplyFile) {
+		fprintf(stderr, "Couldn't open recording %s\n",
+			EvtRplyReplayPath);
+		return falseblnr;
+	}
+
+	if ((8 != fread(magic, 1, 8, EvtRplyFile))
+		|| (0 != memcmp(magic, "MnvMRply", 8))
+		|| (kEvtRplyVersion != EvtRplyGet4())
+		|| ! EvtRplyGetInputs(trueblnr))
+	{
+		fprintf(stderr, "%s is not a usable recording\n",
+			EvtRplyReplayPath);
+		return falseblnr;
+	}
+
+	EvtRplyHostBlocked = trueblnr;
+	MyEvtQHostBlocked = trueblnr;
+	EvtRplyMode = kEvtRplyReplay;
+
+	return trueblnr;
+}
+
+/* --- interface for OSGLUxxx --- */
+
+LOCALFUNC blnr EvtRply_Init(void)
+{
+	/*
+		call after disks from the command line are inserted
+		and the date and location are known.
+	*/
+	if (NULL != EvtRplyReplayPath) {
+		return EvtRplyStartReplay();
+	} else if (NULL != EvtRplyRecordPath) {
+		return EvtRplyStartRecord();
+	} else {
+		return trueblnr;
+	}
+}
+
+LOCALPROC EvtRply_UnInit(void)
+{
+	if (NULL != EvtRplyFile) {
+		if (kEvtRplyRecord == EvtRplyMode) {
+			if (EvtRplyInSlice) {
+				EvtRplyRecordSliceEnd();
+			}
+		} else {
+			fprintf(stderr, "replay: %u slices, %u screen checks,",
+				(unsigned int)EvtRplySliceCount,
+				(unsigned int)EvtRplyChecksDone);
+			if (0 == EvtRplyChecksFailed) {
+				fprintf(stderr, " all matched\n");
+			} else {
+				fprintf(stderr, " %u differed, first at slice %u\n",
+					(unsigned int)EvtRplyChecksFailed,
+					(unsigned int)EvtRplyFirstBadSlice);
+			}
+		}
+		fclose(EvtRplyFile);
+		EvtRplyFile = NULL;
+	}
+
+	while (EvtRplyClipQIn != EvtRplyClipQOut) {
+		MyMayFree(EvtRplyClipQ[EvtRplyClipQOut % EvtRplyClipQSz]);
+		++EvtRplyClipQOut;
+	}
+
+	EvtRplyMode = kEvtRplyOff;
+}
+
+LOCALPROC EvtRply_TickBegin(void)
+{
+	int i;
+
+	if (kEvtRplyOff == EvtRplyMode) {
+		return;
+	}
+
+	if (EvtRplyInSlice) {
+		EvtRplyInSlice = falseblnr;
+		if (kEvtRplyRecord == EvtRplyMode) {
+			EvtRplyRecordSliceEnd();
+		}
+		++EvtRplySliceCount;
+	}
+
+	/* what the emulated machine left behind */
+	for (i = 0; i < kNumEvtRplyVars; ++i) {
+		EvtRplyVarSave[i] = EvtRplyGetVar(i);
+	}
+#if EnableAutoSlow
+	EvtRplyQuietTimeSave = QuietTime;
+	EvtRplyQuietSubTicksSave = QuietSubTicks;
+#endif
+}
+
+LOCALPROC EvtRply_TickEnd(void)
+{
+	int i;
+
+	switch (EvtRplyMode) {
+		case kEvtRplyRecord:
+			EvtRplyRecordInputs();
+			EvtRplyExtraCount = 0;
+			break;
+		case kEvtRplyReplay:
+			/* forget what the host did, use the recording */
+			for (i = 0; i < kNumEvtRplyVars; ++i) {
+				EvtRplySetVar(i, EvtRplyVarSave[i]);
+			}
+#if EnableAutoSlow
+			QuietTime = EvtRplyQuietTimeSave;
+			QuietSubTicks = EvtRplyQuietSubTicksSave;
+#endif
+			if (! EvtRplyGetInputs(falseblnr)) {
+				ForceMacOff = trueblnr;
+				return;
+			}
+			break;
+		default:
+			return;
+	}
+
+	EvtRplyTimeOver = falseblnr;
+	EvtRplyInSlice = trueblnr;
+}
+
+LOCALFUNC blnr EvtRply_ExtraTime(blnr NotOver)
+{
+	/* pass the answer of ExtraTimeNotOver through here */
+	switch (EvtRplyMode) {
+		case kEvtRplyRecord:
+			if (EvtRplyInSlice && ! EvtRplyTimeOver) {
+				if (NotOver) {
+					++EvtRplyExtraCount;
+				} else {
+					EvtRplyTimeOver = trueblnr;
+				}
+			}
+			break;
+		case kEvtRplyReplay:
+			/*
+				outside of a slice, say time is over, so
+				WaitForNextTick doesn't wait.
+			*/
+			NotOver = falseblnr;
+			if (EvtRplyInSlice && (0 != EvtRplyExtraCount)) {
+				--EvtRplyExtraCount;
+				NotOver = trueblnr;
+			}
+			break;
+		default:
+			break;
+	}
+
+	return NotOver;
+}
+
+LOCALFUNC blnr EvtRply_Sony_Insert1(char *drivepath, blnr silentfail)
+{
+	/*
+		use in place of Sony_Insert1 for disks the user
+		asks for.
+	*/
+	blnr IsOk = falseblnr;
+
+	if (! EvtRplyHostBlocked) {
+		IsOk = Sony_Insert1(drivepath, silentfail);
+		if (IsOk && (kEvtRplyRecord == EvtRplyMode)) {
+			ui4r L = strlen(drivepath);
+
+			EvtRplyPut1(kEvtRplyTagDisk);
+			EvtRplyPut2(L);
+			(void) fwrite(drivepath, 1, L, EvtRplyFile);
+		}
+	}
+
+	return IsOk;
+}
+
+#if IncludeHostTextClipExchange
+LOCALPROC EvtRply_ClipImport(ui3p *r)
+{
+	/*
+		*r is the malloc'ed host clipboard text about to be
+		given to the emulated machine, or NULL. when recording,
+		note it. when replaying, replace it with the recorded
+		one.
+	*/
+	ui5r L;
+
+	switch (EvtRplyMode) {
+		case kEvtRplyRecord:
+			L = (NULL == *r) ? kEvtRplyNoClip : strlen((char *)*r);
+			EvtRplyPut1(kEvtRplyTagClip);
+			EvtRplyPut4(L);
+			if (NULL != *r) {
+				(void) fwrite(*r, 1, L, EvtRplyFile);
+			}
+			break;
+		case kEvtRplyReplay:
+			if (NULL != *r) {
+				free(*r);
+				*r = NULL;
+			}
+			if (EvtRplyClipQIn != EvtRplyClipQOut) {
+				*r = (ui3p)EvtRplyClipQ[
+					EvtRplyClipQOut % EvtRplyClipQSz];
+				++EvtRplyClipQOut;
+			}
+			break;
+		default:
+			break;
+	}
+}
+#endif
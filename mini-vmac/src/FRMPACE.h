@@ -0,0 +1,227 @@
+/*
+	FRMPACE.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	FRaMe PACEr
+
+	The emulated machine finishes a frame 60.15 times a second,
+	which doesn't line up with the host display, at 60, 120, 144
+	or whatever Hz. Showing each frame as soon as it is done
+	means frames reach the screen at uneven points in the host's
+	refresh cycle, so smooth scrolling judders, and tears where
+	a frame is shown while the screen is being scanned out.
+
+	Instead, with --frame-pacing on (it is off unless asked
+	for), once the host refresh rate is known, the OSGLUxxx file
+	lets the changes pile up (they are kept anyway until drawn),
+	and shows whatever is newest once per host refresh, at the
+	point FrmPace_Due says. If the host presents in step with
+	its vertical blank (SDL with PRESENTVSYNC), then the time a
+	present returns is a vertical blank, and the schedule is
+	pinned to it, so a rate known only to the whole Hz does no
+	harm. Otherwise (X11) it only runs at the right rate, which
+	has to be exact, so it comes from the mode timings.
+
+	With kFrmPaceLock, if the host rate is close to a whole
+	multiple of 60.15 Hz (such as 60, 59.94 or 120), the length
+	of an emulated tick is changed to match it exactly, which
+	slows or speeds up the emulated machine by a fraction of a
+	percent, but then every frame is shown for the same number
+	of host refreshes, with none dropped or shown twice.
+
+	Times are in microseconds, from any start, allowed to wrap.
+*/
+
+#ifdef FRMPACE_H
+#error "header already included"
+#else
+#define FRMPACE_H
+#endif
+
+#define kFrmPaceOff 0
+#define kFrmPaceOn 1
+#define kFrmPaceLock 2
+
+#ifndef WantInitFrmPace
+#define WantInitFrmPace kFrmPaceOff
+#endif
+
+#define kFrmPaceTickMicros 16626 /* 1000000 / 60.14742 */
+
+LOCALVAR int FrmPaceMode = WantInitFrmPace;
+	/* set by --frame-pacing */
+LOCALVAR ui5r FrmPaceForceRate = 0;
+	/* set by --refresh-rate, in mHz, 0 to ask the host */
+
+LOCALVAR blnr FrmPaceOn = falseblnr;
+LOCALVAR blnr FrmPaceVSync = falseblnr;
+	/* presenting returns at a vertical blank */
+LOCALVAR ui5r FrmPaceRate = 0; /* host refresh in mHz */
+LOCALVAR ui5r FrmPacePeriod; /* host refresh period */
+LOCALVAR ui5r FrmPaceNext; /* when the next present is due */
+LOCALVAR blnr FrmPaceStarted = falseblnr;
+LOCALVAR blnr FrmPaceWaiting = falseblnr;
+	/* a finished frame hasn't been shown yet */
+LOCALVAR ui5r FrmPaceHeld = 0;
+	/* host refreshes the frame on screen has been shown for */
+LOCALVAR ui5r FrmPaceExpect;
+	/* how many it should be, at most */
+
+LOCALVAR ui5r FrmPaceStatShown = 0;
+LOCALVAR ui5r FrmPaceStatDropped = 0;
+LOCALVAR ui5r FrmPaceStatRepeated = 0;
+
+LOCALFUNC ui5r FrmPace_TickMicros(void)
+{
+	/*
+		length of an emulated tick to use, normally
+		kFrmPaceTickMicros, but a whole number of host refreshes
+		when locking to a rate within 1 percent of that.
+	*/
+	ui5r k;
+	ui5r t;
+
+	if (FrmPaceOn && (kFrmPaceLock == FrmPaceMode)) {
+		k = (kFrmPaceTickMicros + FrmPacePeriod / 2) / FrmPacePeriod;
+		if (0 != k) {
+			t = k * FrmPacePeriod;
+			if ((t * 100 > kFrmPaceTickMicros * 99)
+				&& (t * 100 < kFrmPaceTickMicros * 101))
+			{
+				return t;
+			}
+		}
+	}
+
+	return kFrmPaceTickMicros;
+}
+
+LOCALPROC FrmPace_SetRate(ui5r mHz, blnr VSync)
+{
+	/* mHz is 0 if the host doesn't know */
+	if (0 != FrmPaceForceRate) {
+		mHz = FrmPaceForceRate;
+	}
+
+	FrmPaceOn = (kFrmPaceOff != FrmPaceMode) && (mHz >= 10000);
+	if (FrmPaceOn) {
+		FrmPaceRate = mHz;
+		FrmPacePeriod = (ui5r)(1000000000.0 / mHz + 0.5);
+		FrmPaceVSync = VSync;
+		FrmPaceStarted = falseblnr;
+		FrmPaceExpect = (FrmPace_TickMicros() + FrmPacePeriod - 1)
+			/ FrmPacePeriod;
+	}
+}
+
+LOCALPROC FrmPace_FrameDone(void)
+{
+	/* the emulation finished a frame that changed the screen */
+	if (FrmPaceWaiting) {
+		++FrmPaceStatDropped;
+	}
+	FrmPaceWaiting = trueblnr;
+}
+
+LOCALFUNC blnr FrmPace_Due(ui5r Now)
+{
+	/*
+		true if a present should be done now. A frame that
+		stays up for more host refreshes than FrmPaceExpect was
+		repeated (unless for a lot more, then the screen just
+		wasn't changing).
+	*/
+	si5r d;
+	ui5r n;
+
+	if (! FrmPaceStarted) {
+		if (! FrmPaceWaiting) {
+			return falseblnr;
+		}
+		FrmPaceNext = Now;
+		FrmPaceStarted = trueblnr;
+	}
+
+	d = (si5r)(Now - FrmPaceNext);
+	if (d < 0) {
+		return falseblnr;
+	}
+
+	n = (ui5r)d / FrmPacePeriod + 1;
+	if (n > 16) {
+		/* the host stalled, start over */
+		FrmPaceNext = Now + FrmPacePeriod;
+	} else {
+		FrmPaceNext += n * FrmPacePeriod;
+	}
+
+	FrmPaceHeld += n;
+	if (FrmPaceWaiting) {
+		if ((FrmPaceHeld > FrmPaceExpect)
+			&& (FrmPaceHeld <= 4 * FrmPaceExpect))
+		{
+			FrmPaceStatRepeated += FrmPaceHeld - FrmPaceExpect;
+		}
+		FrmPaceHeld = 0;
+	}
+
+	return FrmPaceWaiting;
+}
+
+LOCALPROC FrmPace_Presented(ui5r Now)
+{
+	FrmPaceWaiting = falseblnr;
+	++FrmPaceStatShown;
+	if (FrmPaceVSync) {
+		/*
+			Now is just after a vertical blank, aim for
+			a little before the next one.
+		*/
+		FrmPaceNext = Now + FrmPacePeriod - FrmPacePeriod / 4;
+	}
+}
+
+LOCALFUNC ui5r FrmPace_Wait(ui5r Now)
+{
+	/*
+		how long to wait before a present is due,
+		(ui5r)-1 if there is nothing to present.
+	*/
+	si5r d = (si5r)(FrmPaceNext - Now);
+
+	if (! FrmPaceWaiting) {
+		return (ui5r) -1;
+	}
+	if ((! FrmPaceStarted) || (d < 0)) {
+		return 0;
+	}
+
+	return (ui5r)d;
+}
+
+LOCALPROC FrmPace_Report(void)
+{
+	if (FrmPaceOn) {
+		fprintf(stderr,
+			"pacing: host %u.%03u Hz, %u frames shown,"
+			" %u dropped, %u repeated\n",
+			(unsigned int)(FrmPaceRate / 1000),
+			(unsigned int)(FrmPaceRate % 1000),
+			(unsigned int)FrmPaceStatShown,
+			(unsigned int)FrmPaceStatDropped,
+			(unsigned int)FrmPaceStatRepeated);
+	}
+}
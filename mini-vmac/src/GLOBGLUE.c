@@ -51,6 +51,10 @@ IMPORTPROC ExtnSony_Access(CPTR p);
 #if EmVidCard
 IMPORTPROC ExtnVideo_Access(CPTR p);
 #endif
+#if IncludeExtnModPlayer
+IMPORTPROC ExtnModPlayer_Access(CPTR p);
+IMPORTPROC ExtnModPlayer_Reset(void);
+#endif
 
 IMPORTPROC Sony_SetQuitOnEject(void);
 
@@ -86,6 +90,9 @@ IMPORTPROC put_vm_word(CPTR addr, ui4r w);
 IMPORTPROC put_vm_long(CPTR addr, ui5r l);
 
 GLOBALVAR ui5r my_disk_icon_addr;
+#if IncludeSonyAsync
+GLOBALVAR ui5r my_sony_done_addr;
+#endif
 
 GLOBALPROC customreset(void)
 {
@@ -463,6 +470,9 @@ LOCALPROC ExtnHostTextClipExchange_Access(CPTR p)
 #if IncludeExtnHostTextClipExchange
 #define kHostClipExchangeExtension 0x27B130CA
 #endif
+#if IncludeExtnModPlayer
+#define kHostModPlayerExtension 0x4D8A3C19
+#endif
 
 #define kCmndFindExtnFind 1
 #define kCmndFindExtnId2Code 2
@@ -501,6 +511,13 @@ LOCALPROC ExtnFind_Access(CPTR p)
 						kExtnHostTextClipExchange);
 					result = mnvm_noErr;
 				} else
+#endif
+#if IncludeExtnModPlayer
+				if (extn == kHostModPlayerExtension) {
+					put_vm_word(p + kParamFindExtnTheId,
+						kExtnModPlayer);
+					result = mnvm_noErr;
+				} else
 #endif
 				if (extn == kFindExtnExtension) {
 					put_vm_word(p + kParamFindExtnTheId,
@@ -534,6 +551,13 @@ LOCALPROC ExtnFind_Access(CPTR p)
 						kHostClipExchangeExtension);
 					result = mnvm_noErr;
 				} else
+#endif
+#if IncludeExtnModPlayer
+				if (extn == kExtnModPlayer) {
+					put_vm_long(p + kParamFindExtnTheExtn,
+						kHostModPlayerExtension);
+					result = mnvm_noErr;
+				} else
 #endif
 				if (extn == kExtnFindExtn) {
 					put_vm_long(p + kParamFindExtnTheExtn,
@@ -593,6 +617,11 @@ LOCALPROC Extn_Access(ui5b Data, CPTR addr)
 						case kExtnHostTextClipExchange:
 							ExtnHostTextClipExchange_Access(p);
 							break;
+#endif
+#if IncludeExtnModPlayer
+						case kExtnModPlayer:
+							ExtnModPlayer_Access(p);
+							break;
 #endif
 						case kExtnDisk:
 							ExtnDisk_Access(p);
@@ -618,6 +647,9 @@ LOCALPROC Extn_Access(ui5b Data, CPTR addr)
 GLOBALPROC Extn_Reset(void)
 {
 	ParamAddrHi = (ui4b) - 1;
+#if IncludeExtnModPlayer
+	ExtnModPlayer_Reset();
+#endif
 }
 
 /* implementation of read/write for everything but RAM and ROM */
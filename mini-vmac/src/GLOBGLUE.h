@@ -199,6 +199,17 @@ EXPORTVAR(ui3b, Wires[kNumWires])
 
 #define kNumSubTicks 16
 
+#ifndef WantLazySubTick
+#define WantLazySubTick 1
+#endif
+#define UseLazySubTick (WantLazySubTick && EmASC)
+	/*
+		While the ASC can't be seen to make its samples a sub
+		tick at a time, don't end a cpu slice at each sub tick,
+		but make them when something looks. See SubTickTaskSync
+		in PROGMAIN.c.
+	*/
+
 
 #define HaveMasterMyEvtQLock EmClassicKbrd
 #if HaveMasterMyEvtQLock
@@ -232,6 +243,9 @@ enum {
 #if IncludeExtnHostTextClipExchange
 	kExtnHostTextClipExchange,
 #endif
+#if IncludeExtnModPlayer
+	kExtnModPlayer,
+#endif
 
 	kNumExtns
 };
@@ -239,6 +253,9 @@ enum {
 #define kcom_callcheck 0x5B17
 
 EXPORTVAR(ui5r, my_disk_icon_addr)
+#if IncludeSonyAsync
+EXPORTVAR(ui5r, my_sony_done_addr)
+#endif
 
 EXPORTPROC Memory_Reset(void);
 
@@ -0,0 +1,357 @@
+/*
+	MAPRBNCH.c
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	screen MAPpeR BeNCHmark
+
+	Stand alone microbenchmark and test for SCRNMAPR.h and
+	SCRNMAPV.h. Redraws the whole 512x342 1 bit screen into 32
+	bit pixels at scale 2 (the X11 and SDL window case), once
+	with the table of 256 entries per source byte (16K), and once
+	with each SIMD kernel of SCRNMAPV.h the cpu has, and prints
+	the time and, where Linux perf events are allowed, the L1
+	data cache misses for each.
+
+	Then each SIMD kernel, and the table given where the
+	rectangle goes (ScrnMapr_DstAtRect), is checked against the
+	table over many random frames: random screen contents,
+	redrawn in random rectangles (not byte aligned, any size,
+	down to a single pixel), which must give the same pixels,
+	both inside the rectangle and out.
+
+		MaprBench [redraws [warm]]
+
+	Between redraws the table is pushed out of the cache by
+	walking another buffer, as the emulator does between frames,
+	unless a second argument of "warm" is given. Exits with
+	status 1 if any result differs.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+typedef unsigned char ui3b;
+typedef unsigned short ui4b;
+typedef unsigned int ui5b;
+typedef short si4b;
+typedef unsigned int ui4r;
+typedef unsigned int ui5r;
+typedef int si5b;
+typedef ui3b *ui3p;
+typedef ui5b *ui5p;
+typedef unsigned char blnr;
+#define trueblnr 1
+#define falseblnr 0
+#define anyp ui3p
+#define nullpr ((void *) 0)
+#define LOCALVAR static
+#define LOCALFUNC static
+#define LOCALPROC static void
+
+#define vMacScreenWidth 512
+#define vMacScreenHeight 342
+#define vMacScreenMonoNumBytes (vMacScreenWidth * vMacScreenHeight / 8)
+#define Scale 2
+
+#include "BNCHUTIL.h"
+
+LOCALVAR ui3p Screen;
+LOCALVAR ui3p Out;
+LOCALVAR ui3p Tabl;
+
+#define ScrnMapr_DoMap MapByBytes
+#define ScrnMapr_Src Screen
+#define ScrnMapr_Dst Out
+#define ScrnMapr_SrcDepth 0
+#define ScrnMapr_DstDepth 5
+#define ScrnMapr_Map Tabl
+#define ScrnMapr_Scale Scale
+
+#include "SCRNMAPR.h"
+
+/*
+	the same, given where the rectangle goes, as the SDL 2 build
+	does with the part of the texture it locks
+*/
+
+LOCALVAR ui3p OutAtRect;
+
+#define ScrnMapr_DoMap MapByBytesAtRect0
+#define ScrnMapr_Src Screen
+#define ScrnMapr_Dst OutAtRect
+#define ScrnMapr_SrcDepth 0
+#define ScrnMapr_DstDepth 5
+#define ScrnMapr_Map Tabl
+#define ScrnMapr_Scale Scale
+#define ScrnMapr_DstAtRect 1
+
+#include "SCRNMAPR.h"
+
+LOCALPROC MapByBytesAtRect(si4b top, si4b left,
+	si4b bottom, si4b right)
+{
+	OutAtRect = Out
+		+ ((ui5r)top * Scale * vMacScreenWidth + (left & ~ 7))
+			* Scale * 4;
+	MapByBytesAtRect0(top, left, bottom, right);
+}
+
+/* the same, through the SIMD kernels, when there are any */
+
+#include "SCRNMAPV.h"
+
+#define ScrnMapr_DoMap MapByV
+#define ScrnMapr_Src Screen
+#define ScrnMapr_Dst Out
+#define ScrnMapr_SrcDepth 0
+#define ScrnMapr_DstDepth 5
+#define ScrnMapr_Map Tabl
+#define ScrnMapr_Scale Scale
+
+#include "SCRNMAPR.h"
+
+#define kRandomFrames 2000
+
+#define OutSz (vMacScreenWidth * vMacScreenHeight * Scale * Scale * 4)
+#define FlushSz (4 * 1024 * 1024)
+
+LOCALPROC SetUpTabl(void)
+{
+	/* like SetUpBW2ColorScalingTabl in OSGLUXWN.c */
+	int i;
+	int k;
+	int a;
+	ui5b v;
+	ui5p p4 = (ui5p)Tabl;
+
+	for (i = 0; i < 256; ++i) {
+		for (k = 8; --k >= 0; ) {
+			v = (0 != ((i >> k) & 1)) ? 0 : 0xFFFFFF;
+			for (a = Scale; --a >= 0; ) {
+				*p4++ = v;
+			}
+		}
+	}
+}
+
+#ifdef __linux__
+LOCALFUNC int OpenL1Misses(void)
+{
+	struct perf_event_attr pe;
+
+	memset(&pe, 0, sizeof(pe));
+	pe.type = PERF_TYPE_HW_CACHE;
+	pe.size = sizeof(pe);
+	pe.config = PERF_COUNT_HW_CACHE_L1D
+		| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+		| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	pe.disabled = 1;
+	pe.exclude_kernel = 1;
+	pe.exclude_hv = 1;
+
+	return syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+}
+#endif
+
+LOCALPROC Run(char *name, void (*DoMap)(si4b top, si4b left,
+	si4b bottom, si4b right), long n, int warm,
+	ui3p flush)
+{
+	long i;
+	int j;
+	double t = 0;
+	double t0;
+	unsigned long long misses = 0;
+	unsigned long long m;
+	int fd = -1;
+
+	SetUpTabl();
+
+#ifdef __linux__
+	fd = OpenL1Misses();
+#endif
+
+	for (i = 0; i < n; ++i) {
+		if (! warm) {
+			for (j = 0; j < FlushSz; j += 64) {
+				++flush[j];
+			}
+		}
+
+#ifdef __linux__
+		if (fd >= 0) {
+			(void) ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			(void) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+		t0 = Now();
+		DoMap(0, 0, vMacScreenHeight, vMacScreenWidth);
+		t += Now() - t0;
+#ifdef __linux__
+		if (fd >= 0) {
+			(void) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (sizeof(m) == read(fd, &m, sizeof(m))) {
+				misses += m;
+			}
+		}
+#endif
+	}
+
+	printf("%-8s table %5d bytes  %8.1f us/redraw", name,
+		256 * 8 * Scale * 4, t * 1e6 / n);
+	if (fd >= 0) {
+		printf("  %10.0f L1d misses/redraw\n", (double)misses / n);
+		close(fd);
+	} else {
+		printf("  (L1d misses not available)\n");
+	}
+}
+
+LOCALPROC RandomFrame(si4b *top, si4b *left,
+	si4b *bottom, si4b *right)
+{
+	long i;
+	long n = NextRnd() % vMacScreenMonoNumBytes;
+
+	/* change some of the screen, then pick what to redraw */
+	for (i = 0; i < n; i += 1 + NextRnd() % 64) {
+		Screen[i] = NextRnd() & 0xFF;
+	}
+	*top = NextRnd() % vMacScreenHeight;
+	*bottom = *top + 1 + NextRnd() % (vMacScreenHeight - *top);
+	*left = NextRnd() % vMacScreenWidth;
+	*right = *left + 1 + NextRnd() % (vMacScreenWidth - *left);
+}
+
+LOCALFUNC int Compare(char *name, void (*DoMap)(si4b top, si4b left,
+	si4b bottom, si4b right), ui3p Out1)
+{
+	/*
+		Out1 is drawn with the byte table, Out with DoMap,
+		both from the same start, and must end up the same.
+	*/
+	long f;
+	si4b top;
+	si4b left;
+	si4b bottom;
+	si4b right;
+	ui3p Out0 = Out;
+
+	memset(Out1, 0, OutSz);
+	memset(Out, 0, OutSz);
+	Rnd = 1; /* the same frames for each */
+	for (f = 0; f < kRandomFrames; ++f) {
+		RandomFrame(&top, &left, &bottom, &right);
+
+		Out = Out1;
+		MapByBytes(top, left, bottom, right);
+		Out = Out0;
+		DoMap(top, left, bottom, right);
+
+		if (0 != memcmp(Out1, Out, OutSz)) {
+			printf("%-8s differs from bytes at frame %ld"
+				" (%d, %d, %d, %d)\n", name, f,
+				top, left, bottom, right);
+			return 0;
+		}
+	}
+
+	printf("%-8s same as bytes over %d random frames\n",
+		name, kRandomFrames);
+	return 1;
+}
+
+#if HaveScrnMapV
+LOCALPROC UseKernel(ScrnMapV_RowP k)
+{
+	ScrnMapV_Row1to32x2 = k;
+	ScrnMapV_Selected = trueblnr;
+}
+#endif
+
+int main(int argc, char **argv)
+{
+	long n = (argc > 1) ? atol(argv[1]) : 200;
+	int warm = (argc > 2) && (0 == strcmp(argv[2], "warm"));
+	ui3p Out1;
+	ui3p flush;
+	long i;
+	int ok = 1;
+
+	if (n <= 0) {
+		fprintf(stderr, "usage: %s [redraws [warm]]\n", argv[0]);
+		return 2;
+	}
+
+	Screen = (ui3p)malloc(vMacScreenMonoNumBytes);
+	Out = (ui3p)calloc(1, OutSz);
+	Out1 = (ui3p)calloc(1, OutSz);
+	Tabl = (ui3p)malloc(256 * 8 * Scale * 4);
+	flush = (ui3p)calloc(1, FlushSz);
+	if ((NULL == Screen) || (NULL == Out) || (NULL == Out1)
+		|| (NULL == Tabl) || (NULL == flush))
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	/* something like a busy desktop, every byte value appears */
+	for (i = 0; i < vMacScreenMonoNumBytes; ++i) {
+		Screen[i] = NextRnd() & 0xFF;
+	}
+
+	Run("bytes", MapByBytes, n, warm, flush);
+#if HaveScrnMapV
+#if ScrnMapV_X86
+	__builtin_cpu_init();
+	UseKernel(ScrnMapV_Row1to32x2_SSE2);
+	Run("sse2", MapByV, n, warm, flush);
+	if (__builtin_cpu_supports("avx2")) {
+		UseKernel(ScrnMapV_Row1to32x2_AVX2);
+		Run("avx2", MapByV, n, warm, flush);
+	}
+#endif
+#if ScrnMapV_NEON
+	UseKernel(ScrnMapV_Row1to32x2_NEON);
+	Run("neon", MapByV, n, warm, flush);
+#endif
+#endif
+
+	ok &= Compare("at rect", MapByBytesAtRect, Out1);
+#if HaveScrnMapV
+#if ScrnMapV_X86
+	UseKernel(ScrnMapV_Row1to32x2_SSE2);
+	ok &= Compare("sse2", MapByV, Out1);
+	if (__builtin_cpu_supports("avx2")) {
+		UseKernel(ScrnMapV_Row1to32x2_AVX2);
+		ok &= Compare("avx2", MapByV, Out1);
+	}
+#endif
+#if ScrnMapV_NEON
+	UseKernel(ScrnMapV_Row1to32x2_NEON);
+	ok &= Compare("neon", MapByV, Out1);
+#endif
+#endif
+
+	return ok ? 0 : 1;
+}
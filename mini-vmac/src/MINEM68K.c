@@ -805,6 +805,9 @@ LOCALPROC m68k_go_MaxCycles(void)
 	ui4rr Cycles;
 	DecOpYR y;
 	func_pointer_t d;
+#if WantInstructionCount
+	ui5r n = 0;
+#endif
 
 	/*
 		Main loop of emulator.
@@ -836,11 +839,18 @@ LOCALPROC m68k_go_MaxCycles(void)
 #endif
 
 		d();
+#if WantInstructionCount
+		++n;
+#endif
 
 		DecodeNextInstruction(&d, &Cycles, &y);
 
 	} while (((si5rr)(V_MaxCyclesToGo -= Cycles)) > 0);
 
+#if WantInstructionCount
+	InstructionCount += n;
+#endif
+
 	/* abort instruction that have started to decode */
 
 	UnDecodeNextInstruction(Cycles);
@@ -8713,6 +8723,17 @@ GLOBALPROC SetCyclesRemaining(si5r n)
 	Em_Exit();
 }
 
+GLOBALFUNC ui3r GetInterruptMask(void)
+{
+	ui3r v;
+
+	Em_Enter();
+	v = V_regs.intmask;
+	Em_Exit();
+
+	return v;
+}
+
 GLOBALFUNC ATTep FindATTel(CPTR addr)
 {
 	ATTep v;
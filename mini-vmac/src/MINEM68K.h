@@ -33,6 +33,8 @@ EXPORTPROC m68k_reset(void);
 EXPORTFUNC si5r GetCyclesRemaining(void);
 EXPORTPROC SetCyclesRemaining(si5r n);
 
+EXPORTFUNC ui3r GetInterruptMask(void);
+
 EXPORTPROC m68k_go_nCycles(ui5b n);
 
 /*
@@ -0,0 +1,857 @@
+/*
+	MODPLAYR.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	MODule PLAYeR
+
+	Plays a ProTracker style MOD (4 to 8 channels, 31 samples, or
+	the older 15 sample kind) on the host, so that the emulated
+	Mac doesn't have to spend most of its time mixing one in 68k
+	code, as the PlayMOD XFCN does. It is driven from the
+	emulated machine through ExtnModPlayer_Access in ASCEMDEV.c,
+	which includes this file, and mixed into the output of the
+	ASC in ASC_SubTick, at the same 22255 Hz.
+
+	The module is copied on loading into ModPlayrBuff, reserved
+	at start up like the emulated RAM, so the guest can free its
+	copy at once, and a heap torn down while playing (such as
+	when HyperCard quits) doesn't change what is heard. Every
+	index taken from it is still checked, since the guest can
+	load anything.
+
+	Since all of this runs as part of the emulation, in emulated
+	time, what is played is the same each run, and doesn't upset
+	recording and replaying.
+
+	The usual effects are done: arpeggio, portamentos, vibrato,
+	tremolo, volume slides, sample offset, position jump, pattern
+	break and delay, loops, retrigger, note cut and delay, fine
+	tune, speed and tempo. Periods with fine tune and arpeggio
+	are worked out by multiplying rather than looked up as
+	ProTracker does, which can be off by one.
+*/
+
+#ifdef MODPLAYR_H
+#error "header already included"
+#else
+#define MODPLAYR_H
+#endif
+
+#define ModPlayrMaxChans 8
+#define ModPlayrRate 22255
+#define ModPlayrStepK 10444812
+	/*
+		3546895 (PAL Amiga clock) * 0x10000 / ModPlayrRate,
+		so this / period is the step per output sample in 16.16
+	*/
+#define ModPlayrMinPeriod 113
+#define ModPlayrMaxPeriod 856
+
+struct ModPlayrSampR {
+	ui3p Data; /* nullpr if empty */
+	ui5r Len;
+	ui5r LoopStart;
+	ui5r LoopLen; /* 0 if not looped */
+	ui3r FineTune; /* 0 to 15, 8 and up are negative */
+	ui3r Volume;
+};
+typedef struct ModPlayrSampR ModPlayrSampR;
+
+struct ModPlayrChanR {
+	ModPlayrSampR *Samp; /* playing */
+	ModPlayrSampR *NextSamp; /* for the next note */
+	ui5r Pos; /* in the sample */
+	ui5r PosFrac; /* and 0x10000ths */
+	ui5r Step; /* 16.16, 0 when silent */
+	ui5r End; /* where to loop or stop */
+	si4r Period;
+	si4r OutPeriod; /* with arpeggio or vibrato */
+	si4r PortaTarget;
+	si4r DelayPeriod;
+	si4r Volume;
+	si4r OutVolume; /* with tremolo */
+	ui3r FineTune;
+	ui3r Effect;
+	ui3r Param;
+	ui3r PortaSpeed;
+	ui3r VibratoCmd;
+	ui3r VibratoPos;
+	ui3r VibratoWave;
+	ui3r TremoloCmd;
+	ui3r TremoloPos;
+	ui3r TremoloWave;
+	ui3r OffsetCmd;
+	ui3r LoopRow;
+	ui3r LoopCount;
+};
+typedef struct ModPlayrChanR ModPlayrChanR;
+
+#ifndef kModPlayrMaxSz
+#define kModPlayrMaxSz 0x00100000
+	/* largest module that can be loaded */
+#endif
+
+LOCALVAR ui3p ModPlayrBuff = nullpr; /* kModPlayrMaxSz bytes */
+LOCALVAR ui3p ModPlayrData = nullpr; /* nullpr if none loaded */
+LOCALVAR ui3p ModPlayrOrders;
+LOCALVAR ui3p ModPlayrPatterns;
+LOCALVAR ui3r ModPlayrNumChans;
+LOCALVAR ui3r ModPlayrNumSamps;
+LOCALVAR ui3r ModPlayrSongLen;
+LOCALVAR ui3r ModPlayrRestart;
+LOCALVAR ui3r ModPlayrNumPatterns;
+LOCALVAR ModPlayrSampR ModPlayrSamps[31];
+LOCALVAR ModPlayrChanR ModPlayrChans[ModPlayrMaxChans];
+
+LOCALVAR blnr ModPlayrPlaying = falseblnr;
+LOCALVAR blnr ModPlayrLoop;
+LOCALVAR ui3r ModPlayrOrder;
+LOCALVAR ui3r ModPlayrRow;
+LOCALVAR ui4r ModPlayrTick;
+LOCALVAR ui3r ModPlayrSpeed;
+LOCALVAR ui3r ModPlayrTempo;
+LOCALVAR ui3r ModPlayrPatDelay;
+LOCALVAR blnr ModPlayrBreak;
+LOCALVAR ui3r ModPlayrBreakOrder;
+LOCALVAR ui3r ModPlayrBreakRow;
+LOCALVAR ui4r ModPlayrTickLeft; /* samples left in this tick */
+LOCALVAR ui4r ModPlayrTickFrac;
+LOCALVAR ui4r ModPlayrVolume = 256; /* 256 is full */
+
+/* 0x10000 * 2 ^ (- FineTune / 96), for FineTune -8 to 7 */
+LOCALVAR const ui5b ModPlayrFineMult[16] = {
+	65536, 65065, 64596, 64132, 63670, 63212, 62757, 62306,
+	69433, 68933, 68438, 67945, 67456, 66971, 66489, 66011
+};
+
+/* 0x10000 * 2 ^ (- n / 12), n semitones up */
+LOCALVAR const ui5b ModPlayrArpMult[16] = {
+	65536, 61858, 58386, 55109, 52016, 49097, 46341, 43740,
+	41285, 38968, 36781, 34716, 32768, 30929, 29193, 27554
+};
+
+LOCALVAR const ui3b ModPlayrSine[32] = {
+	0, 24, 49, 74, 97, 120, 141, 161,
+	180, 197, 212, 224, 235, 244, 250, 253,
+	255, 253, 250, 244, 235, 224, 212, 197,
+	180, 161, 141, 120, 97, 74, 49, 24
+};
+
+LOCALFUNC ui4r ModPlayrGet2(ui3p p)
+{
+	return ((ui4r)p[0] << 8) | p[1];
+}
+
+LOCALFUNC si4r ModPlayrWave(ui3r Wave, ui3r Pos)
+{
+	/* -255 to 255, Pos 0 to 63 */
+	si4r v;
+
+	switch (Wave & 3) {
+		case 1: /* ramp down */
+			v = 255 - (si4r)(Pos & 63) * 8;
+			if (v < -255) {
+				v = -255;
+			}
+			return v;
+		case 2: /* square */
+			v = 255;
+			break;
+		default: /* sine, random is taken as sine too */
+			v = ModPlayrSine[Pos & 31];
+			break;
+	}
+
+	return (0 != (Pos & 32)) ? - v : v;
+}
+
+LOCALPROC ModPlayrSetSamp(ModPlayrChanR *c, ModPlayrSampR *s)
+{
+	c->Samp = s;
+	c->Pos = 0;
+	c->PosFrac = 0;
+	if (nullpr == s) {
+		c->End = 0;
+	} else if (0 != s->LoopLen) {
+		c->End = s->LoopStart + s->LoopLen;
+	} else {
+		c->End = s->Len;
+	}
+}
+
+LOCALPROC ModPlayrTrigger(ModPlayrChanR *c, si4r Period)
+{
+	if (nullpr != c->NextSamp) {
+		ModPlayrSetSamp(c, c->NextSamp);
+	} else {
+		c->Pos = 0;
+		c->PosFrac = 0;
+	}
+	c->Period = Period;
+	c->OutPeriod = Period;
+	if (0 == (c->VibratoWave & 4)) {
+		c->VibratoPos = 0;
+	}
+	if (0 == (c->TremoloWave & 4)) {
+		c->TremoloPos = 0;
+	}
+}
+
+LOCALPROC ModPlayrSlideVolume(ModPlayrChanR *c, ui3r Param)
+{
+	if (0 != (Param >> 4)) {
+		c->Volume += Param >> 4;
+		if (c->Volume > 64) {
+			c->Volume = 64;
+		}
+	} else {
+		c->Volume -= Param & 0x0F;
+		if (c->Volume < 0) {
+			c->Volume = 0;
+		}
+	}
+}
+
+LOCALPROC ModPlayrTonePorta(ModPlayrChanR *c)
+{
+	if (0 == c->PortaTarget) {
+		return;
+	}
+	if (c->Period < c->PortaTarget) {
+		c->Period += c->PortaSpeed;
+		if (c->Period > c->PortaTarget) {
+			c->Period = c->PortaTarget;
+		}
+	} else if (c->Period > c->PortaTarget) {
+		c->Period -= c->PortaSpeed;
+		if (c->Period < c->PortaTarget) {
+			c->Period = c->PortaTarget;
+		}
+	}
+	c->OutPeriod = c->Period;
+}
+
+LOCALPROC ModPlayrVibrato(ModPlayrChanR *c)
+{
+	c->OutPeriod = c->Period
+		+ ((ModPlayrWave(c->VibratoWave, c->VibratoPos)
+			* (si4r)(c->VibratoCmd & 0x0F)) >> 7);
+	c->VibratoPos = (c->VibratoPos + (c->VibratoCmd >> 4)) & 63;
+}
+
+LOCALPROC ModPlayrTremolo(ModPlayrChanR *c)
+{
+	c->OutVolume = c->Volume
+		+ ((ModPlayrWave(c->TremoloWave, c->TremoloPos)
+			* (si4r)(c->TremoloCmd & 0x0F)) >> 6);
+	if (c->OutVolume < 0) {
+		c->OutVolume = 0;
+	} else if (c->OutVolume > 64) {
+		c->OutVolume = 64;
+	}
+	c->TremoloPos = (c->TremoloPos + (c->TremoloCmd >> 4)) & 63;
+}
+
+LOCALPROC ModPlayrRowEffect(ModPlayrChanR *c)
+{
+	/* effects done on the first tick of a row */
+	ui3r x = c->Param >> 4;
+	ui3r y = c->Param & 0x0F;
+
+	switch (c->Effect) {
+		case 0xB: /* position jump */
+			ModPlayrBreakOrder = c->Param;
+			ModPlayrBreakRow = 0;
+			ModPlayrBreak = trueblnr;
+			break;
+		case 0xC: /* set volume */
+			c->Volume = (c->Param > 64) ? 64 : c->Param;
+			c->OutVolume = c->Volume;
+			break;
+		case 0xD: /* pattern break, the row is in decimal */
+			if (! ModPlayrBreak) {
+				ModPlayrBreakOrder = ModPlayrOrder + 1;
+			}
+			ModPlayrBreakRow = x * 10 + y;
+			if (ModPlayrBreakRow >= 64) {
+				ModPlayrBreakRow = 0;
+			}
+			ModPlayrBreak = trueblnr;
+			break;
+		case 0xE:
+			switch (x) {
+				case 0x1: /* fine portamento up */
+					c->Period -= y;
+					if (c->Period < ModPlayrMinPeriod) {
+						c->Period = ModPlayrMinPeriod;
+					}
+					c->OutPeriod = c->Period;
+					break;
+				case 0x2: /* fine portamento down */
+					c->Period += y;
+					if (c->Period > ModPlayrMaxPeriod) {
+						c->Period = ModPlayrMaxPeriod;
+					}
+					c->OutPeriod = c->Period;
+					break;
+				case 0x4:
+					c->VibratoWave = y;
+					break;
+				case 0x6: /* pattern loop */
+					if (0 == y) {
+						c->LoopRow = ModPlayrRow;
+					} else {
+						if (0 == c->LoopCount) {
+							c->LoopCount = y;
+						} else {
+							--c->LoopCount;
+						}
+						if (0 != c->LoopCount) {
+							ModPlayrBreakOrder = ModPlayrOrder;
+							ModPlayrBreakRow = c->LoopRow;
+							ModPlayrBreak = trueblnr;
+						}
+					}
+					break;
+				case 0x7:
+					c->TremoloWave = y;
+					break;
+				case 0xA: /* fine volume slide up */
+					ModPlayrSlideVolume(c, y << 4);
+					c->OutVolume = c->Volume;
+					break;
+				case 0xB: /* fine volume slide down */
+					ModPlayrSlideVolume(c, y);
+					c->OutVolume = c->Volume;
+					break;
+				case 0xC: /* note cut */
+					if (0 == y) {
+						c->Volume = 0;
+						c->OutVolume = 0;
+					}
+					break;
+				case 0xE: /* pattern delay */
+					ModPlayrPatDelay = y;
+					break;
+			}
+			break;
+		case 0xF: /* set speed or tempo */
+			if (0 == c->Param) {
+				/* would stop ProTracker, ignore */
+			} else if (c->Param < 32) {
+				ModPlayrSpeed = c->Param;
+			} else {
+				ModPlayrTempo = c->Param;
+			}
+			break;
+	}
+}
+
+LOCALPROC ModPlayrTickEffect(ModPlayrChanR *c, ui4r Tick)
+{
+	/* effects done on every tick but the first of a row */
+	ui3r x = c->Param >> 4;
+	ui3r y = c->Param & 0x0F;
+
+	switch (c->Effect) {
+		case 0x0: /* arpeggio */
+			if (0 != c->Param) {
+				switch (Tick % 3) {
+					case 0:
+						c->OutPeriod = c->Period;
+						break;
+					case 1:
+						c->OutPeriod = (si4r)(((ui5r)c->Period
+							* ModPlayrArpMult[x]) >> 16);
+						break;
+					case 2:
+						c->OutPeriod = (si4r)(((ui5r)c->Period
+							* ModPlayrArpMult[y]) >> 16);
+						break;
+				}
+			}
+			break;
+		case 0x1: /* portamento up */
+			c->Period -= c->Param;
+			if (c->Period < ModPlayrMinPeriod) {
+				c->Period = ModPlayrMinPeriod;
+			}
+			c->OutPeriod = c->Period;
+			break;
+		case 0x2: /* portamento down */
+			c->Period += c->Param;
+			if (c->Period > ModPlayrMaxPeriod) {
+				c->Period = ModPlayrMaxPeriod;
+			}
+			c->OutPeriod = c->Period;
+			break;
+		case 0x3: /* tone portamento */
+			ModPlayrTonePorta(c);
+			break;
+		case 0x4:
+			ModPlayrVibrato(c);
+			break;
+		case 0x5:
+			ModPlayrTonePorta(c);
+			ModPlayrSlideVolume(c, c->Param);
+			c->OutVolume = c->Volume;
+			break;
+		case 0x6:
+			ModPlayrVibrato(c);
+			ModPlayrSlideVolume(c, c->Param);
+			c->OutVolume = c->Volume;
+			break;
+		case 0x7:
+			ModPlayrTremolo(c);
+			break;
+		case 0xA:
+			ModPlayrSlideVolume(c, c->Param);
+			c->OutVolume = c->Volume;
+			break;
+		case 0xE:
+			switch (x) {
+				case 0x9: /* retrigger */
+					if ((0 != y) && (0 == (Tick % y))) {
+						c->Pos = 0;
+						c->PosFrac = 0;
+					}
+					break;
+				case 0xC: /* note cut */
+					if (Tick == y) {
+						c->Volume = 0;
+						c->OutVolume = 0;
+					}
+					break;
+				case 0xD: /* note delay */
+					if ((Tick == y) && (0 != c->DelayPeriod)) {
+						ModPlayrTrigger(c, c->DelayPeriod);
+						c->DelayPeriod = 0;
+					}
+					break;
+			}
+			break;
+	}
+}
+
+LOCALPROC ModPlayrDoRow(void)
+{
+	int i;
+	ModPlayrChanR *c;
+	ui3p d;
+	ui3r s;
+	si4r Period;
+	ui3r pat = ModPlayrOrders[ModPlayrOrder];
+
+	if (pat >= ModPlayrNumPatterns) {
+		/* guest changed the module under us */
+		ModPlayrPlaying = falseblnr;
+		return;
+	}
+	d = ModPlayrPatterns
+		+ ((ui5r)pat * 64 + ModPlayrRow) * ModPlayrNumChans * 4;
+
+	for (i = 0; i < ModPlayrNumChans; ++i) {
+		c = &ModPlayrChans[i];
+		s = (d[0] & 0xF0) | (d[2] >> 4);
+		Period = ((si4r)(d[0] & 0x0F) << 8) | d[1];
+		c->Effect = d[2] & 0x0F;
+		c->Param = d[3];
+		d += 4;
+
+		c->OutPeriod = c->Period;
+		c->OutVolume = c->Volume;
+
+		if ((0 != s) && (s <= ModPlayrNumSamps)) {
+			c->NextSamp = &ModPlayrSamps[s - 1];
+			c->Volume = c->NextSamp->Volume;
+			c->OutVolume = c->Volume;
+			c->FineTune = c->NextSamp->FineTune;
+		}
+		if ((0xE == c->Effect) && (0x5 == (c->Param >> 4))) {
+			c->FineTune = c->Param & 0x0F;
+		}
+
+		switch (c->Effect) {
+			case 0x3:
+				if (0 != c->Param) {
+					c->PortaSpeed = c->Param;
+				}
+				break;
+			case 0x4:
+				if (0 != (c->Param >> 4)) {
+					c->VibratoCmd = (c->VibratoCmd & 0x0F)
+						| (c->Param & 0xF0);
+				}
+				if (0 != (c->Param & 0x0F)) {
+					c->VibratoCmd = (c->VibratoCmd & 0xF0)
+						| (c->Param & 0x0F);
+				}
+				break;
+			case 0x7:
+				if (0 != (c->Param >> 4)) {
+					c->TremoloCmd = (c->TremoloCmd & 0x0F)
+						| (c->Param & 0xF0);
+				}
+				if (0 != (c->Param & 0x0F)) {
+					c->TremoloCmd = (c->TremoloCmd & 0xF0)
+						| (c->Param & 0x0F);
+				}
+				break;
+			case 0x9:
+				if (0 != c->Param) {
+					c->OffsetCmd = c->Param;
+				}
+				break;
+		}
+
+		if (0 != Period) {
+			Period = (si4r)(((ui5r)Period
+				* ModPlayrFineMult[c->FineTune]) >> 16);
+			if ((0x3 == c->Effect) || (0x5 == c->Effect)) {
+				c->PortaTarget = Period;
+			} else if ((0xE == c->Effect)
+				&& (0xD == (c->Param >> 4))
+				&& (0 != (c->Param & 0x0F)))
+			{
+				c->DelayPeriod = Period;
+			} else {
+				ModPlayrTrigger(c, Period);
+				if (0x9 == c->Effect) {
+					c->Pos = (ui5r)c->OffsetCmd << 8;
+				}
+			}
+		}
+
+		ModPlayrRowEffect(c);
+	}
+}
+
+LOCALPROC ModPlayrNextRow(void)
+{
+	int i;
+
+	if (ModPlayrBreak) {
+		ModPlayrBreak = falseblnr;
+		if (ModPlayrBreakOrder != ModPlayrOrder) {
+			for (i = 0; i < ModPlayrNumChans; ++i) {
+				ModPlayrChans[i].LoopRow = 0;
+			}
+		}
+		ModPlayrOrder = ModPlayrBreakOrder;
+		ModPlayrRow = ModPlayrBreakRow;
+	} else if (++ModPlayrRow >= 64) {
+		ModPlayrRow = 0;
+		++ModPlayrOrder;
+		for (i = 0; i < ModPlayrNumChans; ++i) {
+			ModPlayrChans[i].LoopRow = 0;
+		}
+	}
+
+	if (ModPlayrOrder >= ModPlayrSongLen) {
+		if (! ModPlayrLoop) {
+			ModPlayrPlaying = falseblnr;
+		}
+		ModPlayrOrder = (ModPlayrRestart < ModPlayrSongLen)
+			? ModPlayrRestart : 0;
+	}
+}
+
+LOCALPROC ModPlayrDoTick(void)
+{
+	int i;
+	ModPlayrChanR *c;
+	si4r Period;
+
+	if (0 == ModPlayrTick) {
+		ModPlayrDoRow();
+	} else {
+		for (i = 0; i < ModPlayrNumChans; ++i) {
+			ModPlayrTickEffect(&ModPlayrChans[i],
+				ModPlayrTick % ModPlayrSpeed);
+		}
+	}
+
+	for (i = 0; i < ModPlayrNumChans; ++i) {
+		c = &ModPlayrChans[i];
+		Period = c->OutPeriod;
+		if ((nullpr == c->Samp) || (c->Pos >= c->End)) {
+			c->Step = 0;
+		} else {
+			if (Period < 14) {
+				Period = 14;
+			}
+			c->Step = ModPlayrStepK / (ui5r)Period;
+		}
+	}
+
+	/* 2.5 / Tempo seconds per tick */
+	ModPlayrTickFrac += ModPlayrRate * 5 % (2 * ModPlayrTempo);
+	ModPlayrTickLeft = ModPlayrRate * 5 / (2 * ModPlayrTempo)
+		+ ModPlayrTickFrac / (2 * ModPlayrTempo);
+	ModPlayrTickFrac %= 2 * ModPlayrTempo;
+
+	if (++ModPlayrTick >= (ui4r)ModPlayrSpeed * (1 + ModPlayrPatDelay))
+	{
+		ModPlayrTick = 0;
+		ModPlayrPatDelay = 0;
+		ModPlayrNextRow();
+	}
+}
+
+LOCALFUNC si5r ModPlayrChanSample(ModPlayrChanR *c)
+{
+	/* next sample of a channel, -0x8000 to 0x7FFF, times volume */
+	ModPlayrSampR *s = c->Samp;
+	ui5r i = c->Pos;
+	ui5r f = c->PosFrac >> 8;
+	si5r v0 = (si5r)(signed char)s->Data[i];
+	si5r v1;
+
+	if (i + 1 < c->End) {
+		v1 = (signed char)s->Data[i + 1];
+	} else if (0 != s->LoopLen) {
+		v1 = (signed char)s->Data[s->LoopStart];
+	} else {
+		v1 = 0;
+	}
+
+	c->PosFrac += c->Step;
+	c->Pos += c->PosFrac >> 16;
+	c->PosFrac &= 0xFFFF;
+	if (c->Pos >= c->End) {
+		if (0 != s->LoopLen) {
+			do {
+				c->Pos -= s->LoopLen;
+			} while (c->Pos >= c->End);
+		} else {
+			c->Step = 0;
+		}
+	}
+
+	return (v0 * 256 + (v1 - v0) * (si5r)f) * c->OutVolume >> 6;
+}
+
+LOCALPROC ModPlayr_Mix(tpSoundSamp p, ui4r n)
+{
+	/* add n samples of the module into p */
+	int i;
+	ModPlayrChanR *c;
+	si5r v;
+	ui4r k;
+
+	while (ModPlayrPlaying && (n > 0)) {
+		if (0 == ModPlayrTickLeft) {
+			ModPlayrDoTick();
+			continue;
+		}
+
+		k = (n < ModPlayrTickLeft) ? n : ModPlayrTickLeft;
+		n -= k;
+		ModPlayrTickLeft -= k;
+		for (; k > 0; --k) {
+			v = 0;
+			for (i = 0; i < ModPlayrNumChans; ++i) {
+				c = &ModPlayrChans[i];
+				if (0 != c->Step) {
+					v += ModPlayrChanSample(c);
+				}
+			}
+			v = v * (si5r)ModPlayrVolume / ModPlayrNumChans
+#if 3 == kLn2SoundSampSz
+				>> 16
+#else
+				>> 8
+#endif
+				;
+			v += *p;
+			if (v < 0) {
+				v = 0;
+			} else if (v > (si5r)(2 * kCenterSound - 1)) {
+				v = 2 * kCenterSound - 1;
+			}
+			*p++ = v;
+		}
+	}
+}
+
+LOCALPROC ModPlayr_Stop(void)
+{
+	ModPlayrPlaying = falseblnr;
+}
+
+LOCALFUNC blnr ModPlayr_Play(ui3r Order, blnr Loop)
+{
+	int i;
+	ModPlayrChanR *c;
+
+	if ((nullpr == ModPlayrData) || (Order >= ModPlayrSongLen)) {
+		return falseblnr;
+	}
+
+	for (i = 0; i < ModPlayrMaxChans; ++i) {
+		c = &ModPlayrChans[i];
+		c->Samp = nullpr;
+		c->NextSamp = nullpr;
+		c->Step = 0;
+		c->End = 0;
+		c->Period = 0;
+		c->OutPeriod = 0;
+		c->PortaTarget = 0;
+		c->DelayPeriod = 0;
+		c->Volume = 0;
+		c->OutVolume = 0;
+		c->FineTune = 0;
+		c->PortaSpeed = 0;
+		c->VibratoCmd = 0;
+		c->VibratoPos = 0;
+		c->VibratoWave = 0;
+		c->TremoloCmd = 0;
+		c->TremoloPos = 0;
+		c->TremoloWave = 0;
+		c->OffsetCmd = 0;
+		c->LoopRow = 0;
+		c->LoopCount = 0;
+	}
+
+	ModPlayrOrder = Order;
+	ModPlayrRow = 0;
+	ModPlayrTick = 0;
+	ModPlayrSpeed = 6;
+	ModPlayrTempo = 125;
+	ModPlayrPatDelay = 0;
+	ModPlayrBreak = falseblnr;
+	ModPlayrTickLeft = 0;
+	ModPlayrTickFrac = 0;
+	ModPlayrLoop = Loop;
+	ModPlayrPlaying = trueblnr;
+
+	return trueblnr;
+}
+
+LOCALFUNC blnr ModPlayrSig(ui3p p, char *s)
+{
+	return (p[0] == s[0]) && (p[1] == s[1])
+		&& (p[2] == s[2]) && (p[3] == s[3]);
+}
+
+LOCALFUNC tMacErr ModPlayr_Load(ui3p p, ui5r n)
+{
+	/* p is n bytes of the module, in ModPlayrBuff */
+	ui5r i;
+	ui5r SampOff;
+	ui5r HeaderSz;
+	ui3p s;
+	ui3p sig;
+	ModPlayrSampR *m;
+	ui3r NumChans = 4;
+	ui3r NumSamps = 31;
+
+	ModPlayr_Stop();
+	ModPlayrData = nullpr;
+
+	if (n < 1084) {
+		if (n < 600) {
+			return mnvm_eofErr;
+		}
+		NumSamps = 15;
+	} else {
+		sig = p + 1080;
+		if (ModPlayrSig(sig, "M.K.") || ModPlayrSig(sig, "M!K!")
+			|| ModPlayrSig(sig, "FLT4") || ModPlayrSig(sig, "4CHN"))
+		{
+			/* NumChans = 4 */
+		} else if (ModPlayrSig(sig, "6CHN")) {
+			NumChans = 6;
+		} else if (ModPlayrSig(sig, "8CHN") || ModPlayrSig(sig, "FLT8")
+			|| ModPlayrSig(sig, "OCTA") || ModPlayrSig(sig, "CD81"))
+		{
+			NumChans = 8;
+		} else if ((sig[1] == 'C') && (sig[2] == 'H')
+			&& (sig[3] == 'N') && (sig[0] >= '1') && (sig[0] <= '8'))
+		{
+			NumChans = sig[0] - '0';
+		} else if ((sig[2] == 'C') && (sig[3] == 'H')
+			&& (sig[0] == '0') && (sig[1] >= '1') && (sig[1] <= '8'))
+		{
+			NumChans = sig[1] - '0';
+		} else {
+			/* no signature, take it as the old 15 sample kind */
+			NumSamps = 15;
+		}
+	}
+
+	s = p + 20 + NumSamps * 30;
+	ModPlayrSongLen = s[0];
+	ModPlayrRestart = s[1];
+	ModPlayrOrders = s + 2;
+	HeaderSz = 20 + NumSamps * 30 + 2 + 128 + ((31 == NumSamps) ? 4 : 0);
+	if ((0 == ModPlayrSongLen) || (ModPlayrSongLen > 128)) {
+		return mnvm_paramErr;
+	}
+
+	ModPlayrNumPatterns = 0;
+	for (i = 0; i < 128; ++i) {
+		if (ModPlayrOrders[i] >= ModPlayrNumPatterns) {
+			ModPlayrNumPatterns = ModPlayrOrders[i] + 1;
+		}
+	}
+	if (0 == ModPlayrNumPatterns) {
+		ModPlayrNumPatterns = 1;
+	}
+
+	SampOff = HeaderSz + (ui5r)ModPlayrNumPatterns * 64 * NumChans * 4;
+	if (SampOff > n) {
+		return mnvm_eofErr;
+	}
+
+	for (i = 0; i < NumSamps; ++i) {
+		s = p + 20 + i * 30;
+		m = &ModPlayrSamps[i];
+		m->Len = (ui5r)ModPlayrGet2(s + 22) * 2;
+		m->FineTune = s[24] & 0x0F;
+		m->Volume = (s[25] > 64) ? 64 : s[25];
+		m->LoopStart = (ui5r)ModPlayrGet2(s + 26) * 2;
+		m->LoopLen = (ui5r)ModPlayrGet2(s + 28) * 2;
+
+		if (SampOff + m->Len > n) {
+			/* truncated module, play what is there */
+			m->Len = n - SampOff;
+		}
+		if (m->LoopLen <= 2) {
+			m->LoopLen = 0;
+		} else if (m->LoopStart >= m->Len) {
+			m->LoopLen = 0;
+		} else if (m->LoopStart + m->LoopLen > m->Len) {
+			m->LoopLen = m->Len - m->LoopStart;
+		}
+		m->Data = (0 == m->Len) ? nullpr : p + SampOff;
+		SampOff += m->Len;
+	}
+
+	ModPlayrNumChans = NumChans;
+	ModPlayrNumSamps = NumSamps;
+	ModPlayrPatterns = p + HeaderSz;
+	ModPlayrData = p;
+
+	return mnvm_noErr;
+}
+
+LOCALPROC ModPlayr_Unload(void)
+{
+	ModPlayr_Stop();
+	ModPlayrData = nullpr;
+	ModPlayrVolume = 256;
+}
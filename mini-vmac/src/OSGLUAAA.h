@@ -82,6 +82,8 @@ EXPORTVAR(ui3p, ROM)
 	/* (ui4b) - 18 - Driver can't respond to Status call */
 #define mnvm_closErr    ((tMacErr) 0xFFE8)
 	/* (ui4b) - 24 - I/O System Errors */
+#define mnvm_ioErr      ((tMacErr) 0xFFDC)
+	/* (ui4b) - 36 - I/O error */
 #define mnvm_eofErr     ((tMacErr) 0xFFD9)
 	/* (ui4b) - 39 - End of file */
 #define mnvm_tmfoErr    ((tMacErr) 0xFFD6)
@@ -162,6 +164,26 @@ EXPORTVAR(tPbuf, vSonyNewDiskName)
 EXPORTOSGLUFUNC tMacErr vSonyGetName(tDrive Drive_No, tPbuf *r);
 #endif
 
+#ifndef IncludeSonyAsync
+#define IncludeSonyAsync 0
+#endif
+
+#if IncludeSonyAsync
+EXPORTOSGLUFUNC blnr vSonyTransferStart(blnr IsWrite, ui3p Buffer,
+	tDrive Drive_No, ui5r Sony_Start, ui5r Sony_Count);
+	/*
+		Hand a transfer to the OSGLU to do while the emulation goes
+		on. If false, it wasn't taken, and should be done with
+		vSonyTransfer. Only one at a time.
+	*/
+EXPORTOSGLUFUNC blnr vSonyTransferDone(blnr Wait,
+	tMacErr *r, ui5r *Sony_ActCount);
+	/*
+		If the transfer vSonyTransferStart took is finished (or
+		Wait, once it is), its result, and true.
+	*/
+#endif
+
 #if IncludeHostTextClipExchange
 EXPORTOSGLUFUNC tMacErr HTCEexport(tPbuf i);
 EXPORTOSGLUFUNC tMacErr HTCEimport(tPbuf *r);
@@ -221,6 +243,68 @@ EXPORTVAR(blnr, WantMacReset)
 
 EXPORTOSGLUFUNC blnr ExtraTimeNotOver(void);
 
+#ifndef WantInstructionCount
+#define WantInstructionCount 0
+#endif
+
+#if WantInstructionCount
+EXPORTVAR(ui5r, InstructionCount)
+	/*
+		incremented for each emulated instruction,
+		the OSGLU should collect it often enough that
+		it doesn't wrap around.
+	*/
+#endif
+
+#ifndef WantLagStats
+#define WantLagStats 0
+#endif
+
+#if WantLagStats
+#define kLagStatHistSz 16
+
+EXPORTVAR(ui5r, LagStatHist[kLagStatHistSz])
+	/*
+		number of ticks that ended with EmLagTime
+		equal to the index, the last entry counting
+		anything larger.
+	*/
+EXPORTVAR(ui5r, LagStatCatchUp)
+	/* number of extra ticks emulated to catch up */
+EXPORTVAR(ui5r, LagStatDropped)
+	/* number of ticks given up on */
+#endif
+
+#ifndef WantSliceStats
+#define WantSliceStats 0
+#endif
+
+#if WantSliceStats
+EXPORTVAR(ui5r, SliceStatCount)
+	/*
+		incremented each time the cpu emulation is
+		entered, that is, once per slice between
+		interrupt checks.
+	*/
+EXPORTVAR(ui5r, SliceStatCycles)
+	/*
+		cycles emulated in those slices. the OSGLU
+		should collect both every tick.
+	*/
+#endif
+
+#ifndef WantSoundSubTick
+#define WantSoundSubTick 0
+#endif
+
+#if WantSoundSubTick
+EXPORTVAR(ui3b, SoundSubTick)
+	/*
+		the sub tick the sound emulation is making
+		samples for, when it calls MySound_BeginWrite.
+	*/
+#endif
+
 EXPORTVAR(ui3b, SpeedValue)
 
 #if EnableAutoSlow
@@ -258,12 +342,26 @@ EXPORTVAR(ui5r, QuietSubTicks)
 #error "unsupported kLn2SoundSampSz"
 #endif
 
+#ifndef WantSoundAutoSlow
+#define WantSoundAutoSlow 0
+#endif
+
 #if MySoundEnabled
 
 EXPORTOSGLUFUNC tpSoundSamp MySound_BeginWrite(ui4r n, ui4r *actL);
 EXPORTOSGLUPROC MySound_EndWrite(ui4r actL);
 
 /* 370 samples per tick = 22,254.54 per second */
+
+#if WantSoundAutoSlow
+EXPORTOSGLUFUNC ui5r MySound_Wanted(void);
+	/*
+		how many samples the host sound buffer is short
+		of the level it tries to keep, so AutoSlow can
+		run just fast enough to make them.
+	*/
+#endif
+
 #endif
 
 #if EmLocalTalk
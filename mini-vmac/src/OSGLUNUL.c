@@ -0,0 +1,1128 @@
+/*
+	OSGLUNUL.c
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	Operating System GLUe for NULl display
+
+	No window, no keyboard or mouse, and sound only to a file.
+	Boots the ROM and disk images, runs a given number of
+	emulated seconds as fast as the host allows, then prints
+	how fast that was and a hash of the final screen. Meant
+	for measuring the emulator on machines without a display.
+
+	Every call to WaitForNextTick advances the emulated clock
+	by exactly one tick, and the date starts at a fixed value,
+	so two runs of the same build do the same thing. Disk
+	images are read into memory, and writes to them are not
+	saved, so runs don't change the images either.
+
+	Input can come from a recording made with the --record
+	option of another build (see EVTRPLAY.h).
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "OSGCOMUI.h"
+#include "OSGCOMUD.h"
+
+#ifdef WantOSGLUNUL
+
+/* --- some simple utilities --- */
+
+GLOBALOSGLUPROC MyMoveBytes(anyp srcPtr, anyp destPtr, si5b byteCount)
+{
+	(void) memcpy((char *)destPtr, (char *)srcPtr, byteCount);
+}
+
+/* --- control mode and internationalization --- */
+
+#define NeedCell2PlainAsciiMap 1
+
+#include "INTLCHAR.h"
+
+
+LOCALVAR char *d_arg = NULL;
+
+LOCALFUNC tMacErr ChildPath(char *x, char *y, char **r)
+{
+	tMacErr err = mnvm_miscErr;
+	int nx = strlen(x);
+	int ny = strlen(y);
+	{
+		if ((nx > 0) && ('/' == x[nx - 1])) {
+			--nx;
+		}
+		{
+			int nr = nx + 1 + ny;
+			char *p = malloc(nr + 1);
+			if (p != NULL) {
+				char *p2 = p;
+				(void) memcpy(p2, x, nx);
+				p2 += nx;
+				*p2++ = '/';
+				(void) memcpy(p2, y, ny);
+				p2 += ny;
+				*p2 = 0;
+				*r = p;
+				err = mnvm_noErr;
+			}
+		}
+	}
+
+	return err;
+}
+
+LOCALPROC MyMayFree(char *p)
+{
+	if (NULL != p) {
+		free(p);
+	}
+}
+
+/* --- sending debugging info to file --- */
+
+#if dbglog_HAVE
+
+LOCALFUNC blnr dbglog_open0(void)
+{
+	return trueblnr;
+}
+
+LOCALPROC dbglog_write0(char *s, uimr L)
+{
+	(void) fwrite(s, 1, L, stderr);
+}
+
+LOCALPROC dbglog_close0(void)
+{
+}
+
+#endif
+
+#include "COMOSGLU.h"
+
+#include "PBUFSTDC.h"
+
+#include "CONTROLM.h"
+
+/* --- text translation --- */
+
+#if IncludePbufs
+LOCALFUNC tMacErr NativeTextToMacRomanPbuf(char *x, tPbuf *r)
+{
+	/*
+		only used for names of disk images, and the clipboard,
+		which stays inside the emulation. so plain ascii is
+		enough.
+	*/
+	if (NULL == x) {
+		return mnvm_miscErr;
+	} else {
+		ui3p p;
+		ui5b L = strlen(x);
+
+		p = (ui3p)malloc(L);
+		if (NULL == p) {
+			return mnvm_miscErr;
+		} else {
+			ui3b *p0 = (ui3b *)x;
+			ui3b *p1 = (ui3b *)p;
+			int i;
+
+			for (i = L; --i >= 0; ) {
+				ui3b v = *p0++;
+				if (10 == v) {
+					v = 13;
+				}
+				*p1++ = v;
+			}
+
+			return PbufNewFromPtr(p, L, r);
+		}
+	}
+}
+#endif
+
+LOCALPROC NativeStrFromCStr(char *r, char *s)
+{
+	ui3b ps[ClStrMaxLength];
+	int i;
+	int L;
+
+	ClStrFromSubstCStr(&L, ps, s);
+
+	for (i = 0; i < L; ++i) {
+		r[i] = Cell2PlainAsciiMap[ps[i]];
+	}
+
+	r[L] = 0;
+}
+
+/* --- statistics --- */
+
+LOCALVAR ui5r StatTicks = 0;
+LOCALVAR unsigned long long StatInstructions = 0;
+LOCALVAR unsigned long long StatSoundSamples = 0;
+LOCALVAR unsigned long long StatDiskRead = 0;
+LOCALVAR unsigned long long StatDiskWritten = 0;
+LOCALVAR ui5r StatFrames = 0;
+LOCALVAR ui5r StatDamageRects = 0;
+LOCALVAR unsigned long long StatDamagePixels = 0;
+LOCALVAR unsigned long long StatBoxPixels = 0;
+#if WantSliceStats
+LOCALVAR unsigned long long StatSlices = 0;
+LOCALVAR unsigned long long StatSliceCycles = 0;
+#endif
+
+/* --- drives --- */
+
+LOCALVAR ui3p Drives[NumDrives]; /* disk images, in memory */
+LOCALVAR ui5r DriveSizes[NumDrives];
+LOCALVAR char *DriveNames[NumDrives];
+
+LOCALPROC InitDrives(void)
+{
+	tDrive i;
+
+	for (i = 0; i < NumDrives; ++i) {
+		Drives[i] = NULL;
+		DriveNames[i] = NULL;
+	}
+}
+
+GLOBALOSGLUFUNC tMacErr vSonyTransfer(blnr IsWrite, ui3p Buffer,
+	tDrive Drive_No, ui5r Sony_Start, ui5r Sony_Count,
+	ui5r *Sony_ActCount)
+{
+	tMacErr err = mnvm_miscErr;
+	ui5r L = DriveSizes[Drive_No];
+	ui5r NewSony_Count = 0;
+
+	if (Sony_Start <= L) {
+		NewSony_Count = L - Sony_Start;
+		if (NewSony_Count > Sony_Count) {
+			NewSony_Count = Sony_Count;
+		}
+		if (IsWrite) {
+			MyMoveBytes((anyp)Buffer,
+				(anyp)(Drives[Drive_No] + Sony_Start), NewSony_Count);
+			StatDiskWritten += NewSony_Count;
+		} else {
+			MyMoveBytes((anyp)(Drives[Drive_No] + Sony_Start),
+				(anyp)Buffer, NewSony_Count);
+			StatDiskRead += NewSony_Count;
+		}
+
+		if (NewSony_Count == Sony_Count) {
+			err = mnvm_noErr;
+		}
+	}
+
+	if (nullpr != Sony_ActCount) {
+		*Sony_ActCount = NewSony_Count;
+	}
+
+	return err;
+}
+
+GLOBALOSGLUFUNC tMacErr vSonyGetSize(tDrive Drive_No, ui5r *Sony_Count)
+{
+	*Sony_Count = DriveSizes[Drive_No];
+
+	return mnvm_noErr;
+}
+
+LOCALFUNC tMacErr vSonyEject0(tDrive Drive_No)
+{
+	DiskEjectedNotify(Drive_No);
+
+	free(Drives[Drive_No]);
+	Drives[Drive_No] = NULL;
+	MyMayFree(DriveNames[Drive_No]);
+	DriveNames[Drive_No] = NULL;
+
+	return mnvm_noErr;
+}
+
+GLOBALOSGLUFUNC tMacErr vSonyEject(tDrive Drive_No)
+{
+	return vSonyEject0(Drive_No);
+}
+
+#if IncludeSonyNew
+GLOBALOSGLUFUNC tMacErr vSonyEjectDelete(tDrive Drive_No)
+{
+	/* never was a file, so nothing more to delete */
+	return vSonyEject0(Drive_No);
+}
+#endif
+
+LOCALPROC UnInitDrives(void)
+{
+	tDrive i;
+
+	for (i = 0; i < NumDrives; ++i) {
+		if (vSonyIsInserted(i)) {
+			(void) vSonyEject(i);
+		}
+	}
+}
+
+#if IncludeSonyGetName
+GLOBALOSGLUFUNC tMacErr vSonyGetName(tDrive Drive_No, tPbuf *r)
+{
+	char *drivepath = DriveNames[Drive_No];
+	if (NULL == drivepath) {
+		return mnvm_miscErr;
+	} else {
+		char *s = strrchr(drivepath, '/');
+		if (NULL == s) {
+			s = drivepath;
+		} else {
+			++s;
+		}
+		return NativeTextToMacRomanPbuf(s, r);
+	}
+}
+#endif
+
+LOCALFUNC blnr Sony_Insert0(ui3p p, ui5r L, char *drivepath)
+{
+	tDrive Drive_No;
+
+	if (! FirstFreeDisk(&Drive_No)) {
+		fprintf(stderr, "too many disk images\n");
+		free(p);
+		return falseblnr;
+	} else {
+		Drives[Drive_No] = p;
+		DriveSizes[Drive_No] = L;
+		if (NULL != drivepath) {
+			ui5b n = strlen(drivepath);
+			char *s = malloc(n + 1);
+			if (s != NULL) {
+				(void) memcpy(s, drivepath, n + 1);
+			}
+			DriveNames[Drive_No] = s;
+		}
+		DiskInsertNotify(Drive_No, falseblnr);
+
+		return trueblnr;
+	}
+}
+
+LOCALFUNC blnr Sony_Insert1(char *drivepath, blnr silentfail)
+{
+	blnr IsOk = falseblnr;
+	FILE *refnum = fopen(drivepath, "rb");
+
+	if (NULL == refnum) {
+		if (! silentfail) {
+			fprintf(stderr, "Couldn't open %s\n", drivepath);
+		}
+	} else {
+		long L;
+		ui3p p;
+
+		if ((0 == fseek(refnum, 0, SEEK_END))
+			&& ((L = ftell(refnum)) >= 0)
+			&& (0 == fseek(refnum, 0, SEEK_SET))
+			&& (NULL != (p = (ui3p)malloc(L))))
+		{
+			if (L != (long)fread(p, 1, L, refnum)) {
+				fprintf(stderr, "Couldn't read %s\n", drivepath);
+				free(p);
+			} else {
+				IsOk = Sony_Insert0(p, L, drivepath);
+			}
+		}
+		fclose(refnum);
+	}
+
+	return IsOk;
+}
+
+#if EnableEvtReplay
+#include "EVTRPLAY.h"
+#define Sony_Insert1h EvtRply_Sony_Insert1
+#else
+#define Sony_Insert1h Sony_Insert1
+#endif
+
+#if UseScrnCapt || UseSndCapt
+#include "CAPTWRTR.h"
+#endif
+
+#if UseScrnCapt
+#include "SCRNCAPT.h"
+#endif
+
+#if UseScrnVrfy
+#include "SCRNVRFY.h"
+#endif
+
+LOCALFUNC blnr Sony_Insert2(char *s)
+{
+	blnr IsOk = falseblnr;
+
+	if (NULL == d_arg) {
+		IsOk = Sony_Insert1h(s, trueblnr);
+	} else {
+		char *t;
+
+		if (mnvm_noErr == ChildPath(d_arg, s, &t)) {
+			IsOk = Sony_Insert1h(t, trueblnr);
+			free(t);
+		}
+	}
+
+	return IsOk;
+}
+
+LOCALFUNC blnr LoadInitialImages(void)
+{
+	if (! AnyDiskInserted()) {
+		if (! Sony_Insert2("BlahBlob.dsk")) {
+			fprintf(stderr, "Couldn't find BlahBlob.dsk\n");
+			return falseblnr;
+		}
+
+		if (! Sony_Insert2("BlahBlobData.dsk")) {
+			fprintf(stderr, "Couldn't find BlahBlobData.dsk\n");
+			return falseblnr;
+		}
+	}
+
+	return trueblnr;
+}
+
+#if IncludeSonyNew
+LOCALPROC MakeNewDisk(ui5b L, char *drivename)
+{
+	ui3p p = (ui3p)calloc(1, L);
+
+	if (NULL != p) {
+		(void) Sony_Insert0(p, L, drivename);
+	}
+}
+#endif
+
+/* --- ROM --- */
+
+LOCALVAR char *rom_path = NULL;
+
+LOCALFUNC tMacErr LoadMacRomFrom(char *path)
+{
+	tMacErr err;
+	FILE *ROM_File;
+	int File_Size;
+
+	ROM_File = fopen(path, "rb");
+	if (NULL == ROM_File) {
+		err = mnvm_fnfErr;
+	} else {
+		File_Size = fread(ROM, 1, kROM_Size, ROM_File);
+		if (kROM_Size != File_Size) {
+			fprintf(stderr, "Couldn't read all of %s\n", path);
+			err = mnvm_eofErr;
+		} else {
+			err = ROM_IsValid();
+		}
+		fclose(ROM_File);
+	}
+
+	return err;
+}
+
+LOCALFUNC blnr LoadMacRom(void)
+{
+	tMacErr err;
+	char *t = NULL;
+
+	if (NULL != rom_path) {
+		err = LoadMacRomFrom(rom_path);
+	} else if (NULL == d_arg) {
+		err = LoadMacRomFrom(RomFileName);
+	} else {
+		if (mnvm_noErr == (err = ChildPath(d_arg, RomFileName, &t)))
+		{
+			err = LoadMacRomFrom(t);
+		}
+		MyMayFree(t);
+	}
+
+	if (mnvm_noErr != err) {
+		fprintf(stderr, "Couldn't load the ROM\n");
+		return falseblnr;
+	}
+
+	return trueblnr;
+}
+
+/* --- video out --- */
+
+GLOBALOSGLUPROC DoneWithDrawingForTick(void)
+{
+	/*
+		Screen_OutputFrame already kept screencomparebuff
+		up to date, nothing to draw it on. Just count the
+		frames other OSGLUs would have drawn.
+	*/
+	int i;
+
+	if ((ScreenChangedTop < ScreenChangedBottom)
+		&& (ScreenChangedLeft < ScreenChangedRight))
+	{
+		++StatFrames;
+		StatBoxPixels += (ui5r)(ScreenChangedBottom - ScreenChangedTop)
+			* (ui5r)(ScreenChangedRight - ScreenChangedLeft);
+		for (i = 0; i < ScreenDamageN; ++i) {
+			StatDamagePixels += ScrnRectArea(&ScreenDamage[i]);
+		}
+		StatDamageRects += ScreenDamageN;
+	}
+	ScreenClearChanges();
+}
+
+/* --- time, date, location --- */
+
+#include "DATE2SEC.h"
+
+LOCALVAR ui5b TrueEmulatedTime = 0;
+
+LOCALVAR ui5r TicksToRun = 60 * 60;
+LOCALVAR ui5r NextDateTick;
+
+#define TicksPerEmSecond 60
+
+LOCALVAR struct timeval StartTime;
+
+LOCALFUNC blnr InitLocationDat(void)
+{
+	/*
+		Always the same date, so the screen comes out
+		the same in every run.
+	*/
+	CurMacDateInSeconds = Date2MacSeconds(0, 0, 12, 1, 1, 2000);
+	NextDateTick = TicksPerEmSecond;
+
+	return trueblnr;
+}
+
+LOCALPROC CheckDateTime(void)
+{
+	if (TrueEmulatedTime == NextDateTick) {
+		++CurMacDateInSeconds;
+		NextDateTick += TicksPerEmSecond;
+	}
+}
+
+/* --- sound --- */
+
+#if MySoundEnabled
+
+#define kLnOneBuffLen 9
+#define kOneBuffLen (1UL << kLnOneBuffLen)
+
+#define SOUND_SAMPLERATE 22255 /* = round(7833600 * 2 / 704) */
+
+LOCALVAR tbSoundSamp TheSoundBuffer[kOneBuffLen];
+
+/*
+	With --sound-file, every sample goes to a file, as a WAV file
+	if the name ends with ".wav", otherwise raw. Emulated time is
+	all there is here, so the file takes them at the emulated
+	rate, however fast that runs.
+*/
+
+#include "SNDWAVFL.h"
+
+#if UseSndCapt
+#include "SNDCAPT.h"
+#endif
+
+LOCALVAR char *MySoundFilePath = NULL;
+LOCALVAR FILE *MySoundFile = NULL;
+LOCALVAR blnr MySoundFileIsWav;
+LOCALVAR blnr MySoundFileOk;
+
+GLOBALOSGLUFUNC tpSoundSamp MySound_BeginWrite(ui4r n, ui4r *actL)
+{
+	if (n > kOneBuffLen) {
+		n = kOneBuffLen;
+	}
+
+	*actL = n;
+	return TheSoundBuffer;
+}
+
+GLOBALOSGLUPROC MySound_EndWrite(ui4r actL)
+{
+#if 4 == kLn2SoundSampSz
+	ui4r i;
+#endif
+
+#if UseSndCapt
+	SndCapt_Samples(TheSoundBuffer, actL);
+#endif
+
+	if (NULL != MySoundFile) {
+#if 4 == kLn2SoundSampSz
+		for (i = 0; i < actL; ++i) {
+			TheSoundBuffer[i] -= 0x8000; /* to signed */
+		}
+#endif
+		if (actL != fwrite(TheSoundBuffer, sizeof(tbSoundSamp), actL,
+			MySoundFile))
+		{
+			MySoundFileOk = falseblnr;
+		}
+	}
+
+	StatSoundSamples += actL;
+}
+
+LOCALFUNC blnr MySound_Init(void)
+{
+	if (NULL != MySoundFilePath) {
+		MySoundFile = fopen(MySoundFilePath, "wb");
+		if (NULL == MySoundFile) {
+			fprintf(stderr, "Couldn't create %s\n", MySoundFilePath);
+			return falseblnr;
+		}
+		MySoundFileIsWav = WavFl_IsWavPath(MySoundFilePath);
+		MySoundFileOk = (! MySoundFileIsWav)
+			|| WavFl_Header(MySoundFile, SOUND_SAMPLERATE,
+				1 << kLn2SoundSampSz, 0);
+	}
+
+	return trueblnr;
+}
+
+LOCALPROC MySound_UnInit(void)
+{
+	if (NULL != MySoundFile) {
+		if (MySoundFileIsWav && ! WavFl_Finish(MySoundFile,
+			SOUND_SAMPLERATE, 1 << kLn2SoundSampSz,
+			StatSoundSamples * sizeof(tbSoundSamp)))
+		{
+			MySoundFileOk = falseblnr;
+		}
+		if ((0 != fclose(MySoundFile)) || ! MySoundFileOk) {
+			fprintf(stderr, "Couldn't write %s\n", MySoundFilePath);
+		}
+		MySoundFile = NULL;
+	}
+}
+
+#endif
+
+/* --- basic dialogs --- */
+
+LOCALPROC CheckSavedMacMsg(void)
+{
+	if (nullpr != SavedBriefMsg) {
+		char briefMsg0[ClStrMaxLength + 1];
+		char longMsg0[ClStrMaxLength + 1];
+
+		NativeStrFromCStr(briefMsg0, SavedBriefMsg);
+		NativeStrFromCStr(longMsg0, SavedLongMsg);
+
+		fprintf(stderr, "%s\n", briefMsg0);
+		fprintf(stderr, "%s\n", longMsg0);
+
+		SavedBriefMsg = nullpr;
+	}
+}
+
+/* --- clipboard --- */
+
+#if IncludeHostTextClipExchange
+LOCALVAR tPbuf MyClipPbuf = NotAPbuf;
+	/* text exported by the emulated machine */
+#endif
+
+#if IncludeHostTextClipExchange
+GLOBALOSGLUFUNC tMacErr HTCEexport(tPbuf i)
+{
+	if (NotAPbuf != MyClipPbuf) {
+		PbufDispose(MyClipPbuf);
+	}
+	MyClipPbuf = i;
+
+	return mnvm_noErr;
+}
+#endif
+
+#if IncludeHostTextClipExchange
+GLOBALOSGLUFUNC tMacErr HTCEimport(tPbuf *r)
+{
+	tMacErr err;
+	ui3p s = NULL;
+
+	if (NotAPbuf != MyClipPbuf) {
+		ui5r L = PbufSize[MyClipPbuf];
+
+		s = (ui3p)malloc(L + 1);
+		if (NULL != s) {
+			PbufTransfer(s, MyClipPbuf, 0, L, falseblnr);
+			s[L] = 0;
+		}
+	}
+
+#if EnableEvtReplay
+	EvtRply_ClipImport(&s);
+#endif
+
+	err = NativeTextToMacRomanPbuf((char *)s, r);
+	MyMayFree((char *)s);
+
+	return err;
+}
+#endif
+
+/* --- command line parsing --- */
+
+LOCALVAR int my_argc;
+LOCALVAR char **my_argv;
+
+LOCALFUNC blnr ScanCommandLine(void)
+{
+	char *pa;
+	int i = 1;
+
+label_retry:
+	if (i < my_argc) {
+		pa = my_argv[i++];
+		if ('-' == pa[0]) {
+			if ((0 == strcmp(pa, "--rom"))
+				|| (0 == strcmp(pa, "-r")))
+			{
+				if (i < my_argc) {
+					rom_path = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "-d"))
+			{
+				if (i < my_argc) {
+					d_arg = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+			if ((0 == strcmp(pa, "--seconds"))
+				|| (0 == strcmp(pa, "-s")))
+			{
+				if (i < my_argc) {
+					TicksToRun = TicksPerEmSecond
+						* (ui5r)strtoul(my_argv[i++], NULL, 10);
+					goto label_retry;
+				}
+			} else
+#if EnableEvtReplay
+			if (0 == strcmp(pa, "--record"))
+			{
+				if (i < my_argc) {
+					EvtRplyRecordPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--replay"))
+			{
+				if (i < my_argc) {
+					EvtRplyReplayPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+#endif
+#if MySoundEnabled
+			if (0 == strcmp(pa, "--sound-file"))
+			{
+				if (i < my_argc) {
+					MySoundFilePath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+#endif
+#if UseScrnCapt
+			if (0 == strcmp(pa, "--capture"))
+			{
+				if (i < my_argc) {
+					ScrnCaptPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+#endif
+#if UseSndCapt
+			if (0 == strcmp(pa, "--sound-capture"))
+			{
+				if (i < my_argc) {
+					SndCaptPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+#endif
+#if UseScrnVrfy
+			if (0 == strcmp(pa, "--hash-record"))
+			{
+				if (i < my_argc) {
+					ScrnVrfyRecordPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--hash-check"))
+			{
+				if (i < my_argc) {
+					ScrnVrfyCheckPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--hash-every"))
+			{
+				if (i < my_argc) {
+					ScrnVrfyEvery =
+						(ui5r)strtoul(my_argv[i++], NULL, 10);
+					goto label_retry;
+				}
+			} else
+#endif
+			{
+				fprintf(stderr, "usage: %s [--rom file] [-d dir]"
+					" [--seconds n]"
+#if EnableEvtReplay
+					" [--record file | --replay file]"
+#endif
+#if MySoundEnabled
+					" [--sound-file file]"
+#endif
+#if UseScrnCapt
+					" [--capture file]"
+#endif
+#if UseSndCapt
+					" [--sound-capture file]"
+#endif
+#if UseScrnVrfy
+					" [--hash-record file | --hash-check file]"
+					" [--hash-every n]"
+#endif
+					" [disk image ...]\n", my_argv[0]);
+				return falseblnr;
+			}
+		} else {
+			if (! Sony_Insert1(pa, falseblnr)) {
+				return falseblnr;
+			}
+			goto label_retry;
+		}
+	}
+
+	return trueblnr;
+}
+
+/* --- main program flow --- */
+
+GLOBALOSGLUFUNC blnr ExtraTimeNotOver(void)
+{
+	/* no extra time, the next tick is due right away */
+#if EnableEvtReplay
+	return EvtRply_ExtraTime(falseblnr);
+#else
+	return falseblnr;
+#endif
+}
+
+LOCALPROC CheckForSavedTasks(void)
+{
+	if (MyEvtQNeedRecover) {
+		MyEvtQNeedRecover = falseblnr;
+
+		/* attempt cleanup, MyEvtQNeedRecover may get set again */
+		MyEvtQTryRecoverFromFull();
+	}
+
+	if (RequestMacOff) {
+		RequestMacOff = falseblnr;
+		ForceMacOff = trueblnr;
+	}
+
+#if IncludeSonyNew
+	if (vSonyNewDiskWanted) {
+#if IncludeSonyNameNew
+		if (vSonyNewDiskName != NotAPbuf) {
+			PbufDispose(vSonyNewDiskName);
+			vSonyNewDiskName = NotAPbuf;
+		}
+#endif
+		MakeNewDisk(vSonyNewDiskSize, NULL);
+		vSonyNewDiskWanted = falseblnr;
+			/* must be done after may have gotten disk */
+	}
+#endif
+}
+
+GLOBALOSGLUPROC WaitForNextTick(void)
+{
+#if EnableEvtReplay
+	EvtRply_TickBegin();
+#endif
+
+#if WantInstructionCount
+	StatInstructions += InstructionCount;
+	InstructionCount = 0;
+#endif
+#if WantSliceStats
+	StatSlices += SliceStatCount;
+	SliceStatCount = 0;
+	StatSliceCycles += SliceStatCycles;
+	SliceStatCycles = 0;
+#endif
+
+	CheckForSavedTasks();
+	if (StatTicks >= TicksToRun) {
+		ForceMacOff = trueblnr;
+	}
+	if (ForceMacOff) {
+		return;
+	}
+
+	++StatTicks;
+	++TrueEmulatedTime;
+	CheckDateTime();
+
+	OnTrueTime = TrueEmulatedTime;
+#if EnableEvtReplay
+	EvtRply_TickEnd();
+#endif
+}
+
+/* --- platform independent code can be thought of as going here --- */
+
+#include "PROGMAIN.h"
+
+LOCALPROC ReportStats(void)
+{
+	/*
+		one "name: value" per line, so scripts (see
+		bench/run-bench.sh) can pick them out.
+	*/
+	struct timeval t;
+	struct rusage u;
+	double wall;
+
+	gettimeofday(&t, NULL);
+	wall = (t.tv_sec - StartTime.tv_sec)
+		+ (t.tv_usec - StartTime.tv_usec) / 1000000.0;
+	if (wall <= 0.0) {
+		wall = 1e-6;
+	}
+
+	printf("emulated_ticks: %u\n", (unsigned int)StatTicks);
+	printf("emulated_seconds: %.2f\n", StatTicks / 60.14742);
+	printf("wall_seconds: %.3f\n", wall);
+	printf("ticks_per_sec: %.1f\n", StatTicks / wall);
+#if WantInstructionCount
+	printf("instructions: %llu\n", StatInstructions);
+	printf("mips: %.2f\n", StatInstructions / wall / 1e6);
+#endif
+#if WantSliceStats
+	printf("cpu_slices: %llu\n", StatSlices);
+	printf("cycles_per_slice: %.1f\n",
+		StatSlices ? (double)StatSliceCycles / StatSlices : 0.0);
+#endif
+	printf("frames_drawn: %u\n", (unsigned int)StatFrames);
+	printf("damage_rects: %u\n", (unsigned int)StatDamageRects);
+	printf("damage_pixels: %llu\n", StatDamagePixels);
+	printf("bounding_box_pixels: %llu\n", StatBoxPixels);
+	printf("disk_read_bytes: %llu\n", StatDiskRead);
+	printf("disk_write_bytes: %llu\n", StatDiskWritten);
+#if MySoundEnabled
+	printf("sound_samples: %llu\n", StatSoundSamples);
+#endif
+	printf("screen_hash: %08x\n", (unsigned int)ScreenHash());
+#if WantLagStats
+	{
+		int i;
+
+		printf("lag_catchup_ticks: %u\n",
+			(unsigned int)LagStatCatchUp);
+		printf("lag_dropped_ticks: %u\n",
+			(unsigned int)LagStatDropped);
+		printf("lag_histogram:");
+		for (i = 0; i < kLagStatHistSz; ++i) {
+			printf(" %u", (unsigned int)LagStatHist[i]);
+		}
+		printf("\n");
+	}
+#endif
+#if EnableEvtReplay
+	if (kEvtRplyReplay == EvtRplyMode) {
+		printf("replay_checks: %u\n",
+			(unsigned int)EvtRplyChecksDone);
+		printf("replay_mismatches: %u\n",
+			(unsigned int)EvtRplyChecksFailed);
+	}
+#endif
+#if UseScrnVrfy
+	ScrnVrfy_CheckEnd();
+	if (NULL != ScrnVrfyCheckPath) {
+		printf("hash_checks: %u\n",
+			(unsigned int)ScrnVrfyChecks);
+		printf("hash_mismatches: %u\n",
+			(unsigned int)ScrnVrfyMismatches);
+	}
+#endif
+	if (0 == getrusage(RUSAGE_SELF, &u)) {
+		printf("peak_rss_kb: %ld\n", u.ru_maxrss);
+	}
+}
+
+LOCALPROC ReserveAllocAll(void)
+{
+#if dbglog_HAVE
+	dbglog_ReserveAlloc();
+#endif
+	ReserveAllocOneBlock(&ROM, kROM_Size, 5, falseblnr);
+
+	ReserveAllocOneBlock(&screencomparebuff,
+		vMacScreenNumBytes, 5, trueblnr);
+
+	EmulationReserveAlloc();
+}
+
+LOCALFUNC blnr AllocMyMemory(void)
+{
+	uimr n;
+	blnr IsOk = falseblnr;
+
+	ReserveAllocOffset = 0;
+	ReserveAllocBigBlock = nullpr;
+	ReserveAllocAll();
+	n = ReserveAllocOffset;
+	ReserveAllocBigBlock = (ui3p)calloc(1, n);
+	if (NULL == ReserveAllocBigBlock) {
+		fprintf(stderr, "out of memory\n");
+	} else {
+		ReserveAllocOffset = 0;
+		ReserveAllocAll();
+		if (n != ReserveAllocOffset) {
+			/* oops, program error */
+		} else {
+			IsOk = trueblnr;
+		}
+	}
+
+	return IsOk;
+}
+
+LOCALPROC UnallocMyMemory(void)
+{
+	if (nullpr != ReserveAllocBigBlock) {
+		free((char *)ReserveAllocBigBlock);
+	}
+}
+
+LOCALFUNC blnr InitOSGLU(void)
+{
+	if (AllocMyMemory())
+#if dbglog_HAVE
+	if (dbglog_open())
+#endif
+	if (ScanCommandLine())
+	if (LoadMacRom())
+	if (LoadInitialImages())
+	if (InitLocationDat())
+#if EnableEvtReplay
+	if (EvtRply_Init())
+#endif
+#if UseScrnCapt
+	if (ScrnCapt_Init())
+#endif
+#if UseSndCapt
+	if (SndCapt_Init())
+#endif
+#if UseScrnVrfy
+	if (ScrnVrfy_Init())
+#endif
+#if MySoundEnabled
+	if (MySound_Init())
+#endif
+	{
+		ScreenClearChanges();
+		StatDiskRead = 0; /* don't count EvtRply checking images */
+		gettimeofday(&StartTime, NULL);
+		return trueblnr;
+	}
+	return falseblnr;
+}
+
+LOCALPROC UnInitOSGLU(void)
+{
+#if MySoundEnabled
+	MySound_UnInit();
+#endif
+#if UseScrnVrfy
+	ScrnVrfy_UnInit();
+#endif
+#if UseSndCapt
+	SndCapt_UnInit();
+#endif
+#if UseScrnCapt
+	ScrnCapt_UnInit();
+#endif
+#if EnableEvtReplay
+	EvtRply_UnInit();
+#endif
+#if IncludeHostTextClipExchange
+	if (NotAPbuf != MyClipPbuf) {
+		PbufDispose(MyClipPbuf);
+	}
+#endif
+#if IncludePbufs
+	UnInitPbufs();
+#endif
+	UnInitDrives();
+
+#if dbglog_HAVE
+	dbglog_close();
+#endif
+
+	UnallocMyMemory();
+
+	CheckSavedMacMsg();
+}
+
+int main(int argc, char **argv)
+{
+	blnr IsOk;
+
+	my_argc = argc;
+	my_argv = argv;
+
+	InitDrives();
+	IsOk = InitOSGLU();
+	if (IsOk) {
+		ProgramMain();
+		ReportStats();
+	}
+	UnInitOSGLU();
+
+	return IsOk ? 0 : 1;
+}
+
+#endif /* WantOSGLUNUL */
@@ -1033,6 +1033,7 @@ LOCALVAR SDL_Surface *my_surface = nullpr;
 LOCALVAR SDL_Window *my_main_wind = NULL;
 LOCALVAR SDL_Renderer *my_renderer = NULL;
 LOCALVAR SDL_Texture *my_texture = NULL;
+LOCALVAR SDL_Texture *my_other_texture = NULL;
 LOCALVAR SDL_PixelFormat *my_format = NULL;
 #endif
 
@@ -1051,6 +1052,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateBWDepth3Copy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth 0
 #define ScrnMapr_DstDepth 3
 #define ScrnMapr_Map CLUT_final
@@ -1060,6 +1062,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateBWDepth4Copy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth 0
 #define ScrnMapr_DstDepth 4
 #define ScrnMapr_Map CLUT_final
@@ -1069,6 +1072,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateBWDepth5Copy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth 0
 #define ScrnMapr_DstDepth 5
 #define ScrnMapr_Map CLUT_final
@@ -1077,9 +1081,12 @@ LOCALVAR ui3p CLUT_final;
 
 #if EnableMagnify && ! UseSDLscaling
 
+#include "SCRNMAPV.h"
+
 #define ScrnMapr_DoMap UpdateBWDepth3ScaledCopy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth 0
 #define ScrnMapr_DstDepth 3
 #define ScrnMapr_Map CLUT_final
@@ -1090,6 +1097,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateBWDepth4ScaledCopy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth 0
 #define ScrnMapr_DstDepth 4
 #define ScrnMapr_Map CLUT_final
@@ -1100,6 +1108,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateBWDepth5ScaledCopy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth 0
 #define ScrnMapr_DstDepth 5
 #define ScrnMapr_Map CLUT_final
@@ -1115,6 +1124,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateColorDepth3Copy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth vMacScreenDepth
 #define ScrnMapr_DstDepth 3
 #define ScrnMapr_Map CLUT_final
@@ -1124,6 +1134,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateColorDepth4Copy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth vMacScreenDepth
 #define ScrnMapr_DstDepth 4
 #define ScrnMapr_Map CLUT_final
@@ -1133,6 +1144,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateColorDepth5Copy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth vMacScreenDepth
 #define ScrnMapr_DstDepth 5
 #define ScrnMapr_Map CLUT_final
@@ -1144,6 +1156,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateColorDepth3ScaledCopy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth vMacScreenDepth
 #define ScrnMapr_DstDepth 3
 #define ScrnMapr_Map CLUT_final
@@ -1154,6 +1167,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateColorDepth4ScaledCopy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth vMacScreenDepth
 #define ScrnMapr_DstDepth 4
 #define ScrnMapr_Map CLUT_final
@@ -1164,6 +1178,7 @@ LOCALVAR ui3p CLUT_final;
 #define ScrnMapr_DoMap UpdateColorDepth5ScaledCopy
 #define ScrnMapr_Src GetCurDrawBuff()
 #define ScrnMapr_Dst ScalingBuff
+#define ScrnMapr_DstAtRect (2 == SDL_MAJOR_VERSION)
 #define ScrnMapr_SrcDepth vMacScreenDepth
 #define ScrnMapr_DstDepth 5
 #define ScrnMapr_Map CLUT_final
@@ -1176,7 +1191,104 @@ LOCALVAR ui3p CLUT_final;
 #endif
 
 
-LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
+#ifndef MayUseFrmPace
+#define MayUseFrmPace 0
+#endif
+
+#define UseFrmPace (MayUseFrmPace && (2 == SDL_MAJOR_VERSION))
+
+#if UseFrmPace
+#include "FRMPACE.h"
+
+LOCALVAR ui5r MyFrmPaceFrames = 0;
+	/* ScreenChangedFrames when last checked */
+#endif
+
+#ifndef MayUseScrnScal
+#define MayUseScrnScal 0
+#endif
+
+#define UseScrnScal (MayUseScrnScal && MayFullScreen \
+	&& (2 == SDL_MAJOR_VERSION) && (0 == vMacScreenDepth))
+
+#if UseScrnScal
+
+/*
+	In full screen mode SCRNSCAL.h can scale to fill the
+	screen on the CPU, into a texture the size of the screen,
+	so the renderer only copies it. For machines where the
+	renderer has no GPU to scale with, so it is off unless
+	asked for with --fs-scale, and otherwise the renderer
+	scales as before.
+*/
+
+#ifndef WantInitScrnScal
+#define WantInitScrnScal kScrnScalOff
+#endif
+
+#include "SCRNSCAL.h"
+
+LOCALVAR blnr ScrnScalOn = falseblnr;
+LOCALVAR SDL_Texture *my_fs_texture = NULL;
+
+LOCALFUNC blnr MyScrnScalInit(void)
+{
+	int wr;
+	int hr;
+
+	if (kScrnScalOff == ScrnScalMode) {
+		return falseblnr;
+	}
+
+	if ((0 != SDL_GetRendererOutputSize(my_renderer, &wr, &hr))
+		|| ! ScrnScal_Setup(wr, hr, ScrnScalMode,
+			SDL_MapRGB(my_format, 255, 255, 255),
+			SDL_MapRGB(my_format, 0, 0, 0)))
+	{
+		return falseblnr;
+	}
+
+	if (NULL == (my_fs_texture = SDL_CreateTexture(
+		my_renderer,
+		SDL_PIXELFORMAT_ARGB8888,
+		SDL_TEXTUREACCESS_STREAMING,
+		wr, hr)))
+	{
+		fprintf(stderr, "SDL_CreateTexture fails: %s\n",
+			SDL_GetError());
+		return falseblnr;
+	}
+
+	/* borders are left as zero, no alpha */
+	(void) SDL_SetTextureBlendMode(my_fs_texture, SDL_BLENDMODE_NONE);
+	(void) SDL_UpdateTexture(my_fs_texture, NULL,
+		ScrnScal_Buff, 4 * wr);
+
+	return trueblnr;
+}
+
+LOCALPROC MyScrnScalDraw(ui4r top, ui4r left,
+	ui4r bottom, ui4r right)
+{
+	ScrnRect r;
+	SDL_Rect rect;
+
+	if (ScrnScal_DrawRect(GetCurDrawBuff(),
+		top, left, bottom, right, &r))
+	{
+		rect.x = r.left;
+		rect.y = r.top;
+		rect.w = r.right - r.left;
+		rect.h = r.bottom - r.top;
+		(void) SDL_UpdateTexture(my_fs_texture, &rect,
+			ScrnScal_Buff + r.top * (ui5r)ScrnScal_Width + r.left,
+			4 * ScrnScal_Width);
+	}
+}
+
+#endif /* UseScrnScal */
+
+LOCALPROC UpdateScreenBuffRect(ui4r top, ui4r left,
 	ui4r bottom, ui4r right)
 {
 #if 0 != SDL_MAJOR_VERSION
@@ -1196,12 +1308,18 @@ LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
 	int pitch;
 
 #if 2 == SDL_MAJOR_VERSION
-	SDL_Rect src_rect;
-	SDL_Rect dst_rect;
 	int XDest;
 	int YDest;
 	int DestWidth;
 	int DestHeight;
+	SDL_Rect LockRect;
+
+#if UseScrnScal
+	if (ScrnScalOn) {
+		MyScrnScalDraw(top, left, bottom, right);
+		return;
+	}
+#endif
 
 #if VarFullScreen
 	if (UseFullScreen)
@@ -1261,6 +1379,12 @@ LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
 	}
 #endif
 
+	/*
+		the screen mappers work in whole source bytes, and
+		everything in a locked rectangle must be written.
+	*/
+	left &= ~ 7;
+	right = (right + 7) & ~ 7;
 #endif /* 2 == SDL_MAJOR_VERSION */
 
 	top2 = top;
@@ -1287,7 +1411,16 @@ LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
 	pitch = my_surface->pitch;
 
 #elif 2 == SDL_MAJOR_VERSION
-	if (0 != SDL_LockTexture(my_texture, NULL, &pixels, &pitch)) {
+	/*
+		Lock just the changed part, so only it is uploaded.
+		pixels then points at the top left of the rectangle,
+		and everything below indexes from there.
+	*/
+	LockRect.x = left2;
+	LockRect.y = top2;
+	LockRect.w = right2 - left2;
+	LockRect.h = bottom2 - top2;
+	if (0 != SDL_LockTexture(my_texture, &LockRect, &pixels, &pitch)) {
 		return;
 	}
 #endif
@@ -1461,8 +1594,13 @@ LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
 			for (j = left2; j < right2; ++j) {
 				int i0 = i;
 				int j0 = j;
+#if 2 == SDL_MAJOR_VERSION
+				Uint8 *bufp = (Uint8 *)pixels
+					+ (i - top2) * pitch + (j - left2) * bpp;
+#else
 				Uint8 *bufp = (Uint8 *)pixels
 					+ i * pitch + j * bpp;
+#endif
 
 #if EnableMagnify && ! UseSDLscaling
 				if (UseMagnify) {
@@ -1560,6 +1698,30 @@ LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
 	dst_rect.h = DestHeight;
 	*/
 
+	/* presented by MyPresentScreen */
+
+#if MayFullScreen
+label_exit:
+	;
+#endif
+#endif /* 2 == SDL_MAJOR_VERSION */
+#endif /* 0 != SDL_MAJOR_VERSION */
+}
+
+#if 2 == SDL_MAJOR_VERSION
+LOCALPROC MyPresentScreen(void)
+{
+	SDL_Rect src_rect;
+	SDL_Rect dst_rect;
+
+#if UseScrnScal
+	if (ScrnScalOn) {
+		SDL_RenderCopy(my_renderer, my_fs_texture, NULL, NULL);
+		SDL_RenderPresent(my_renderer);
+		return;
+	}
+#endif
+
 	// Blah Blob improvement: scale the texture to fill the entire window
 	// Allows for proper full screen mode
 
@@ -1605,21 +1767,168 @@ LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
 	SDL_SetTextureScaleMode(my_texture, SDL_ScaleModeLinear);
 	SDL_RenderCopy(my_renderer, my_texture, &src_rect, &dst_rect);
 	SDL_RenderPresent(my_renderer);
+}
+#endif
 
-#if MayFullScreen
-label_exit:
-	;
+#ifndef WantFrameStats
+#define WantFrameStats 0
+#endif
+
+#if WantFrameStats
+LOCALVAR blnr FrameStatsOn = falseblnr; /* set by --frame-stats */
+LOCALVAR ui5r FrameStatDrawn = 0;
+LOCALVAR ui5r FrameStatSkipped = 0;
+LOCALVAR Uint64 FrameStatUpdateSum = 0;
+LOCALVAR Uint64 FrameStatUpdateMax = 0;
+LOCALVAR Uint64 FrameStatPresentSum = 0;
+LOCALVAR Uint64 FrameStatPresentMax = 0;
+
+LOCALPROC FrameStatAdd(Uint64 *Sum, Uint64 *Max, Uint64 t)
+{
+	*Sum += t;
+	if (t > *Max) {
+		*Max = t;
+	}
+}
+
+LOCALPROC FrameStatsReport(void)
+{
+	double us = 1000000.0 / (double)SDL_GetPerformanceFrequency();
+	ui5r n = (0 != FrameStatDrawn) ? FrameStatDrawn : 1;
+
+	if (FrameStatsOn) {
+		fprintf(stderr, "frames_drawn: %u\n",
+			(unsigned int)FrameStatDrawn);
+		fprintf(stderr, "ticks_not_drawn: %u\n",
+			(unsigned int)FrameStatSkipped);
+		fprintf(stderr, "update_us: mean %.1f max %.1f\n",
+			FrameStatUpdateSum * us / n, FrameStatUpdateMax * us);
+		fprintf(stderr, "present_us: mean %.1f max %.1f\n",
+			FrameStatPresentSum * us / n, FrameStatPresentMax * us);
+	}
+}
+#endif /* WantFrameStats */
+
+#if 2 == SDL_MAJOR_VERSION
+/*
+	Two streaming textures are drawn into in turn, so that
+	locking one for the next frame doesn't wait on the GPU
+	still reading the one just presented. Whatever was drawn
+	into one is then stale in the other, and is drawn into it
+	as well the next time.
+*/
+LOCALVAR ScrnRect MyStaleRects[kMaxScrnRects];
+LOCALVAR int MyStaleRectsN = 0;
+
+LOCALPROC MyStaleAll(void)
+{
+	MyStaleRects[0].top = 0;
+	MyStaleRects[0].left = 0;
+	MyStaleRects[0].bottom = vMacScreenHeight;
+	MyStaleRects[0].right = vMacScreenWidth;
+	MyStaleRectsN = 1;
+}
+
+LOCALFUNC blnr ScrnRectInside(ScrnRect *a, ScrnRect *b)
+{
+	return (a->top >= b->top) && (a->left >= b->left)
+		&& (a->bottom <= b->bottom) && (a->right <= b->right);
+}
+#endif
+
+/* draw n rectangles of the emulated screen and show them */
+LOCALPROC MyDrawRects(ScrnRect *r, int n)
+{
+	int i;
+#if 2 == SDL_MAJOR_VERSION
+	int j;
+	SDL_Texture *t;
+#endif
+#if WantFrameStats
+	Uint64 t0 = SDL_GetPerformanceCounter();
+	Uint64 t1;
+#endif
+
+	for (i = 0; i < n; ++i) {
+		UpdateScreenBuffRect(r[i].top, r[i].left,
+			r[i].bottom, r[i].right);
+	}
+
+#if 2 == SDL_MAJOR_VERSION
+	if ((NULL != my_other_texture)
+#if UseScrnScal
+		&& ! ScrnScalOn
+#endif
+		)
+	{
+		for (j = 0; j < MyStaleRectsN; ++j) {
+			for (i = 0; i < n; ++i) {
+				if (ScrnRectInside(&MyStaleRects[j], &r[i])) {
+					break;
+				}
+			}
+			if (i == n) {
+				UpdateScreenBuffRect(
+					MyStaleRects[j].top, MyStaleRects[j].left,
+					MyStaleRects[j].bottom, MyStaleRects[j].right);
+			}
+		}
+		for (i = 0; i < n; ++i) {
+			MyStaleRects[i] = r[i];
+		}
+		MyStaleRectsN = n;
+	}
+#endif
+
+#if WantFrameStats
+	t1 = SDL_GetPerformanceCounter();
+	FrameStatAdd(&FrameStatUpdateSum, &FrameStatUpdateMax, t1 - t0);
+#endif
+
+#if 2 == SDL_MAJOR_VERSION
+	MyPresentScreen();
+
+	if ((NULL != my_other_texture)
+#if UseScrnScal
+		&& ! ScrnScalOn
+#endif
+		)
+	{
+		t = my_texture;
+		my_texture = my_other_texture;
+		my_other_texture = t;
+	}
+#endif
+
+#if WantFrameStats
+	FrameStatAdd(&FrameStatPresentSum, &FrameStatPresentMax,
+		SDL_GetPerformanceCounter() - t1);
+	++FrameStatDrawn;
 #endif
-#endif /* 2 == SDL_MAJOR_VERSION */
-#endif /* 0 != SDL_MAJOR_VERSION */
+}
+
+LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
+	ui4r bottom, ui4r right)
+{
+	ScrnRect r;
+
+	r.top = top;
+	r.left = left;
+	r.bottom = bottom;
+	r.right = right;
+	MyDrawRects(&r, 1);
 }
 
 LOCALPROC MyDrawChangesAndClear(void)
 {
 	if (ScreenChangedBottom > ScreenChangedTop) {
-		HaveChangedScreenBuff(ScreenChangedTop, ScreenChangedLeft,
-			ScreenChangedBottom, ScreenChangedRight);
+		MyDrawRects(ScreenDamage, ScreenDamageN);
 		ScreenClearChanges();
+	} else {
+		/* nothing changed, so don't wait on a present */
+#if WantFrameStats
+		++FrameStatSkipped;
+#endif
 	}
 }
 
@@ -1629,6 +1938,19 @@ GLOBALOSGLUPROC DoneWithDrawingForTick(void)
 	if (HaveMouseMotion) {
 		AutoScrollScreen();
 	}
+#endif
+#if UseFrmPace
+	if (FrmPaceOn && ! CurSpeedStopped) {
+		/* leave it for MyFrmPaceCheck */
+		if ((MyFrmPaceFrames != ScreenChangedFrames)
+			|| ((ScreenChangedBottom > ScreenChangedTop)
+				&& ! FrmPaceWaiting))
+		{
+			MyFrmPaceFrames = ScreenChangedFrames;
+			FrmPace_FrameDone();
+		}
+		return;
+	}
 #endif
 	MyDrawChangesAndClear();
 }
@@ -1686,34 +2008,42 @@ LOCALFUNC blnr MyMoveMouse(si4b h, si4b v)
 			but there is no way to detect failure.)
 	*/
 
+#if UseScrnScal
+	if (ScrnScalOn) {
+		h = ScrnScal_FromSrcH(h);
+		v = ScrnScal_FromSrcV(v);
+	} else
+#endif
+	{
 #if VarFullScreen
-	if (UseFullScreen)
+		if (UseFullScreen)
 #endif
 #if MayFullScreen
-	{
-		h -= ViewHStart;
-		v -= ViewVStart;
-	}
+		{
+			h -= ViewHStart;
+			v -= ViewVStart;
+		}
 #endif
 
 #if EnableMagnify
-	if (UseMagnify) {
-		h *= MyWindowScale;
-		v *= MyWindowScale;
-	}
+		if (UseMagnify) {
+			h *= MyWindowScale;
+			v *= MyWindowScale;
+		}
 #endif
 
 #if 2 == SDL_MAJOR_VERSION
 #if VarFullScreen
-	if (UseFullScreen)
+		if (UseFullScreen)
 #endif
 #if MayFullScreen
-	{
-		h += hOffset;
-		v += vOffset;
-	}
+		{
+			h += hOffset;
+			v += vOffset;
+		}
 #endif
 #endif /* 2 == SDL_MAJOR_VERSION */
+	}
 
 #if 1 == SDL_MAJOR_VERSION
 	SDL_WarpMouse(h, v);
@@ -1731,34 +2061,42 @@ LOCALPROC MousePositionNotify(int NewMousePosh, int NewMousePosv)
 {
 	blnr ShouldHaveCursorHidden = trueblnr;
 
+#if UseScrnScal
+	if (ScrnScalOn) {
+		NewMousePosh = ScrnScal_ToSrcH(NewMousePosh);
+		NewMousePosv = ScrnScal_ToSrcV(NewMousePosv);
+	} else
+#endif
+	{
 #if 2 == SDL_MAJOR_VERSION
 #if VarFullScreen
-	if (UseFullScreen)
+		if (UseFullScreen)
 #endif
 #if MayFullScreen
-	{
-		NewMousePosh -= hOffset;
-		NewMousePosv -= vOffset;
-	}
+		{
+			NewMousePosh -= hOffset;
+			NewMousePosv -= vOffset;
+		}
 #endif
 #endif /* 2 == SDL_MAJOR_VERSION */
 
 #if EnableMagnify
-	if (UseMagnify) {
-		NewMousePosh /= MyWindowScale;
-		NewMousePosv /= MyWindowScale;
-	}
+		if (UseMagnify) {
+			NewMousePosh /= MyWindowScale;
+			NewMousePosv /= MyWindowScale;
+		}
 #endif
 
 #if VarFullScreen
-	if (UseFullScreen)
+		if (UseFullScreen)
 #endif
 #if MayFullScreen
-	{
-		NewMousePosh += ViewHStart;
-		NewMousePosv += ViewVStart;
-	}
+		{
+			NewMousePosh += ViewHStart;
+			NewMousePosv += ViewVStart;
+		}
 #endif
+	}
 
 #if EnableFSMouseMotion
 	if (HaveMouseMotion) {
@@ -2237,6 +2575,13 @@ LOCALVAR ui5b TrueEmulatedTime = 0;
 #define MyInvTimeDivMask (MyInvTimeDiv - 1)
 #define MyInvTimeStep 1089590 /* 1000 / 60.14742 * MyInvTimeDiv */
 
+#if UseFrmPace
+LOCALVAR ui5b MyTickStep = MyInvTimeStep;
+	/* may be changed to lock to the display */
+#else
+#define MyTickStep MyInvTimeStep
+#endif
+
 LOCALVAR Uint32 LastTime;
 
 LOCALVAR Uint32 NextIntTime;
@@ -2247,7 +2592,7 @@ LOCALVAR ui5b NextFracTime;
 LOCALPROC IncrNextTime(void)
 {
 #if 0 != SDL_MAJOR_VERSION
-	NextFracTime += MyInvTimeStep;
+	NextFracTime += MyTickStep;
 	NextIntTime += (NextFracTime >> MyInvTimeDivPow);
 	NextFracTime &= MyInvTimeDivMask;
 #endif /* 0 != SDL_MAJOR_VERSION */
@@ -2318,6 +2663,48 @@ LOCALFUNC blnr UpdateTrueEmulatedTime(void)
 	return falseblnr;
 }
 
+#if UseFrmPace
+
+LOCALFUNC ui5r MyPaceNow(void)
+{
+	Uint64 c = SDL_GetPerformanceCounter();
+	Uint64 f = SDL_GetPerformanceFrequency();
+
+	return (ui5r)((c / f) * 1000000 + (c % f) * 1000000 / f);
+}
+
+LOCALPROC MyFrmPaceInit(void)
+{
+	/*
+		my_renderer has PRESENTVSYNC, so presents
+		return at a vertical blank.
+	*/
+	SDL_DisplayMode info;
+	ui5r r = 0;
+	ui5r t;
+
+	if (0 == SDL_GetCurrentDisplayMode(
+		SDL_GetWindowDisplayIndex(my_main_wind), &info))
+	{
+		r = 1000 * (ui5r)info.refresh_rate;
+	}
+	FrmPace_SetRate(r, trueblnr);
+
+	t = FrmPace_TickMicros();
+	MyTickStep = (kFrmPaceTickMicros == t) ? MyInvTimeStep
+		: (ui5b)(((Uint64)t << MyInvTimeDivPow) / 1000);
+}
+
+LOCALPROC MyFrmPaceCheck(void)
+{
+	if (FrmPace_Due(MyPaceNow())) {
+		MyDrawChangesAndClear();
+		FrmPace_Presented(MyPaceNow());
+	}
+}
+
+#endif /* UseFrmPace */
+
 
 LOCALFUNC blnr CheckDateTime(void)
 {
@@ -4513,6 +4900,20 @@ LOCALFUNC blnr CreateMainWindow(void)
 		vMacScreenWidth, vMacScreenHeight
 #else
 		NewWindowWidth, NewWindowHeight
+#endif
+		)))
+	{
+		fprintf(stderr, "SDL_CreateTexture fails: %s\n",
+			SDL_GetError());
+	} else
+	if (NULL == (my_other_texture = SDL_CreateTexture(
+		my_renderer,
+		SDL_PIXELFORMAT_ARGB8888,
+		SDL_TEXTUREACCESS_STREAMING,
+#if UseSDLscaling
+		vMacScreenWidth, vMacScreenHeight
+#else
+		NewWindowWidth, NewWindowHeight
 #endif
 		)))
 	{
@@ -4529,6 +4930,12 @@ LOCALFUNC blnr CreateMainWindow(void)
 
 		SDL_RenderClear(my_renderer);
 
+		MyStaleAll(); /* my_other_texture starts out undefined */
+
+#if UseFrmPace
+		MyFrmPaceInit();
+#endif
+
 #if 0
 		SDL_DisplayMode info;
 
@@ -4581,6 +4988,19 @@ LOCALFUNC blnr CreateMainWindow(void)
 			} else {
 				vOffset = 0;
 			}
+
+#if UseScrnScal
+			ScrnScalOn = MyScrnScalInit();
+			if (ScrnScalOn) {
+				/* whole emulated screen is shown */
+				ViewHStart = 0;
+				ViewVStart = 0;
+				ViewHSize = vMacScreenWidth;
+				ViewVSize = vMacScreenHeight;
+				hOffset = ScrnScal_Dst.left;
+				vOffset = ScrnScal_Dst.top;
+			}
+#endif
 		}
 #endif
 
@@ -4606,11 +5026,24 @@ LOCALPROC CloseMainWindow(void)
 		my_format = NULL;
 	}
 
+#if UseScrnScal
+	if (NULL != my_fs_texture) {
+		SDL_DestroyTexture(my_fs_texture);
+		my_fs_texture = NULL;
+	}
+	ScrnScalOn = falseblnr;
+#endif
+
 	if (NULL != my_texture) {
 		SDL_DestroyTexture(my_texture);
 		my_texture = NULL;
 	}
 
+	if (NULL != my_other_texture) {
+		SDL_DestroyTexture(my_other_texture);
+		my_other_texture = NULL;
+	}
+
 	if (NULL != my_renderer) {
 		SDL_DestroyRenderer(my_renderer);
 		my_renderer = NULL;
@@ -4628,7 +5061,12 @@ LOCALPROC ZapMyWState(void)
 	my_main_wind = NULL;
 	my_renderer = NULL;
 	my_texture = NULL;
+	my_other_texture = NULL;
 	my_format = NULL;
+#if UseScrnScal
+	my_fs_texture = NULL;
+	ScrnScalOn = falseblnr;
+#endif
 }
 #endif
 
@@ -4654,7 +5092,12 @@ struct MyWState {
 	SDL_Window *f_my_main_wind;
 	SDL_Renderer *f_my_renderer;
 	SDL_Texture *f_my_texture;
+	SDL_Texture *f_my_other_texture;
 	SDL_PixelFormat *f_my_format;
+#if UseScrnScal
+	SDL_Texture *f_my_fs_texture;
+	blnr f_ScrnScalOn;
+#endif
 };
 typedef struct MyWState MyWState;
 #endif
@@ -4682,7 +5125,12 @@ LOCALPROC GetMyWState(MyWState *r)
 	r->f_my_main_wind = my_main_wind;
 	r->f_my_renderer = my_renderer;
 	r->f_my_texture = my_texture;
+	r->f_my_other_texture = my_other_texture;
 	r->f_my_format = my_format;
+#if UseScrnScal
+	r->f_my_fs_texture = my_fs_texture;
+	r->f_ScrnScalOn = ScrnScalOn;
+#endif
 }
 #endif
 
@@ -4709,7 +5157,12 @@ LOCALPROC SetMyWState(MyWState *r)
 	my_main_wind = r->f_my_main_wind;
 	my_renderer = r->f_my_renderer;
 	my_texture = r->f_my_texture;
+	my_other_texture = r->f_my_other_texture;
 	my_format = r->f_my_format;
+#if UseScrnScal
+	my_fs_texture = r->f_my_fs_texture;
+	ScrnScalOn = r->f_ScrnScalOn;
+#endif
 }
 #endif
 
@@ -5067,6 +5520,61 @@ label_retry:
 					goto label_retry;
 				}
 			} else
+#if WantFrameStats
+			if (0 == strcmp(pa, "--frame-stats"))
+			{
+				FrameStatsOn = trueblnr;
+				goto label_retry;
+			} else
+#endif
+#if UseFrmPace
+			if (0 == strcmp(pa, "--frame-pacing"))
+			{
+				if (i < my_argc) {
+					pa = my_argv[i++];
+					if (0 == strcmp(pa, "off")) {
+						FrmPaceMode = kFrmPaceOff;
+					} else if (0 == strcmp(pa, "on")) {
+						FrmPaceMode = kFrmPaceOn;
+					} else if (0 == strcmp(pa, "lock")) {
+						FrmPaceMode = kFrmPaceLock;
+					} else {
+						MacMsg(kStrBadArgTitle, kStrBadArgMessage,
+							falseblnr);
+					}
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--refresh-rate"))
+			{
+				if (i < my_argc) {
+					FrmPaceForceRate = (ui5r)(1000.0
+						* strtod(my_argv[i++], NULL) + 0.5);
+					goto label_retry;
+				}
+			} else
+#endif
+#if UseScrnScal
+			if (0 == strcmp(pa, "--fs-scale"))
+			{
+				if (i < my_argc) {
+					pa = my_argv[i++];
+					if (0 == strcmp(pa, "off")) {
+						ScrnScalMode = kScrnScalOff;
+					} else if (0 == strcmp(pa, "integer")) {
+						ScrnScalMode = kScrnScalInteger;
+					} else if (0 == strcmp(pa, "nearest")) {
+						ScrnScalMode = kScrnScalNearest;
+					} else if (0 == strcmp(pa, "sharp")) {
+						ScrnScalMode = kScrnScalSharp;
+					} else {
+						MacMsg(kStrBadArgTitle, kStrBadArgMessage,
+							falseblnr);
+					}
+					goto label_retry;
+				}
+			} else
+#endif
 			if (('p' == pa[1]) && ('s' == pa[2]) && ('n' == pa[3]))
 			{
 				/* seen in OS X. ignore */
@@ -5137,6 +5645,11 @@ LOCALPROC CheckForSystemEvents(void)
 GLOBALOSGLUFUNC blnr ExtraTimeNotOver(void)
 {
 	UpdateTrueEmulatedTime();
+#if UseFrmPace
+	if (FrmPaceOn) {
+		MyFrmPaceCheck();
+	}
+#endif
 	return TrueEmulatedTime == OnTrueTime;
 }
 
@@ -5162,7 +5675,19 @@ label_retry:
 
 	if (ExtraTimeNotOver()) {
 #if 0 != SDL_MAJOR_VERSION
-		(void) SDL_Delay(NextIntTime - LastTime);
+		Uint32 w = NextIntTime - LastTime;
+
+#if UseFrmPace
+		if (FrmPaceOn) {
+			/* wake up for the next present too */
+			ui5r p = FrmPace_Wait(MyPaceNow()) / 1000;
+
+			if (p < w) {
+				w = p;
+			}
+		}
+#endif
+		(void) SDL_Delay(w);
 #endif
 		goto label_retry;
 	}
@@ -5344,6 +5869,13 @@ LOCALPROC UnInitOSGLU(void)
 
 	ForceShowCursor();
 
+#if WantFrameStats
+	FrameStatsReport();
+#endif
+#if UseFrmPace
+	FrmPace_Report();
+#endif
+
 #if dbglog_HAVE
 	dbglog_close();
 #endif
@@ -38,7 +38,10 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <errno.h>
+#include <signal.h>
+#include <setjmp.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -488,6 +491,36 @@ LOCALVAR FILE *Drives[NumDrives]; /* open disk image files */
 LOCALVAR char *DriveNames[NumDrives];
 #endif
 
+#ifndef MapDiskImages
+#define MapDiskImages 1
+#endif
+
+#if MapDiskImages
+/*
+	Where it can be, the image is mapped into memory, so
+	vSonyTransfer is a copy to or from the mapping, instead of
+	a seek and a read or write through stdio for each request of
+	the Sony driver. Locked images are mapped private and read
+	only, the others shared, and written back by msync when
+	ejected (which is also how they are closed when quitting).
+	If the file can't be mapped, stdio is used as before.
+
+	If the file is cut short by something else, or the disk it
+	is on fails or fills up, touching the mapping raises SIGBUS
+	instead of returning an error, so DriveMapFault catches that
+	during the copy, and it is reported to the Mac as an I/O
+	error.
+*/
+LOCALVAR ui3p DriveMaps[NumDrives]; /* or NULL if not mapped */
+LOCALVAR ui5r DriveMapSizes[NumDrives];
+LOCALVAR blnr DriveMapFaultSet = falseblnr;
+LOCALVAR __thread sigjmp_buf * volatile DriveMapFaultJmp = NULL;
+	/*
+		set while copying, in whichever thread is. volatile so
+		the compiler can't drop setting it around the copy.
+	*/
+#endif
+
 LOCALPROC InitDrives(void)
 {
 	/*
@@ -500,11 +533,91 @@ LOCALPROC InitDrives(void)
 		Drives[i] = NotAfileRef;
 #if IncludeSonyGetName || IncludeSonyNew
 		DriveNames[i] = NULL;
+#endif
+#if MapDiskImages
+		DriveMaps[i] = NULL;
 #endif
 	}
 }
 
-GLOBALOSGLUFUNC tMacErr vSonyTransfer(blnr IsWrite, ui3p Buffer,
+#if MapDiskImages
+LOCALPROC DriveMapFault(int sig, siginfo_t *info, void *uap)
+{
+	sigjmp_buf *j = DriveMapFaultJmp;
+
+	UnusedParam(info);
+	UnusedParam(uap);
+
+	if (NULL != j) {
+		DriveMapFaultJmp = NULL;
+		siglongjmp(*j, 1);
+	}
+
+	/* not from a disk image, so fail as if never caught */
+	(void) signal(sig, SIG_DFL);
+}
+#endif
+
+#if MapDiskImages
+LOCALPROC DriveMapOpen(tDrive Drive_No, blnr locked)
+{
+	struct sigaction sa;
+	FILE *refnum = Drives[Drive_No];
+	struct stat st;
+	void *p;
+
+	DriveMaps[Drive_No] = NULL;
+
+	/* anything written through stdio so far must be in the file */
+	if ((0 == fflush(refnum))
+		&& (0 == fstat(fileno(refnum), &st))
+		&& S_ISREG(st.st_mode)
+		&& (st.st_size > 0)
+		&& (st.st_size <= 0xFFFFFFFF))
+	{
+		p = mmap(NULL, st.st_size,
+			locked ? PROT_READ : (PROT_READ | PROT_WRITE),
+			locked ? MAP_PRIVATE : MAP_SHARED,
+			fileno(refnum), 0);
+		if (MAP_FAILED != p) {
+			if (! DriveMapFaultSet) {
+				/*
+					SA_NODEFER, so that after jumping out of
+					the handler SIGBUS isn't left blocked.
+				*/
+				memset(&sa, 0, sizeof(sa));
+				sa.sa_sigaction = DriveMapFault;
+				sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+				(void) sigemptyset(&sa.sa_mask);
+				DriveMapFaultSet = (0 == sigaction(SIGBUS, &sa, NULL));
+			}
+			if (DriveMapFaultSet) {
+				DriveMaps[Drive_No] = (ui3p)p;
+				DriveMapSizes[Drive_No] = st.st_size;
+			} else {
+				(void) munmap(p, st.st_size);
+			}
+		}
+	}
+}
+#endif
+
+#if MapDiskImages
+LOCALPROC DriveMapClose(tDrive Drive_No)
+{
+	ui3p p = DriveMaps[Drive_No];
+
+	if (NULL != p) {
+		if (0 != msync(p, DriveMapSizes[Drive_No], MS_SYNC)) {
+			fprintf(stderr, "msync of disk image failed\n");
+		}
+		(void) munmap(p, DriveMapSizes[Drive_No]);
+		DriveMaps[Drive_No] = NULL;
+	}
+}
+#endif
+
+LOCALFUNC tMacErr vSonyTransfer0(blnr IsWrite, ui3p Buffer,
 	tDrive Drive_No, ui5r Sony_Start, ui5r Sony_Count,
 	ui5r *Sony_ActCount)
 {
@@ -512,6 +625,40 @@ GLOBALOSGLUFUNC tMacErr vSonyTransfer(blnr IsWrite, ui3p Buffer,
 	FILE *refnum = Drives[Drive_No];
 	ui5r NewSony_Count = 0;
 
+#if MapDiskImages
+	if (NULL != DriveMaps[Drive_No]) {
+		ui5r L = DriveMapSizes[Drive_No];
+		sigjmp_buf jb;
+
+		if (Sony_Start <= L) {
+			NewSony_Count = L - Sony_Start;
+			if (NewSony_Count > Sony_Count) {
+				NewSony_Count = Sony_Count;
+			}
+			if (0 == sigsetjmp(jb, 0)) {
+				DriveMapFaultJmp = &jb;
+				if (IsWrite) {
+					MyMoveBytes((anyp)Buffer,
+						(anyp)(DriveMaps[Drive_No] + Sony_Start),
+						NewSony_Count);
+				} else {
+					MyMoveBytes(
+						(anyp)(DriveMaps[Drive_No] + Sony_Start),
+						(anyp)Buffer, NewSony_Count);
+				}
+				DriveMapFaultJmp = NULL;
+
+				if (NewSony_Count == Sony_Count) {
+					err = mnvm_noErr;
+				}
+			} else {
+				fprintf(stderr, "disk image i/o error\n");
+				NewSony_Count = 0;
+				err = mnvm_ioErr;
+			}
+		}
+	} else
+#endif
 	if (0 == fseek(refnum, Sony_Start, SEEK_SET)) {
 		if (IsWrite) {
 			NewSony_Count = fwrite(Buffer, 1, Sony_Count, refnum);
@@ -531,12 +678,202 @@ GLOBALOSGLUFUNC tMacErr vSonyTransfer(blnr IsWrite, ui3p Buffer,
 	return err; /*& figure out what really to return &*/
 }
 
+#if IncludeSonyAsync
+#include <pthread.h>
+
+/*
+	With --async-disk, vSonyTransferStart hands a Prime call of
+	the Sony driver to a thread, so the emulation goes on while a
+	slow read or write is done (see SONYEMDV.c). The driver takes
+	one request at a time, so one thread is enough. Most are done
+	within kDiskAsyncSpinUs anyway, and then finished right away,
+	as if done by vSonyTransfer. Anything else that uses an image
+	waits for the thread first.
+*/
+
+#define kDiskAsyncSpinUs 1000
+
+LOCALVAR blnr DiskAsyncWant = falseblnr;
+LOCALVAR blnr DiskAsyncStarted = falseblnr;
+LOCALVAR blnr DiskAsyncBusy = falseblnr; /* the thread has a transfer */
+LOCALVAR blnr DiskAsyncHave = falseblnr; /* its result, not taken yet */
+LOCALVAR blnr DiskAsyncQuit = falseblnr;
+LOCALVAR pthread_t DiskAsyncThread;
+LOCALVAR pthread_mutex_t DiskAsyncMutex = PTHREAD_MUTEX_INITIALIZER;
+LOCALVAR pthread_cond_t DiskAsyncCond = PTHREAD_COND_INITIALIZER;
+
+LOCALVAR blnr DiskAsyncIsWrite;
+LOCALVAR ui3p DiskAsyncBuffer;
+LOCALVAR tDrive DiskAsyncDrive_No;
+LOCALVAR ui5r DiskAsyncStart;
+LOCALVAR ui5r DiskAsyncCount;
+LOCALVAR tMacErr DiskAsyncErr;
+LOCALVAR ui5r DiskAsyncActCount;
+
+LOCALVAR ui5r DiskAsyncStatStarted = 0;
+LOCALVAR ui5r DiskAsyncStatLate = 0; /* not done within the spin */
+
+LOCALFUNC void *DiskAsyncWorker(void *arg)
+{
+	tMacErr err;
+	ui5r n;
+
+	(void) arg;
+
+	pthread_mutex_lock(&DiskAsyncMutex);
+	while (! DiskAsyncQuit) {
+		if (! DiskAsyncBusy) {
+			pthread_cond_wait(&DiskAsyncCond, &DiskAsyncMutex);
+		} else {
+			pthread_mutex_unlock(&DiskAsyncMutex);
+
+			err = vSonyTransfer0(DiskAsyncIsWrite, DiskAsyncBuffer,
+				DiskAsyncDrive_No, DiskAsyncStart, DiskAsyncCount, &n);
+
+			pthread_mutex_lock(&DiskAsyncMutex);
+			DiskAsyncErr = err;
+			DiskAsyncActCount = n;
+			DiskAsyncBusy = falseblnr;
+			DiskAsyncHave = trueblnr;
+			pthread_cond_broadcast(&DiskAsyncCond);
+		}
+	}
+	pthread_mutex_unlock(&DiskAsyncMutex);
+
+	return NULL;
+}
+
+LOCALPROC DiskAsyncWaitIdle(void)
+{
+	if (DiskAsyncStarted) {
+		pthread_mutex_lock(&DiskAsyncMutex);
+		while (DiskAsyncBusy) {
+			pthread_cond_wait(&DiskAsyncCond, &DiskAsyncMutex);
+		}
+		pthread_mutex_unlock(&DiskAsyncMutex);
+	}
+}
+
+GLOBALOSGLUFUNC blnr vSonyTransferStart(blnr IsWrite, ui3p Buffer,
+	tDrive Drive_No, ui5r Sony_Start, ui5r Sony_Count)
+{
+	struct timespec t;
+	blnr v = falseblnr;
+
+	if (! DiskAsyncWant) {
+		return falseblnr;
+	}
+
+	if (! DiskAsyncStarted) {
+		if (0 != pthread_create(&DiskAsyncThread, NULL,
+			DiskAsyncWorker, NULL))
+		{
+			fprintf(stderr, "Couldn't start disk thread\n");
+			DiskAsyncWant = falseblnr;
+			return falseblnr;
+		}
+		DiskAsyncStarted = trueblnr;
+	}
+
+	pthread_mutex_lock(&DiskAsyncMutex);
+	if (! (DiskAsyncBusy || DiskAsyncHave)) {
+		DiskAsyncIsWrite = IsWrite;
+		DiskAsyncBuffer = Buffer;
+		DiskAsyncDrive_No = Drive_No;
+		DiskAsyncStart = Sony_Start;
+		DiskAsyncCount = Sony_Count;
+		DiskAsyncBusy = trueblnr;
+		++DiskAsyncStatStarted;
+		pthread_cond_broadcast(&DiskAsyncCond);
+
+		(void) clock_gettime(CLOCK_REALTIME, &t);
+		t.tv_nsec += kDiskAsyncSpinUs * 1000;
+		if (t.tv_nsec >= 1000000000) {
+			t.tv_nsec -= 1000000000;
+			++t.tv_sec;
+		}
+		while (DiskAsyncBusy
+			&& (0 == pthread_cond_timedwait(&DiskAsyncCond,
+				&DiskAsyncMutex, &t)))
+		{
+		}
+		if (DiskAsyncBusy) {
+			++DiskAsyncStatLate;
+		}
+
+		v = trueblnr;
+	}
+	pthread_mutex_unlock(&DiskAsyncMutex);
+
+	return v;
+}
+
+GLOBALOSGLUFUNC blnr vSonyTransferDone(blnr Wait,
+	tMacErr *r, ui5r *Sony_ActCount)
+{
+	blnr v = falseblnr;
+
+	pthread_mutex_lock(&DiskAsyncMutex);
+	while (Wait && DiskAsyncBusy) {
+		pthread_cond_wait(&DiskAsyncCond, &DiskAsyncMutex);
+	}
+	if (DiskAsyncHave) {
+		*r = DiskAsyncErr;
+		*Sony_ActCount = DiskAsyncActCount;
+		DiskAsyncHave = falseblnr;
+		v = trueblnr;
+	}
+	pthread_mutex_unlock(&DiskAsyncMutex);
+
+	return v;
+}
+
+LOCALPROC DiskAsync_UnInit(void)
+{
+	if (DiskAsyncStarted) {
+		pthread_mutex_lock(&DiskAsyncMutex);
+		DiskAsyncQuit = trueblnr;
+		pthread_cond_broadcast(&DiskAsyncCond);
+		pthread_mutex_unlock(&DiskAsyncMutex);
+		(void) pthread_join(DiskAsyncThread, NULL);
+		DiskAsyncStarted = falseblnr;
+
+		fprintf(stderr,
+			"async disk: %u transfers, %u finished later\n",
+			(unsigned int)DiskAsyncStatStarted,
+			(unsigned int)DiskAsyncStatLate);
+	}
+}
+#endif
+
+GLOBALOSGLUFUNC tMacErr vSonyTransfer(blnr IsWrite, ui3p Buffer,
+	tDrive Drive_No, ui5r Sony_Start, ui5r Sony_Count,
+	ui5r *Sony_ActCount)
+{
+#if IncludeSonyAsync
+	DiskAsyncWaitIdle();
+#endif
+
+	return vSonyTransfer0(IsWrite, Buffer, Drive_No,
+		Sony_Start, Sony_Count, Sony_ActCount);
+}
+
 GLOBALOSGLUFUNC tMacErr vSonyGetSize(tDrive Drive_No, ui5r *Sony_Count)
 {
 	tMacErr err = mnvm_miscErr;
 	FILE *refnum = Drives[Drive_No];
 	long v;
 
+#if IncludeSonyAsync
+	DiskAsyncWaitIdle();
+#endif
+
+#if MapDiskImages
+	if (NULL != DriveMaps[Drive_No]) {
+		*Sony_Count = DriveMapSizes[Drive_No];
+		err = mnvm_noErr;
+	} else
+#endif
 	if (0 == fseek(refnum, 0, SEEK_END)) {
 		v = ftell(refnum);
 		if (v >= 0) {
@@ -622,6 +959,14 @@ LOCALFUNC tMacErr vSonyEject0(tDrive Drive_No, blnr deleteit)
 
 	DiskEjectedNotify(Drive_No);
 
+#if IncludeSonyAsync
+	DiskAsyncWaitIdle();
+#endif
+
+#if MapDiskImages
+	DriveMapClose(Drive_No);
+#endif
+
 #if HaveAdvisoryLocks
 	MyUnlockFile(refnum);
 #endif
@@ -666,6 +1011,10 @@ LOCALPROC UnInitDrives(void)
 			(void) vSonyEject(i);
 		}
 	}
+
+#if IncludeSonyAsync
+	DiskAsync_UnInit();
+#endif
 }
 
 #if IncludeSonyGetName
@@ -703,6 +1052,9 @@ LOCALFUNC blnr Sony_Insert0(FILE *refnum, blnr locked,
 #endif
 		{
 			Drives[Drive_No] = refnum;
+#if MapDiskImages
+			DriveMapOpen(Drive_No, locked);
+#endif
 			DiskInsertNotify(Drive_No, locked);
 
 #if IncludeSonyGetName || IncludeSonyNew
@@ -746,6 +1098,49 @@ LOCALFUNC blnr Sony_Insert1(char *drivepath, blnr silentfail)
 	return falseblnr;
 }
 
+#if EnableEvtReplay
+#include "EVTRPLAY.h"
+#define Sony_Insert1h EvtRply_Sony_Insert1
+#else
+#define Sony_Insert1h Sony_Insert1
+#endif
+
+#if UseScrnCapt || UseSndCapt
+#include "CAPTWRTR.h"
+#endif
+
+#if UseScrnCapt
+#include "SCRNCAPT.h"
+#endif
+
+#if UseScrnVrfy
+#include "SCRNVRFY.h"
+#endif
+
+#if MySoundEnabled
+#include "SNDWAVFL.h"
+#endif
+
+#if UseSndCapt
+#include "SNDCAPT.h"
+#endif
+
+#if IncludeSonyAsync
+LOCALFUNC blnr DiskAsync_Init(void)
+{
+#if EnableEvtReplay
+	if (DiskAsyncWant && (kEvtRplyOff != EvtRplyMode)) {
+		/* when a transfer is done depends on the host */
+		fprintf(stderr,
+			"--async-disk isn't used when recording or replaying\n");
+		DiskAsyncWant = falseblnr;
+	}
+#endif
+
+	return trueblnr;
+}
+#endif
+
 LOCALFUNC tMacErr LoadMacRomFrom(char *path)
 {
 	tMacErr err;
@@ -783,7 +1178,7 @@ LOCALFUNC blnr Sony_Insert1a(char *drivepath, blnr silentfail)
 	if (! ROM_loaded) {
 		v = (mnvm_noErr == LoadMacRomFrom(drivepath));
 	} else {
-		v = Sony_Insert1(drivepath, silentfail);
+		v = Sony_Insert1h(drivepath, silentfail);
 	}
 
 	return v;
@@ -799,12 +1194,12 @@ LOCALFUNC blnr Sony_Insert2(char *s)
 	blnr IsOk = falseblnr;
 
 	if (NULL == d) {
-		IsOk = Sony_Insert1(s, trueblnr);
+		IsOk = Sony_Insert1h(s, trueblnr);
 	} else {
 		char *t;
 
 		if (mnvm_noErr == ChildPath(d, s, &t)) {
-			IsOk = Sony_Insert1(t, trueblnr);
+			IsOk = Sony_Insert1h(t, trueblnr);
 			free(t);
 		}
 	}
@@ -1212,6 +1607,180 @@ LOCALVAR ui3p ScalingBuff = nullpr;
 #endif /* WantScalingBuff */
 
 
+#ifndef MayUseXShm
+#define MayUseXShm 0
+#endif
+
+#define UseXShm (MayUseXShm && UseColorImage)
+
+#if UseXShm
+
+/*
+	With the MIT-SHM extension, ScalingBuff is put in
+	shared memory, so the screen mappers write straight
+	into what the X server reads, instead of every update
+	being copied through the X connection. Not available
+	for remote displays, in which case the ordinary
+	XPutImage path is used.
+*/
+
+LOCALVAR blnr NoXShm = falseblnr; /* set by --no-shm */
+LOCALVAR blnr HaveXShm = falseblnr;
+LOCALVAR blnr XShmAttachFailed;
+LOCALVAR XShmSegmentInfo MyShmInfo;
+LOCALVAR XImage *my_shm_image = NULL;
+#if EnableMagnify
+LOCALVAR XImage *my_shm_Scaled_image = NULL;
+#endif
+LOCALVAR ui3p MyShmSaveScalingBuff = nullpr;
+LOCALVAR int MyShmCompletionType;
+LOCALVAR int MyShmPending = 0;
+	/*
+		number of XShmPutImage calls still in progress,
+		don't change ScalingBuff until they are done.
+	*/
+
+LOCALFUNC int MyShmErrorHandler(Display *dpy, XErrorEvent *ev)
+{
+	UnusedParam(dpy);
+	UnusedParam(ev);
+
+	XShmAttachFailed = trueblnr;
+	return 0;
+}
+
+LOCALFUNC Bool MyShmIsCompletion(Display *dpy, XEvent *ev, XPointer arg)
+{
+	UnusedParam(dpy);
+	UnusedParam(arg);
+
+	return (ev->type == MyShmCompletionType) ? True : False;
+}
+
+LOCALPROC MyShmWaitDone(void)
+{
+	XEvent event;
+
+	while (MyShmPending > 0) {
+		XIfEvent(x_display, &event, MyShmIsCompletion, NULL);
+		--MyShmPending;
+	}
+}
+
+LOCALPROC MyShmDestroyImage(XImage **p)
+{
+	if (NULL != *p) {
+		(*p)->data = NULL; /* don't let Xlib free shared memory */
+		XDestroyImage(*p);
+		*p = NULL;
+	}
+}
+
+LOCALFUNC XImage *MyShmCreateImage(Visual *Xvisual,
+	unsigned int width, unsigned int height)
+{
+	XImage *image = XShmCreateImage(x_display, Xvisual, 24,
+		ZPixmap, MyShmInfo.shmaddr, &MyShmInfo, width, height);
+
+	if (NULL != image) {
+		/* the screen mappers assume this layout */
+		if ((32 != image->bits_per_pixel)
+			|| ((4 * width) != (unsigned int)image->bytes_per_line))
+		{
+			MyShmDestroyImage(&image);
+		}
+	}
+
+	return image;
+}
+
+LOCALPROC MyShmInit(Visual *Xvisual)
+{
+	int (*SaveErrorHandler)(Display *, XErrorEvent *);
+
+	if (NoXShm || ! XShmQueryExtension(x_display)) {
+		return;
+	}
+
+	MyShmInfo.shmid = shmget(IPC_PRIVATE, ScalingBuffsz,
+		IPC_CREAT | 0600);
+	if (MyShmInfo.shmid < 0) {
+		return;
+	}
+	MyShmInfo.shmaddr = shmat(MyShmInfo.shmid, NULL, 0);
+	MyShmInfo.readOnly = False;
+	if ((char *)-1 == MyShmInfo.shmaddr) {
+		(void) shmctl(MyShmInfo.shmid, IPC_RMID, NULL);
+		return;
+	}
+
+	/*
+		XShmAttach fails asynchronously when the server
+		can't get at our memory, such as for a remote
+		display, so catch the error.
+	*/
+	XShmAttachFailed = falseblnr;
+	XSync(x_display, False);
+	SaveErrorHandler = XSetErrorHandler(MyShmErrorHandler);
+	(void) XShmAttach(x_display, &MyShmInfo);
+	XSync(x_display, False);
+	(void) XSetErrorHandler(SaveErrorHandler);
+
+	/* segment goes away once both sides have detached */
+	(void) shmctl(MyShmInfo.shmid, IPC_RMID, NULL);
+
+	if (! XShmAttachFailed) {
+		my_shm_image = MyShmCreateImage(Xvisual,
+			vMacScreenWidth, vMacScreenHeight);
+#if EnableMagnify
+		my_shm_Scaled_image = MyShmCreateImage(Xvisual,
+			vMacScreenWidth * MyWindowScale,
+			vMacScreenHeight * MyWindowScale);
+#endif
+		if ((NULL != my_shm_image)
+#if EnableMagnify
+			&& (NULL != my_shm_Scaled_image)
+#endif
+			)
+		{
+			MyShmSaveScalingBuff = ScalingBuff;
+			ScalingBuff = (ui3p)MyShmInfo.shmaddr;
+			MyShmCompletionType =
+				XShmGetEventBase(x_display) + ShmCompletion;
+			HaveXShm = trueblnr;
+			return;
+		}
+
+		MyShmDestroyImage(&my_shm_image);
+#if EnableMagnify
+		MyShmDestroyImage(&my_shm_Scaled_image);
+#endif
+		(void) XShmDetach(x_display, &MyShmInfo);
+		XSync(x_display, False);
+	}
+
+	(void) shmdt(MyShmInfo.shmaddr);
+}
+
+LOCALPROC MyShmUnInit(void)
+{
+	if (HaveXShm) {
+		MyShmWaitDone();
+		MyShmDestroyImage(&my_shm_image);
+#if EnableMagnify
+		MyShmDestroyImage(&my_shm_Scaled_image);
+#endif
+		(void) XShmDetach(x_display, &MyShmInfo);
+		XSync(x_display, False);
+		(void) shmdt(MyShmInfo.shmaddr);
+		ScalingBuff = MyShmSaveScalingBuff;
+		HaveXShm = falseblnr;
+	}
+}
+
+#endif /* UseXShm */
+
+
 #if EnableMagnify && ! UseColorImage
 LOCALPROC SetUpScalingTabl(void)
 {
@@ -1336,6 +1905,121 @@ LOCALPROC SetUpBW2ColorTabl(void)
 #endif
 
 
+#if EnableMagnify && UseColorImage
+#include "SCRNMAPV.h"
+#endif
+
+
+#ifndef MayUseFrmPace
+#define MayUseFrmPace 0
+#endif
+
+#define UseFrmPace MayUseFrmPace
+
+#if UseFrmPace
+#include "FRMPACE.h"
+#endif
+
+#ifndef MayUseScrnScal
+#define MayUseScrnScal 0
+#endif
+
+#define UseScrnScal (MayUseScrnScal && MayFullScreen \
+	&& UseColorImage && (0 == vMacScreenDepth))
+
+#if UseScrnScal
+
+/*
+	In full screen mode, rather than drawing at MyWindowScale
+	in the middle of the screen, SCRNSCAL.h scales to fill it,
+	into a buffer the size of the whole screen.
+*/
+
+#include "SCRNSCAL.h"
+
+LOCALVAR blnr ScrnScalOn = falseblnr;
+LOCALVAR XImage *my_fs_image = NULL;
+
+LOCALPROC MyScrnScalDisposeImage(void)
+{
+	if (NULL != my_fs_image) {
+		my_fs_image->data = NULL; /* belongs to SCRNSCAL.h */
+		XDestroyImage(my_fs_image);
+		my_fs_image = NULL;
+	}
+}
+
+LOCALFUNC blnr MyScrnScalInit(unsigned int wr, unsigned int hr)
+{
+	if ((kScrnScalOff == ScrnScalMode)
+		|| ! ScrnScal_Setup(wr, hr, ScrnScalMode, 0xFFFFFF, 0))
+	{
+		return falseblnr;
+	}
+
+	if ((NULL != my_fs_image)
+		&& ((unsigned int)my_fs_image->width == wr)
+		&& ((unsigned int)my_fs_image->height == hr))
+	{
+		return trueblnr;
+	}
+
+	MyScrnScalDisposeImage();
+	my_fs_image = XCreateImage(x_display,
+		DefaultVisual(x_display, DefaultScreen(x_display)),
+		24, ZPixmap, 0, NULL, wr, hr, 32, 4 * wr);
+	if (NULL == my_fs_image) {
+		return falseblnr;
+	}
+
+	return trueblnr;
+}
+
+LOCALPROC MyScrnScalUnInit(void)
+{
+	MyScrnScalDisposeImage();
+	ScrnScal_UnSetup();
+}
+
+/* send part of the scaled buffer, in window coordinates */
+LOCALPROC MyScrnScalPut(int top, int left, int bottom, int right)
+{
+	if (top < 0) {
+		top = 0;
+	}
+	if (left < 0) {
+		left = 0;
+	}
+	if (bottom > ScrnScal_Height) {
+		bottom = ScrnScal_Height;
+	}
+	if (right > ScrnScal_Width) {
+		right = ScrnScal_Width;
+	}
+
+	if ((top < bottom) && (left < right)) {
+		my_fs_image->data = (char *)ScrnScal_Buff;
+		XPutImage(x_display, my_main_wind, my_gc, my_fs_image,
+			left, top, left, top, right - left, bottom - top);
+		my_fs_image->data = NULL;
+	}
+}
+
+LOCALPROC MyScrnScalDraw(ui4r top, ui4r left,
+	ui4r bottom, ui4r right)
+{
+	ScrnRect r;
+
+	if (ScrnScal_DrawRect(GetCurDrawBuff(),
+		top, left, bottom, right, &r))
+	{
+		MyScrnScalPut(r.top, r.left, r.bottom, r.right);
+	}
+}
+
+#endif /* UseScrnScal */
+
+
 #if EnableMagnify && ! UseColorImage
 
 #define ScrnMapr_DoMap UpdateScaledBWCopy
@@ -1442,6 +2126,13 @@ LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
 	int YDest;
 	char *the_data;
 
+#if UseScrnScal
+	if (ScrnScalOn) {
+		MyScrnScalDraw(top, left, bottom, right);
+		goto label_exit;
+	}
+#endif
+
 #if VarFullScreen
 	if (UseFullScreen)
 #endif
@@ -1533,6 +2224,18 @@ LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
 		}
 #endif /* UseColorImage */
 
+#if UseXShm
+		if (HaveXShm) {
+			XShmPutImage(x_display, my_main_wind, my_gc,
+				my_shm_Scaled_image,
+				left * MyWindowScale, top * MyWindowScale,
+				XDest, YDest,
+				(right - left) * MyWindowScale,
+				(bottom - top) * MyWindowScale,
+				True);
+			++MyShmPending;
+		} else
+#endif
 		{
 			char *saveData = my_Scaled_image->data;
 			my_Scaled_image->data = (char *)ScalingBuff;
@@ -1588,6 +2291,16 @@ LOCALPROC HaveChangedScreenBuff(ui4r top, ui4r left,
 		}
 #endif /* UseColorImage */
 
+#if UseXShm
+		if (HaveXShm) {
+			XShmPutImage(x_display, my_main_wind, my_gc,
+				my_shm_image,
+				left, top, XDest, YDest,
+				right - left, bottom - top,
+				True);
+			++MyShmPending;
+		} else
+#endif
 		{
 			char *saveData = my_image->data;
 			my_image->data = the_data;
@@ -1608,9 +2321,17 @@ label_exit:
 
 LOCALPROC MyDrawChangesAndClear(void)
 {
+	int i;
+
 	if (ScreenChangedBottom > ScreenChangedTop) {
-		HaveChangedScreenBuff(ScreenChangedTop, ScreenChangedLeft,
-			ScreenChangedBottom, ScreenChangedRight);
+#if UseXShm
+		MyShmWaitDone();
+#endif
+		for (i = 0; i < ScreenDamageN; ++i) {
+			HaveChangedScreenBuff(
+				ScreenDamage[i].top, ScreenDamage[i].left,
+				ScreenDamage[i].bottom, ScreenDamage[i].right);
+		}
 		ScreenClearChanges();
 	}
 }
@@ -1693,32 +2414,40 @@ LOCALFUNC blnr MyMoveMouse(si4b h, si4b v)
 	blnr IsOk;
 	int attempts = 0;
 
+#if UseScrnScal
+	if (ScrnScalOn) {
+		h = ScrnScal_FromSrcH(h);
+		v = ScrnScal_FromSrcV(v);
+	} else
+#endif
+	{
 #if VarFullScreen
-	if (UseFullScreen)
+		if (UseFullScreen)
 #endif
 #if MayFullScreen
-	{
-		h -= ViewHStart;
-		v -= ViewVStart;
-	}
+		{
+			h -= ViewHStart;
+			v -= ViewVStart;
+		}
 #endif
 
 #if EnableMagnify
-	if (UseMagnify) {
-		h *= MyWindowScale;
-		v *= MyWindowScale;
-	}
+		if (UseMagnify) {
+			h *= MyWindowScale;
+			v *= MyWindowScale;
+		}
 #endif
 
 #if VarFullScreen
-	if (UseFullScreen)
+		if (UseFullScreen)
 #endif
 #if MayFullScreen
-	{
-		h += hOffset;
-		v += vOffset;
-	}
+		{
+			h += hOffset;
+			v += vOffset;
+		}
 #endif
+	}
 
 	do {
 		XWarpPointer(x_display, None, my_main_wind, 0, 0, 0, 0, h, v);
@@ -1795,32 +2524,40 @@ LOCALPROC MousePositionNotify(int NewMousePosh, int NewMousePosv)
 {
 	blnr ShouldHaveCursorHidden = trueblnr;
 
+#if UseScrnScal
+	if (ScrnScalOn) {
+		NewMousePosh = ScrnScal_ToSrcH(NewMousePosh);
+		NewMousePosv = ScrnScal_ToSrcV(NewMousePosv);
+	} else
+#endif
+	{
 #if VarFullScreen
-	if (UseFullScreen)
+		if (UseFullScreen)
 #endif
 #if MayFullScreen
-	{
-		NewMousePosh -= hOffset;
-		NewMousePosv -= vOffset;
-	}
+		{
+			NewMousePosh -= hOffset;
+			NewMousePosv -= vOffset;
+		}
 #endif
 
 #if EnableMagnify
-	if (UseMagnify) {
-		NewMousePosh /= MyWindowScale;
-		NewMousePosv /= MyWindowScale;
-	}
+		if (UseMagnify) {
+			NewMousePosh /= MyWindowScale;
+			NewMousePosv /= MyWindowScale;
+		}
 #endif
 
 #if VarFullScreen
-	if (UseFullScreen)
+		if (UseFullScreen)
 #endif
 #if MayFullScreen
-	{
-		NewMousePosh += ViewHStart;
-		NewMousePosv += ViewVStart;
-	}
+		{
+			NewMousePosh += ViewHStart;
+			NewMousePosv += ViewVStart;
+		}
 #endif
+	}
 
 #if EnableFSMouseMotion
 	if (HaveMouseMotion) {
@@ -3133,12 +3870,19 @@ LOCALPROC GetCurrentTicks(void)
 
 #define MyInvTimeStep 16626 /* TicksPerSecond / 60.14742 */
 
+#if UseFrmPace
+LOCALVAR ui5b MyTickStep = MyInvTimeStep;
+	/* may be changed to lock to the display */
+#else
+#define MyTickStep MyInvTimeStep
+#endif
+
 LOCALVAR ui5b NextTimeSec;
 LOCALVAR ui5b NextTimeUsec;
 
 LOCALPROC IncrNextTime(void)
 {
-	NextTimeUsec += MyInvTimeStep;
+	NextTimeUsec += MyTickStep;
 	if (NextTimeUsec >= TicksPerSecond) {
 		NextTimeUsec -= TicksPerSecond;
 		NextTimeSec += 1;
@@ -3198,6 +3942,203 @@ LOCALPROC UpdateTrueEmulatedTime(void)
 	}
 }
 
+#if UseFrmPace
+
+/*
+	RandR, for the refresh rate, is loaded when needed,
+	like ALSA, so that it isn't needed to run. The rate comes
+	from the timings of the mode the window's monitor is in,
+	not XRRConfigCurrentRate, which rounds to a whole Hz
+	(59.94 Hz would be taken as 60, and the pacing would
+	drift a frame every 17 seconds).
+
+	The structures are as in Xrandr.h, for version 1.2 on.
+*/
+
+typedef XID MyRRCrtc;
+typedef XID MyRRMode;
+
+typedef struct {
+	MyRRMode id;
+	unsigned int width;
+	unsigned int height;
+	unsigned long dotClock;
+	unsigned int hSyncStart;
+	unsigned int hSyncEnd;
+	unsigned int hTotal;
+	unsigned int hSkew;
+	unsigned int vSyncStart;
+	unsigned int vSyncEnd;
+	unsigned int vTotal;
+	char *name;
+	unsigned int nameLength;
+	unsigned long modeFlags;
+} MyXRRModeInfo;
+
+typedef struct {
+	Time timestamp;
+	Time configTimestamp;
+	int ncrtc;
+	MyRRCrtc *crtcs;
+	int noutput;
+	XID *outputs;
+	int nmode;
+	MyXRRModeInfo *modes;
+} MyXRRScreenResources;
+
+typedef struct {
+	Time timestamp;
+	int x;
+	int y;
+	unsigned int width;
+	unsigned int height;
+	MyRRMode mode;
+	unsigned short rotation;
+	int noutput;
+	XID *outputs;
+	unsigned short rotations;
+	int npossible;
+	XID *possible;
+} MyXRRCrtcInfo;
+
+#define MyRR_Interlace 0x00000010
+#define MyRR_DoubleScan 0x00000020
+
+typedef MyXRRScreenResources * (*XRRGetScreenResourcesCurrentProcPtr)
+	(Display *dpy, Window window);
+typedef void (*XRRFreeScreenResourcesProcPtr)
+	(MyXRRScreenResources *resources);
+typedef MyXRRCrtcInfo * (*XRRGetCrtcInfoProcPtr)
+	(Display *dpy, MyXRRScreenResources *resources, MyRRCrtc crtc);
+typedef void (*XRRFreeCrtcInfoProcPtr)(MyXRRCrtcInfo *crtcInfo);
+
+LOCALFUNC ui5r MyModeRate(MyXRRScreenResources *res, MyRRMode mode)
+{
+	/* in mHz, 0 if not known */
+	int i;
+	double r;
+	MyXRRModeInfo *m;
+
+	for (i = 0; i < res->nmode; ++i) {
+		m = &res->modes[i];
+		if ((m->id == mode) && (0 != m->hTotal) && (0 != m->vTotal)) {
+			r = 1000.0 * (double)m->dotClock
+				/ ((double)m->hTotal * (double)m->vTotal);
+			if (0 != (m->modeFlags & MyRR_Interlace)) {
+				r *= 2;
+			}
+			if (0 != (m->modeFlags & MyRR_DoubleScan)) {
+				r /= 2;
+			}
+			return (ui5r)(r + 0.5);
+		}
+	}
+
+	return 0;
+}
+
+LOCALFUNC ui5r MyGetRefreshRate(void)
+{
+	/*
+		in mHz, 0 if not known. Of the monitor the middle of
+		the window is on, else the first one that is on.
+	*/
+	XRRGetScreenResourcesCurrentProcPtr MyXRRGetScreenResourcesCurrent;
+	XRRFreeScreenResourcesProcPtr MyXRRFreeScreenResources;
+	XRRGetCrtcInfoProcPtr MyXRRGetCrtcInfo;
+	XRRFreeCrtcInfoProcPtr MyXRRFreeCrtcInfo;
+	MyXRRScreenResources *res;
+	MyXRRCrtcInfo *crtc;
+	Window rootwin = DefaultRootWindow(x_display);
+	Window childwin;
+	XWindowAttributes attr;
+	int x = 0;
+	int y = 0;
+	int i;
+	ui5r v;
+	ui5r r = 0;
+	void *h = dlopen("libXrandr.so.2", RTLD_NOW);
+
+	if (NULL == h) {
+		fprintf(stderr, "dlopen libXrandr failed\n");
+	} else {
+		MyXRRGetScreenResourcesCurrent =
+			(XRRGetScreenResourcesCurrentProcPtr)
+			dlsym(h, "XRRGetScreenResourcesCurrent");
+		MyXRRFreeScreenResources = (XRRFreeScreenResourcesProcPtr)
+			dlsym(h, "XRRFreeScreenResources");
+		MyXRRGetCrtcInfo = (XRRGetCrtcInfoProcPtr)
+			dlsym(h, "XRRGetCrtcInfo");
+		MyXRRFreeCrtcInfo = (XRRFreeCrtcInfoProcPtr)
+			dlsym(h, "XRRFreeCrtcInfo");
+		if ((NULL != MyXRRGetScreenResourcesCurrent)
+			&& (NULL != MyXRRFreeScreenResources)
+			&& (NULL != MyXRRGetCrtcInfo)
+			&& (NULL != MyXRRFreeCrtcInfo))
+		{
+			if (XGetWindowAttributes(x_display, my_main_wind, &attr))
+			{
+				(void) XTranslateCoordinates(x_display, my_main_wind,
+					rootwin, attr.width / 2, attr.height / 2,
+					&x, &y, &childwin);
+			}
+			res = MyXRRGetScreenResourcesCurrent(x_display, rootwin);
+			if (NULL != res) {
+				for (i = 0; i < res->ncrtc; ++i) {
+					crtc = MyXRRGetCrtcInfo(x_display, res,
+						res->crtcs[i]);
+					if (NULL != crtc) {
+						if (None != crtc->mode) {
+							v = MyModeRate(res, crtc->mode);
+							if ((0 == r)
+								|| ((x >= crtc->x) && (y >= crtc->y)
+								&& (x < crtc->x + (int)crtc->width)
+								&& (y < crtc->y + (int)crtc->height)))
+							{
+								if (0 != v) {
+									r = v;
+								}
+							}
+						}
+						MyXRRFreeCrtcInfo(crtc);
+					}
+				}
+				MyXRRFreeScreenResources(res);
+			}
+		}
+		(void) dlclose(h);
+	}
+
+	return r;
+}
+
+#define MyPaceNow() (LastTimeSec * 1000000 + LastTimeUsec)
+
+LOCALVAR ui5r MyFrmPaceFrames = 0;
+	/* ScreenChangedFrames when last checked */
+
+LOCALPROC MyFrmPaceInit(void)
+{
+	/*
+		X doesn't say when the vertical blank is,
+		so this can only keep to the rate.
+	*/
+	FrmPace_SetRate(MyGetRefreshRate(), falseblnr);
+	MyTickStep = FrmPace_TickMicros();
+}
+
+LOCALPROC MyFrmPaceCheck(void)
+{
+	/* call just after GetCurrentTicks */
+	if (FrmPace_Due(MyPaceNow())) {
+		MyDrawChangesAndClear();
+		XFlush(x_display);
+		FrmPace_Presented(MyPaceNow());
+	}
+}
+
+#endif /* UseFrmPace */
+
 LOCALFUNC blnr CheckDateTime(void)
 {
 	if (CurMacDateInSeconds != NewMacDateInSeconds) {
@@ -3245,54 +4186,170 @@ LOCALFUNC blnr InitLocationDat(void)
 #define dbglog_SoundStuff (0 && dbglog_HAVE)
 #define dbglog_SoundBuffStats (0 && dbglog_HAVE)
 
+#ifndef MayUseSoundThread
+#define MayUseSoundThread 0
+#endif
+
+#define UseSoundThread MayUseSoundThread
+
+#if UseSoundThread
+/*
+	TheSoundBuffer is then a single producer, single consumer
+	ring. The emulation only moves TheFillOffset, a block at a
+	time, and the sound thread (see SGLUALSA.h) only moves
+	ThePlayOffset, so no lock is needed, just ordering.
+
+	Where one side stores and then loads what the other side
+	stores (the sound thread going idle, the emulation filling
+	a block), MySoundAtomicFence goes in between, since release
+	and acquire alone let the load pass the store, and then both
+	can miss the other's store.
+*/
+#define MySoundAtomicGet(v) __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define MySoundAtomicPut(v, x) \
+	__atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+#define MySoundAtomicFence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define MySoundAtomicGet(v) (v)
+#define MySoundAtomicPut(v, x) (v) = (x)
+#define MySoundAtomicFence()
+#endif
+
+#if UseSoundThread
+/*
+	With --audio-latency-ms, the blocks are made smaller (down to
+	32 samples), and fewer are kept filled, so that a sound starts
+	playing sooner. TheSoundBuffer stays kAllBuffLen long.
+*/
+LOCALVAR ui5r MySoundLatencyMs = 0; /* 0 for the usual */
+LOCALVAR ui3r MySoundLnOneBuffLen = kLnOneBuffLen;
+LOCALVAR ui4r MySoundMinFilledWant = DesiredMinFilledSoundBuffs;
+LOCALVAR ui4r MySoundDevBuffLen = kAllBuffLen;
+#define MySoundOneBuffLen ((ui4r)1 << MySoundLnOneBuffLen)
+
+LOCALPROC MySound_SetLatency(void)
+{
+	ui5r n = (MySoundLatencyMs * 22255 + 500) / 1000;
+		/* in samples, at SOUND_SAMPLERATE */
+
+	if (0 != MySoundLatencyMs) {
+		/* about four blocks of latency */
+		MySoundLnOneBuffLen = 5;
+		while ((MySoundLnOneBuffLen < kLnOneBuffLen)
+			&& (((ui5r)2 << MySoundLnOneBuffLen) <= n / 4))
+		{
+			++MySoundLnOneBuffLen;
+		}
+		MySoundMinFilledWant = n >> MySoundLnOneBuffLen;
+		if (MySoundMinFilledWant < 2) {
+			MySoundMinFilledWant = 2;
+		} else if (MySoundMinFilledWant
+			> (kAllBuffLen >> MySoundLnOneBuffLen) - 3)
+		{
+			MySoundMinFilledWant =
+				(kAllBuffLen >> MySoundLnOneBuffLen) - 3;
+		}
+
+		/* room for a few blocks more, if the emulation gets ahead */
+		MySoundDevBuffLen = (MySoundMinFilledWant + 3)
+			<< MySoundLnOneBuffLen;
+	}
+}
+#else
+#define MySoundLnOneBuffLen kLnOneBuffLen
+#define MySoundMinFilledWant DesiredMinFilledSoundBuffs
+#define MySoundOneBuffLen kOneBuffLen
+#endif
+#define MySoundOneBuffMask (MySoundOneBuffLen - 1)
+
 LOCALVAR tpSoundSamp TheSoundBuffer = nullpr;
 LOCALVAR ui4b ThePlayOffset;
 LOCALVAR ui4b TheFillOffset;
 LOCALVAR ui4b TheWriteOffset;
 LOCALVAR ui4b MinFilledSoundBuffs;
 
+#if UseSoundThread
+LOCALVAR blnr MySoundDropping = falseblnr;
+LOCALVAR ui5r MySoundStatDropped = 0;
+#endif
+
+#if UseSndCapt
+LOCALVAR tpSoundSamp MySoundWritePtr; /* for SndCapt_Samples */
+#define MySoundWriteRet(p) return (MySoundWritePtr = (p))
+#else
+#define MySoundWriteRet(p) return (p)
+#endif
+
 LOCALPROC MySound_Start0(void)
 {
 	/* Reset variables */
 	ThePlayOffset = 0;
 	TheFillOffset = 0;
 	TheWriteOffset = 0;
-	MinFilledSoundBuffs = kSoundBuffers;
+	MinFilledSoundBuffs = kAllBuffLen >> MySoundLnOneBuffLen;
 }
 
 GLOBALOSGLUFUNC tpSoundSamp MySound_BeginWrite(ui4r n, ui4r *actL)
 {
-	ui4b ToFillLen = kAllBuffLen - (TheWriteOffset - ThePlayOffset);
+	ui4b ToFillLen = kAllBuffLen
+		- (TheWriteOffset - MySoundAtomicGet(ThePlayOffset));
 	ui4b WriteBuffContig =
-		kOneBuffLen - (TheWriteOffset & kOneBuffMask);
+		MySoundOneBuffLen - (TheWriteOffset & MySoundOneBuffMask);
 
 	if (WriteBuffContig < n) {
 		n = WriteBuffContig;
 	}
 	if (ToFillLen < n) {
-		/* overwrite previous buffer */
 #if dbglog_SoundStuff
 		dbglog_writeln("sound buffer over flow");
 #endif
+#if UseSoundThread
+		/*
+			the sound thread may be playing the previous buffer,
+			so throw these samples away instead, into the spare
+			block past the end of TheSoundBuffer.
+		*/
+		MySoundDropping = trueblnr;
+		*actL = n;
+		MySoundWriteRet(TheSoundBuffer + kAllBuffLen
+			+ (TheWriteOffset & MySoundOneBuffMask));
+#else
+		/* overwrite previous buffer */
 		TheWriteOffset -= kOneBuffLen;
+#endif
 	}
 
 	*actL = n;
-	return TheSoundBuffer + (TheWriteOffset & kAllBuffMask);
+	MySoundWriteRet(TheSoundBuffer + (TheWriteOffset & kAllBuffMask));
 }
 
 LOCALFUNC blnr MySound_EndWrite0(ui4r actL)
 {
 	blnr v;
 
+#if UseSndCapt
+	SndCapt_Samples(MySoundWritePtr, actL);
+#endif
+
+#if UseSoundThread
+	if (MySoundDropping) {
+		MySoundDropping = falseblnr;
+		MySoundStatDropped += actL;
+		return falseblnr;
+	}
+#endif
+
 	TheWriteOffset += actL;
 
-	if (0 != (TheWriteOffset & kOneBuffMask)) {
+	if (0 != (TheWriteOffset & MySoundOneBuffMask)) {
 		v = falseblnr;
 	} else {
 		/* just finished a block */
 
+#if ! UseSoundThread
+		/* with the thread, done by MySound_EndWrite */
 		TheFillOffset = TheWriteOffset;
+#endif
 
 		v = trueblnr;
 	}
@@ -3300,20 +4357,33 @@ LOCALFUNC blnr MySound_EndWrite0(ui4r actL)
 	return v;
 }
 
+#if WantSoundAutoSlow
+GLOBALOSGLUFUNC ui5r MySound_Wanted(void)
+{
+	ui4b Filled = TheWriteOffset - MySoundAtomicGet(ThePlayOffset);
+	ui4b Want = MySoundMinFilledWant << MySoundLnOneBuffLen;
+
+	return (Filled < Want) ? (Want - Filled) : 0;
+}
+#endif
+
 LOCALPROC MySound_SecondNotify0(void)
 {
-	if (MinFilledSoundBuffs > DesiredMinFilledSoundBuffs) {
+	ui4b MinFilled = MySoundAtomicGet(MinFilledSoundBuffs);
+
+	if (MinFilled > MySoundMinFilledWant) {
 #if dbglog_SoundStuff
 			dbglog_writeln("MinFilledSoundBuffs too high");
 #endif
 		IncrNextTime();
-	} else if (MinFilledSoundBuffs < DesiredMinFilledSoundBuffs) {
+	} else if (MinFilled < MySoundMinFilledWant) {
 #if dbglog_SoundStuff
 			dbglog_writeln("MinFilledSoundBuffs too low");
 #endif
 		++TrueEmulatedTime;
 	}
-	MinFilledSoundBuffs = kSoundBuffers;
+	MySoundAtomicPut(MinFilledSoundBuffs,
+		kAllBuffLen >> MySoundLnOneBuffLen);
 }
 
 #define SOUND_SAMPLERATE 22255 /* = round(7833600 * 2 / 704) */
@@ -3476,6 +4546,9 @@ LOCALPROC HTCEimport_do(void)
 GLOBALOSGLUFUNC tMacErr HTCEimport(tPbuf *r)
 {
 	HTCEimport_do();
+#if EnableEvtReplay
+	EvtRply_ClipImport(&MyClipBuffer);
+#endif
 
 	return NativeTextToMacRomanPbuf((char *)MyClipBuffer, r);
 }
@@ -4033,6 +5106,14 @@ LOCALPROC HandleTheEvent(XEvent *theEvent)
 				dbglog_writeln("- event - Expose");
 #endif
 
+#if UseScrnScal
+				if (ScrnScalOn) {
+					MyScrnScalPut(y0, x0, y1, x1);
+					NeedFinishOpen1 = falseblnr;
+					break;
+				}
+#endif
+
 #if VarFullScreen
 				if (UseFullScreen)
 #endif
@@ -4079,6 +5160,9 @@ LOCALPROC HandleTheEvent(XEvent *theEvent)
 					y1 = vMacScreenHeight;
 				}
 				if ((x0 < x1) && (y0 < y1)) {
+#if UseXShm
+					MyShmWaitDone();
+#endif
 					HaveChangedScreenBuff(y0, x0, y1, x1);
 				}
 
@@ -4251,6 +5335,13 @@ LOCALPROC HandleTheEvent(XEvent *theEvent)
 			}
 			break;
 		default:
+#if UseXShm
+			if ((theEvent->type == MyShmCompletionType)
+				&& (MyShmPending > 0))
+			{
+				--MyShmPending;
+			}
+#endif
 			break;
 	}
 }
@@ -4382,6 +5473,10 @@ LOCALFUNC blnr Screen_Init(void)
 	}
 #endif
 
+#if UseXShm
+	MyShmInit(Xvisual);
+#endif
+
 #if 0 != vMacScreenDepth
 	ColorModeWorks = trueblnr;
 #endif
@@ -4393,6 +5488,9 @@ LOCALFUNC blnr Screen_Init(void)
 
 LOCALPROC CloseMainWindow(void)
 {
+#if UseXShm
+	MyShmWaitDone();
+#endif
 	if (my_gc != NULL) {
 		XFreeGC(x_display, my_gc);
 		my_gc = NULL;
@@ -4481,25 +5579,39 @@ LOCALFUNC blnr CreateMainWindow(void)
 #endif
 #if MayFullScreen
 	{
-		ViewHSize = wr;
-		ViewVSize = hr;
-#if EnableMagnify
-		if (UseMagnify) {
-			ViewHSize /= MyWindowScale;
-			ViewVSize /= MyWindowScale;
-		}
-#endif
-		if (ViewHSize >= vMacScreenWidth) {
+#if UseScrnScal
+		ScrnScalOn = MyScrnScalInit(wr, hr);
+		if (ScrnScalOn) {
+			/* whole emulated screen is shown */
 			ViewHStart = 0;
-			ViewHSize = vMacScreenWidth;
-		} else {
-			ViewHSize &= ~ 1;
-		}
-		if (ViewVSize >= vMacScreenHeight) {
 			ViewVStart = 0;
+			ViewHSize = vMacScreenWidth;
 			ViewVSize = vMacScreenHeight;
-		} else {
-			ViewVSize &= ~ 1;
+			leftPos = ScrnScal_Dst.left;
+			topPos = ScrnScal_Dst.top;
+		} else
+#endif
+		{
+			ViewHSize = wr;
+			ViewVSize = hr;
+#if EnableMagnify
+			if (UseMagnify) {
+				ViewHSize /= MyWindowScale;
+				ViewVSize /= MyWindowScale;
+			}
+#endif
+			if (ViewHSize >= vMacScreenWidth) {
+				ViewHStart = 0;
+				ViewHSize = vMacScreenWidth;
+			} else {
+				ViewHSize &= ~ 1;
+			}
+			if (ViewVSize >= vMacScreenHeight) {
+				ViewVStart = 0;
+				ViewVSize = vMacScreenHeight;
+			} else {
+				ViewVSize &= ~ 1;
+			}
 		}
 	}
 #endif
@@ -4509,6 +5621,9 @@ LOCALFUNC blnr CreateMainWindow(void)
 #endif
 #if MayNotFullScreen
 	{
+#if UseScrnScal
+		ScrnScalOn = falseblnr;
+#endif
 #if EnableMagnify
 		if (UseMagnify) {
 			WinIndx = kMagStateMagnifgy;
@@ -4753,6 +5868,9 @@ struct MyWState {
 #if EnableMagnify
 	blnr f_UseMagnify;
 #endif
+#if UseScrnScal
+	blnr f_ScrnScalOn;
+#endif
 };
 typedef struct MyWState MyWState;
 #endif
@@ -4776,6 +5894,9 @@ LOCALPROC GetMyWState(MyWState *r)
 #if EnableMagnify
 	r->f_UseMagnify = UseMagnify;
 #endif
+#if UseScrnScal
+	r->f_ScrnScalOn = ScrnScalOn;
+#endif
 }
 #endif
 
@@ -4798,6 +5919,9 @@ LOCALPROC SetMyWState(MyWState *r)
 #if EnableMagnify
 	UseMagnify = r->f_UseMagnify;
 #endif
+#if UseScrnScal
+	ScrnScalOn = r->f_ScrnScalOn;
+#endif
 }
 #endif
 
@@ -5311,6 +6435,126 @@ label_retry:
 #define UsingAlsa 0
 #endif
 
+#if EnableEvtReplay
+			if (0 == strcmp(pa, "--record"))
+			{
+				if (i < my_argc) {
+					EvtRplyRecordPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--replay"))
+			{
+				if (i < my_argc) {
+					EvtRplyReplayPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+#endif
+#if UseScrnCapt
+			if (0 == strcmp(pa, "--capture"))
+			{
+				if (i < my_argc) {
+					ScrnCaptPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+#endif
+#if IncludeSonyAsync
+			if (0 == strcmp(pa, "--async-disk"))
+			{
+				DiskAsyncWant = trueblnr;
+				goto label_retry;
+			} else
+#endif
+#if UseSndCapt
+			if (0 == strcmp(pa, "--sound-capture"))
+			{
+				if (i < my_argc) {
+					SndCaptPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+#endif
+#if UseScrnVrfy
+			if (0 == strcmp(pa, "--hash-record"))
+			{
+				if (i < my_argc) {
+					ScrnVrfyRecordPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--hash-check"))
+			{
+				if (i < my_argc) {
+					ScrnVrfyCheckPath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--hash-every"))
+			{
+				if (i < my_argc) {
+					ScrnVrfyEvery =
+						(ui5r)strtoul(my_argv[i++], NULL, 10);
+					goto label_retry;
+				}
+			} else
+#endif
+#if UseFrmPace
+			if (0 == strcmp(pa, "--frame-pacing"))
+			{
+				if (i < my_argc) {
+					pa = my_argv[i++];
+					if (0 == strcmp(pa, "off")) {
+						FrmPaceMode = kFrmPaceOff;
+					} else if (0 == strcmp(pa, "on")) {
+						FrmPaceMode = kFrmPaceOn;
+					} else if (0 == strcmp(pa, "lock")) {
+						FrmPaceMode = kFrmPaceLock;
+					} else {
+						MacMsg(kStrBadArgTitle, kStrBadArgMessage,
+							falseblnr);
+					}
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--refresh-rate"))
+			{
+				if (i < my_argc) {
+					FrmPaceForceRate = (ui5r)(1000.0
+						* strtod(my_argv[i++], NULL) + 0.5);
+					goto label_retry;
+				}
+			} else
+#endif
+#if UseScrnScal
+			if (0 == strcmp(pa, "--fs-scale"))
+			{
+				if (i < my_argc) {
+					pa = my_argv[i++];
+					if (0 == strcmp(pa, "off")) {
+						ScrnScalMode = kScrnScalOff;
+					} else if (0 == strcmp(pa, "integer")) {
+						ScrnScalMode = kScrnScalInteger;
+					} else if (0 == strcmp(pa, "nearest")) {
+						ScrnScalMode = kScrnScalNearest;
+					} else if (0 == strcmp(pa, "sharp")) {
+						ScrnScalMode = kScrnScalSharp;
+					} else {
+						MacMsg(kStrBadArgTitle, kStrBadArgMessage,
+							falseblnr);
+					}
+					goto label_retry;
+				}
+			} else
+#endif
+#if UseXShm
+			if (0 == strcmp(pa, "--no-shm"))
+			{
+				NoXShm = trueblnr;
+				goto label_retry;
+			} else
+#endif
 #if UsingAlsa
 			if ((0 == strcmp(pa, "--alsadev"))
 				|| (0 == strcmp(pa, "-alsadev")))
@@ -5321,6 +6565,79 @@ label_retry:
 				}
 			} else
 #endif
+#if MySoundEnabled && UseSoundThread
+			if (0 == strcmp(pa, "--sound-file"))
+			{
+				if (i < my_argc) {
+					MySoundFilePath = my_argv[i++];
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--sound-sink"))
+			{
+				if (i < my_argc) {
+					pa = my_argv[i++];
+					if (0 == strcmp(pa, "auto")) {
+						MySoundSinkWant = kMySoundSinkNone;
+					} else if (0 == strcmp(pa, "pulse")) {
+						MySoundSinkWant = kMySoundSinkPulse;
+					} else if (0 == strcmp(pa, "alsa")) {
+						MySoundSinkWant = kMySoundSinkAlsa;
+					} else if (0 == strcmp(pa, "null")) {
+						MySoundSinkWant = kMySoundSinkNull;
+					} else {
+						MacMsg(kStrBadArgTitle, kStrBadArgMessage,
+							falseblnr);
+					}
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--audio-latency-ms"))
+			{
+				if (i < my_argc) {
+					MySoundLatencyMs = strtoul(my_argv[i++], NULL, 10);
+					if ((MySoundLatencyMs < 5)
+						|| (MySoundLatencyMs > 250))
+					{
+						MySoundLatencyMs = 0;
+						MacMsg(kStrBadArgTitle, kStrBadArgMessage,
+							falseblnr);
+					}
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--sound-rate"))
+			{
+				if (i < my_argc) {
+					RsmpWantRate = strtoul(my_argv[i++], NULL, 10);
+					if ((RsmpWantRate < 8000)
+						|| (RsmpWantRate > 192000))
+					{
+						RsmpWantRate = WantInitRsmpRate;
+						MacMsg(kStrBadArgTitle, kStrBadArgMessage,
+							falseblnr);
+					}
+					goto label_retry;
+				}
+			} else
+			if (0 == strcmp(pa, "--sound-resample"))
+			{
+				if (i < my_argc) {
+					pa = my_argv[i++];
+					if (0 == strcmp(pa, "off")) {
+						RsmpMode = kRsmpOff;
+					} else if (0 == strcmp(pa, "linear")) {
+						RsmpMode = kRsmpLinear;
+					} else if (0 == strcmp(pa, "sinc")) {
+						RsmpMode = kRsmpSinc;
+					} else {
+						MacMsg(kStrBadArgTitle, kStrBadArgMessage,
+							falseblnr);
+					}
+					goto label_retry;
+				}
+			} else
+#endif
 #if 0
 			if (0 == strcmp(pa, "-l")) {
 				SpeedValue = 0;
@@ -5347,6 +6664,19 @@ GLOBALOSGLUPROC DoneWithDrawingForTick(void)
 	if (HaveMouseMotion) {
 		AutoScrollScreen();
 	}
+#endif
+#if UseFrmPace
+	if (FrmPaceOn && ! CurSpeedStopped) {
+		/* leave it for MyFrmPaceCheck */
+		if ((MyFrmPaceFrames != ScreenChangedFrames)
+			|| ((ScreenChangedBottom > ScreenChangedTop)
+				&& ! FrmPaceWaiting))
+		{
+			MyFrmPaceFrames = ScreenChangedFrames;
+			FrmPace_FrameDone();
+		}
+		return;
+	}
 #endif
 	MyDrawChangesAndClear();
 	XFlush(x_display);
@@ -5355,7 +6685,16 @@ GLOBALOSGLUPROC DoneWithDrawingForTick(void)
 GLOBALOSGLUFUNC blnr ExtraTimeNotOver(void)
 {
 	UpdateTrueEmulatedTime();
+#if UseFrmPace
+	if (FrmPaceOn) {
+		MyFrmPaceCheck();
+	}
+#endif
+#if EnableEvtReplay
+	return EvtRply_ExtraTime(TrueEmulatedTime == OnTrueTime);
+#else
 	return TrueEmulatedTime == OnTrueTime;
+#endif
 }
 
 LOCALPROC WaitForTheNextEvent(void)
@@ -5379,6 +6718,9 @@ LOCALPROC CheckForSystemEvents(void)
 
 GLOBALOSGLUPROC WaitForNextTick(void)
 {
+#if EnableEvtReplay
+	EvtRply_TickBegin();
+#endif
 label_retry:
 	CheckForSystemEvents();
 	CheckForSavedTasks();
@@ -5398,6 +6740,16 @@ label_retry:
 
 		si5b TimeDiff = GetTimeDiff();
 		if (TimeDiff < 0) {
+#if UseFrmPace
+			if (FrmPaceOn) {
+				/* wake up for the next present too */
+				ui5r w = FrmPace_Wait(MyPaceNow());
+
+				if (w < (ui5r)(- TimeDiff)) {
+					TimeDiff = - (si5b)w;
+				}
+			}
+#endif
 			rqt.tv_sec = 0;
 			rqt.tv_nsec = (- TimeDiff) * 1000;
 			(void) nanosleep(&rqt, &rmt);
@@ -5424,6 +6776,9 @@ label_retry:
 	}
 
 	OnTrueTime = TrueEmulatedTime;
+#if EnableEvtReplay
+	EvtRply_TickEnd();
+#endif
 
 #if dbglog_TimeStuff
 	dbglog_writelnNum("WaitForNextTick, OnTrueTime", OnTrueTime);
@@ -6097,6 +7452,21 @@ LOCALFUNC blnr InitOSGLU(void)
 	if (ActvCodeInit())
 #endif
 	if (InitLocationDat())
+#if EnableEvtReplay
+	if (EvtRply_Init())
+#endif
+#if IncludeSonyAsync
+	if (DiskAsync_Init())
+#endif
+#if UseScrnCapt
+	if (ScrnCapt_Init())
+#endif
+#if UseSndCapt
+	if (SndCapt_Init())
+#endif
+#if UseScrnVrfy
+	if (ScrnVrfy_Init())
+#endif
 #if MySoundEnabled
 	if (MySound_Init())
 #endif
@@ -6109,6 +7479,9 @@ LOCALFUNC blnr InitOSGLU(void)
 #endif
 	if (WaitForRom())
 	{
+#if UseFrmPace
+		MyFrmPaceInit();
+#endif
 		return trueblnr;
 	}
 	return falseblnr;
@@ -6123,6 +7496,18 @@ LOCALPROC UnInitOSGLU(void)
 #if EmLocalTalk
 	UnInitLocalTalk();
 #endif
+#if UseScrnVrfy
+	ScrnVrfy_UnInit();
+#endif
+#if UseSndCapt
+	SndCapt_UnInit();
+#endif
+#if UseScrnCapt
+	ScrnCapt_UnInit();
+#endif
+#if EnableEvtReplay
+	EvtRply_UnInit();
+#endif
 
 	RestoreKeyRepeat();
 #if MayFullScreen
@@ -6143,10 +7528,21 @@ LOCALPROC UnInitOSGLU(void)
 	UnInitDrives();
 
 	ForceShowCursor();
+
+#if UseFrmPace
+	FrmPace_Report();
+#endif
+
 	if (blankCursor != None) {
 		XFreeCursor(x_display, blankCursor);
 	}
 
+#if UseXShm
+	MyShmUnInit();
+#endif
+#if UseScrnScal
+	MyScrnScalUnInit();
+#endif
 	if (my_image != NULL) {
 		XDestroyImage(my_image);
 	}
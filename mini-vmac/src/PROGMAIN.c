@@ -113,6 +113,9 @@ LOCALPROC SubTickNotify(int SubTick)
 	dbglog_writeNum(SubTick);
 	dbglog_writeReturn();
 #endif
+#if WantSoundSubTick
+	SoundSubTick = SubTick;
+#endif
 #if EmClassicSnd
 	MacSound_SubTick(SubTick);
 #elif EmASC
@@ -127,6 +130,29 @@ LOCALPROC SubTickNotify(int SubTick)
 
 LOCALVAR ui4r SubTickCounter;
 
+#if UseLazySubTick
+LOCALVAR blnr SubTickLazy = falseblnr;
+	/*
+		the end of sub tick SubTickCounter, at SubTickDue,
+		has no task scheduled. it and any later ones are made
+		by SubTickTaskSync.
+	*/
+LOCALVAR iCountt SubTickDue;
+#endif
+
+LOCALPROC SubTickTaskNext(void)
+{
+#if UseLazySubTick
+	if (! ASC_SubTickSeen()) {
+		SubTickDue = GetCuriCount() + CyclesScaledPerSubTick;
+		SubTickLazy = trueblnr;
+	} else
+#endif
+	{
+		ICT_add(kICT_SubTick, CyclesScaledPerSubTick);
+	}
+}
+
 LOCALPROC SubTickTaskDo(void)
 {
 	SubTickNotify(SubTickCounter);
@@ -138,18 +164,59 @@ LOCALPROC SubTickTaskDo(void)
 			might not equal CyclesScaledPerTick.
 		*/
 
-		ICT_add(kICT_SubTick, CyclesScaledPerSubTick);
+		SubTickTaskNext();
+	}
+}
+
+#if UseLazySubTick
+GLOBALPROC SubTickTaskSync(void)
+{
+	/*
+		Called by the ASC before and after the emulated
+		program looks at it or changes it. Makes the sub
+		ticks that would have ended by now, and if the
+		ASC can now be seen to make the next one (it is
+		playing from the FIFO, or could start to), goes
+		back to ending a cpu slice there.
+	*/
+	if (SubTickLazy) {
+		iCountt t = GetCuriCount();
+
+		while ((SubTickCounter < (kNumSubTicks - 1))
+			&& ((si5r)(t - SubTickDue) >= 0))
+		{
+			SubTickNotify(SubTickCounter);
+			++SubTickCounter;
+			SubTickDue += CyclesScaledPerSubTick;
+		}
+
+		if (SubTickCounter >= (kNumSubTicks - 1)) {
+			SubTickLazy = falseblnr;
+		} else if (ASC_SubTickSeen()) {
+			SubTickLazy = falseblnr;
+			ICT_add(kICT_SubTick, SubTickDue - t);
+		}
 	}
 }
+#endif
 
 LOCALPROC SubTickTaskStart(void)
 {
 	SubTickCounter = 0;
-	ICT_add(kICT_SubTick, CyclesScaledPerSubTick);
+	SubTickTaskNext();
 }
 
 LOCALPROC SubTickTaskEnd(void)
 {
+#if UseLazySubTick
+	if (SubTickLazy) {
+		while (SubTickCounter < (kNumSubTicks - 1)) {
+			SubTickNotify(SubTickCounter);
+			++SubTickCounter;
+		}
+		SubTickLazy = falseblnr;
+	}
+#endif
 	SubTickNotify(kNumSubTicks - 1);
 }
 
@@ -235,6 +302,9 @@ GLOBALPROC EmulationReserveAlloc(void)
 #if SmallGlobals
 	MINEM68K_ReserveAlloc();
 #endif
+#if EmASC && IncludeExtnModPlayer
+	ExtnModPlayer_ReserveAlloc();
+#endif
 }
 
 LOCALFUNC blnr InitEmulation(void)
@@ -381,12 +451,28 @@ LOCALPROC m68k_go_nCycles_1(ui5b n)
 #endif
 		NextiCount += n2;
 		m68k_go_nCycles(n2);
+#if WantSliceStats
+		++SliceStatCount;
+		SliceStatCycles += n2 >> kLn2CycleScale;
+#endif
 		n = StopiCount - NextiCount;
 	} while (n != 0);
 }
 
 LOCALVAR ui5b ExtraSubTicksToDo = 0;
 
+#define UseSoundAutoSlow (EnableAutoSlow && WantSoundAutoSlow && EmASC)
+
+#if UseSoundAutoSlow
+LOCALVAR ui5b SoundSubTicksToDo = 0;
+	/*
+		extra sub ticks AutoSlow still allows when quiet,
+		in proportion to how far the host sound buffer is
+		below its level, so sound doesn't run dry, but
+		isn't made faster than it can be played either.
+	*/
+#endif
+
 LOCALPROC DoEmulateOneTick(void)
 {
 #if EnableAutoSlow
@@ -427,6 +513,10 @@ LOCALPROC DoEmulateOneTick(void)
 			ExtraSubTicksToDo = ExtraLimit;
 		}
 	}
+
+#if UseSoundAutoSlow
+	SoundSubTicksToDo = ASC_SubTicksFor(MySound_Wanted());
+#endif
 }
 
 LOCALFUNC blnr MoreSubTicksToDo(void)
@@ -437,7 +527,11 @@ LOCALFUNC blnr MoreSubTicksToDo(void)
 #if EnableAutoSlow
 		if ((QuietSubTicks >= kAutoSlowSubTicks)
 			&& (QuietTime >= kAutoSlowTime)
-			&& ! WantNotAutoSlow)
+			&& ! WantNotAutoSlow
+#if UseSoundAutoSlow
+			&& (0 == SoundSubTicksToDo)
+#endif
+			)
 		{
 			ExtraSubTicksToDo = 0;
 		} else
@@ -477,6 +571,11 @@ LOCALPROC DoEmulateExtraTime(void)
 #endif
 			m68k_go_nCycles_1(CyclesScaledPerSubTick);
 			--ExtraSubTicksToDo;
+#if UseSoundAutoSlow
+			if (SoundSubTicksToDo > 0) {
+				--SoundSubTicksToDo;
+			}
+#endif
 		} while (MoreSubTicksToDo());
 		ExtraTimeEndNotify();
 	}
@@ -491,6 +590,32 @@ LOCALVAR ui5b CurEmulatedTime = 0;
 		"DoEmulateOneTick" has been called.
 	*/
 
+#ifndef kCatchUpMaxLag
+#define kCatchUpMaxLag 16
+#endif
+	/*
+		If emulation is more than this many ticks
+		behind, give up on the excess.
+	*/
+
+#ifndef kCatchUpSpread
+#define kCatchUpSpread 4
+#endif
+	/*
+		Spread catching up over about this many
+		ticks, rather than doing it all at once.
+	*/
+
+#ifndef kCatchUpFrameEvery
+#define kCatchUpFrameEvery 4
+#endif
+	/*
+		While catching up, still draw every
+		this many ticks.
+	*/
+
+LOCALVAR ui3r CatchUpFrameCount = 0;
+
 LOCALPROC RunEmulatedTicksToTrueTime(void)
 {
 	/*
@@ -498,9 +623,18 @@ LOCALPROC RunEmulatedTicksToTrueTime(void)
 		once per tick.
 
 		But if emulation is lagging, we'll try to
-		catch up by calling DoEmulateOneTick multiple
-		times, unless we're too far behind, in
-		which case we forget it.
+		catch up by calling DoEmulateOneTick some
+		extra times, unless we're too far behind, in
+		which case we forget the excess.
+
+		Rather than running all the missed ticks
+		back to back with video disabled, which
+		looks like a freeze followed by a jump,
+		only a fraction of the lag is made up
+		each time, so emulation runs somewhat faster
+		than real time for a few ticks. Every
+		kCatchUpFrameEvery catch up ticks is
+		still drawn.
 
 		If emulating one tick takes longer than
 		a tick we don't want to sit here
@@ -511,7 +645,7 @@ LOCALPROC RunEmulatedTicksToTrueTime(void)
 		CurEmulatedTime >= TrueEmulatedTime.
 	*/
 
-	si3b n = OnTrueTime - CurEmulatedTime;
+	si5b n = (si5b)(OnTrueTime - CurEmulatedTime);
 
 	if (n > 0) {
 		DoEmulateOneTick();
@@ -519,27 +653,41 @@ LOCALPROC RunEmulatedTicksToTrueTime(void)
 
 		DoneWithDrawingForTick();
 
-		if (n > 8) {
+		if (n > kCatchUpMaxLag) {
 			/* emulation not fast enough */
-			n = 8;
+#if WantLagStats
+			LagStatDropped += n - kCatchUpMaxLag;
+#endif
+			n = kCatchUpMaxLag;
 			CurEmulatedTime = OnTrueTime - n;
 		}
 
-		if (ExtraTimeNotOver() && (--n > 0)) {
+		if ((--n > 0) && ExtraTimeNotOver()) {
 			/* lagging, catch up */
-
-			EmVideoDisable = trueblnr;
+			si5b k = (n + kCatchUpSpread - 1) / kCatchUpSpread;
 
 			do {
-				DoEmulateOneTick();
+				if (++CatchUpFrameCount >= kCatchUpFrameEvery) {
+					CatchUpFrameCount = 0;
+					DoEmulateOneTick();
+					DoneWithDrawingForTick();
+				} else {
+					EmVideoDisable = trueblnr;
+					DoEmulateOneTick();
+					EmVideoDisable = falseblnr;
+				}
 				++CurEmulatedTime;
-			} while (ExtraTimeNotOver()
-				&& (--n > 0));
-
-			EmVideoDisable = falseblnr;
+#if WantLagStats
+				++LagStatCatchUp;
+#endif
+			} while ((--n > 0) && (--k > 0)
+				&& ExtraTimeNotOver());
 		}
 
 		EmLagTime = n;
+#if WantLagStats
+		++LagStatHist[(n < kLagStatHistSz) ? n : kLagStatHistSz - 1];
+#endif
 	}
 }
 
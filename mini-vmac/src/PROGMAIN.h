@@ -23,3 +23,4 @@
 
 EXPORTPROC EmulationReserveAlloc(void);
 EXPORTPROC ProgramMain(void);
+EXPORTPROC SubTickTaskSync(void);
@@ -180,6 +180,50 @@ LOCALVAR const ui3b my_disk_icon[] = {
 };
 #endif
 
+#if UseSonyPatch && IncludeSonyAsync
+LOCALVAR const ui3b sony_done[] = {
+/*
+	Finishes a Prime call the driver returned "in progress" for.
+	Sony_Update gets here the same way as to DUpdate of the
+	driver, once the transfer is done. Gets the result and DCtlPtr
+	with kCmndSonyDone, then calls IODone, as an interrupt
+	handler of the real driver would. Followed by its own copy of
+	TailData.
+
+	SDone
+		MOVEM.L    D0-D3/A0-A3,-(SP)
+		SUBQ       #6, A7 ; room for DCtlPtr, result of the I/O
+		SUBQ       #2, A7 ; room for result code
+		MOVE.W     #kCmndSonyDone, -(A7)
+
+		LEA        STailData, A0
+		MOVE.L     (A0)+, -(A7)
+		MOVEA.L    (A0), A0
+		MOVE.L     A7, (A0)
+
+		ADDA.W     #6, A7
+		MOVE.W     (A7)+, D1 ; result code
+		MOVEA.L    (A7)+, A1 ; DCtlPtr
+		MOVE.W     (A7)+, D0 ; result of the I/O
+		TST.W      D1
+		BNE.S      @1
+		MOVEA.L    JIODone, A0
+		JSR        (A0)
+	@1
+		MOVEM.L    (SP)+, D0-D3/A0-A3
+		ADDA.W     #4, A7 ; remove argument from stack
+		RTE
+	STailData
+*/
+0x48, 0xE7, 0xF0, 0xF0, 0x5D, 0x4F, 0x55, 0x4F,
+0x3F, 0x3C, 0x00, 0x09, 0x41, 0xFA, 0x00, 0x22,
+0x2F, 0x18, 0x20, 0x50, 0x20, 0x8F, 0x5C, 0x4F,
+0x32, 0x1F, 0x22, 0x5F, 0x30, 0x1F, 0x4A, 0x41,
+0x66, 0x06, 0x20, 0x78, 0x08, 0xFC, 0x4E, 0x90,
+0x4C, 0xDF, 0x0F, 0x0F, 0x58, 0x4F, 0x4E, 0x73
+};
+#endif
+
 #if CurEmMd <= kEmMd_Twig43
 #define Sony_DriverBase 0x1836
 #elif CurEmMd <= kEmMd_Twiggy
@@ -225,6 +269,19 @@ LOCALPROC Sony_Install(void)
 	MyMoveBytes((anyp)my_disk_icon, (anyp)pto, sizeof(my_disk_icon));
 	pto += sizeof(my_disk_icon);
 
+#if IncludeSonyAsync
+	my_sony_done_addr = (pto - ROM) + kROM_Base;
+	MyMoveBytes((anyp)sony_done, (anyp)pto, sizeof(sony_done));
+	pto += sizeof(sony_done);
+
+	do_put_mem_word(pto, kcom_callcheck);
+	pto += 2;
+	do_put_mem_word(pto, kExtnSony);
+	pto += 2;
+	do_put_mem_long(pto, kExtn_Block_Base); /* pokeaddr */
+	pto += 4;
+#endif
+
 #if UseLargeScreenHack
 	{
 		ui3p patchp = pto;
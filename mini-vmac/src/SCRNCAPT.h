@@ -0,0 +1,194 @@
+/*
+	SCRNCAPT.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	SCReeN CAPTure
+
+	Write every change to the (1 bit) emulated screen to a file,
+	so a session can be turned into a video afterwards, exactly
+	as it was shown. Screen_OutputFrame hands over the rectangles
+	ScreenFindChangedRects found, by which time screencomparebuff
+	holds what they changed to. Just those bytes are logged, along
+	with OnTrueTime, so a frame costs a copy of what changed. The
+	file is written by a separate thread, so the emulation never
+	waits on the disk unless the buffer fills up (see
+	CAPTWRTR.h).
+
+	The file starts with "MnvMCapt", then the version, width and
+	height as 4, 2 and 2 byte little endian numbers. Then come
+	frame records:
+
+		'F', tick (4 bytes), number of rectangles (1 byte),
+		then for each rectangle top, left, bottom, right
+		(2 bytes each, left and right multiples of 8) followed
+		by the rows of the rectangle, (right - left) / 8 bytes
+		each, top row first.
+
+	The first frame is the whole screen. The file ends with
+	'E' and the tick capturing stopped at. CAPTCONV.c turns
+	it into PNG files or a y4m video.
+
+	The OSGLUxxx file includes this after COMOSGLU.h and
+	CAPTWRTR.h, calls ScrnCapt_Init once the screen buffer
+	exists, and ScrnCapt_UnInit when done. ScrnCaptPath is set
+	by the --capture argument.
+*/
+
+#ifdef SCRNCAPT_H
+#error "header already included"
+#else
+#define SCRNCAPT_H
+#endif
+
+#define kScrnCaptVersion 1
+
+#define kScrnCaptTagFrame 'F'
+#define kScrnCaptTagEnd 'E'
+
+#ifndef ScrnCaptBuffSz
+#define ScrnCaptBuffSz (1024 * 1024)
+	/* about 48 full screens */
+#endif
+
+#define ScrnCaptFrameMax (6 + kMaxScrnRects * 8 \
+	+ kMaxScrnRects * vMacScreenMonoNumBytes)
+
+LOCALVAR char *ScrnCaptPath = NULL;
+LOCALVAR FILE *ScrnCaptFile = NULL;
+LOCALVAR blnr ScrnCaptOn = falseblnr;
+
+LOCALVAR ui3p ScrnCaptFrame = nullpr;
+	/* one frame is put together here */
+
+LOCALVAR CaptWrtrR ScrnCaptWrtr;
+
+LOCALVAR ui5r ScrnCaptStatFrames = 0;
+
+LOCALPROC ScrnCapt_Frame(ScrnRect *r, int n)
+{
+	ui3p p;
+	ui3p s;
+	int i;
+	si4b v;
+	si4b left;
+	si4b right;
+	ui4r w;
+
+	if ((! ScrnCaptOn) || (0 == n)) {
+		return;
+	}
+
+	p = ScrnCaptFrame;
+	*p++ = kScrnCaptTagFrame;
+	p = CaptPut4(p, OnTrueTime);
+	*p++ = n;
+
+	for (i = 0; i < n; ++i) {
+		left = r[i].left & ~ 7;
+		right = (r[i].right + 7) & ~ 7;
+		w = (right - left) >> 3;
+
+		p = CaptPut2(p, r[i].top);
+		p = CaptPut2(p, left);
+		p = CaptPut2(p, r[i].bottom);
+		p = CaptPut2(p, right);
+
+		s = screencomparebuff + r[i].top * vMacScreenMonoByteWidth
+			+ (left >> 3);
+		for (v = r[i].top; v < r[i].bottom; ++v) {
+			MyMoveBytes((anyp)s, (anyp)p, w);
+			p += w;
+			s += vMacScreenMonoByteWidth;
+		}
+	}
+
+	CaptWrtr_Put(&ScrnCaptWrtr, ScrnCaptFrame, p - ScrnCaptFrame);
+	++ScrnCaptStatFrames;
+}
+
+LOCALFUNC blnr ScrnCapt_Init(void)
+{
+	ScrnRect r;
+	ui3b h[16];
+
+	if (NULL == ScrnCaptPath) {
+		return trueblnr;
+	}
+
+	ScrnCaptFile = fopen(ScrnCaptPath, "wb");
+	if (NULL == ScrnCaptFile) {
+		fprintf(stderr, "Couldn't create capture %s\n", ScrnCaptPath);
+		return falseblnr;
+	}
+
+	ScrnCaptFrame = (ui3p)malloc(ScrnCaptFrameMax);
+	if (NULL == ScrnCaptFrame) {
+		fprintf(stderr, "out of memory\n");
+		return falseblnr;
+	}
+
+	MyMoveBytes((anyp)"MnvMCapt", (anyp)h, 8);
+	(void) CaptPut2(CaptPut2(
+		CaptPut4(h + 8, kScrnCaptVersion),
+		vMacScreenWidth), vMacScreenHeight);
+	(void) fwrite(h, 1, 16, ScrnCaptFile);
+
+	if (! CaptWrtr_Start(&ScrnCaptWrtr, ScrnCaptFile, ScrnCaptBuffSz)) {
+		return falseblnr;
+	}
+	ScrnCaptOn = trueblnr;
+
+	/* what has been shown so far, the rest are changes to it */
+	r.top = 0;
+	r.left = 0;
+	r.bottom = vMacScreenHeight;
+	r.right = vMacScreenWidth;
+	ScrnCapt_Frame(&r, 1);
+
+	return trueblnr;
+}
+
+LOCALPROC ScrnCapt_UnInit(void)
+{
+	ui3b h[5];
+
+	if (ScrnCaptOn) {
+		h[0] = kScrnCaptTagEnd;
+		(void) CaptPut4(h + 1, OnTrueTime);
+		CaptWrtr_Put(&ScrnCaptWrtr, h, 5);
+
+		CaptWrtr_Stop(&ScrnCaptWrtr);
+		ScrnCaptOn = falseblnr;
+
+		fprintf(stderr,
+			"capture: %u frames, %llu bytes, %u waits for the writer\n",
+			(unsigned int)ScrnCaptStatFrames, ScrnCaptWrtr.StatBytes,
+			(unsigned int)ScrnCaptWrtr.StatWaits);
+	} else {
+		CaptWrtr_Stop(&ScrnCaptWrtr);
+	}
+
+	if (NULL != ScrnCaptFile) {
+		if ((0 != fclose(ScrnCaptFile)) || ScrnCaptWrtr.Failed) {
+			fprintf(stderr, "Couldn't write capture %s\n",
+				ScrnCaptPath);
+		}
+		ScrnCaptFile = NULL;
+	}
+
+	MyMayFree((char *)ScrnCaptFrame);
+	ScrnCaptFrame = nullpr;
+}
@@ -0,0 +1,728 @@
+/*
+	SCRNCHNG.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	SCReeN CHaNGes
+
+	Finding what changed in the emulated screen since it was
+	last drawn, by comparing it with screencomparebuff, for
+	COMOSGLU.h. ScreenFindChangedRects gives up to
+	kMaxScrnRects rectangles, found with ScreenFindMonoRects for
+	a black and white screen, else with the older single box
+	ScreenFindChanges.
+
+	Kept apart so that ChngBench (CHNGBNCH.c) can check the two
+	against each other.
+*/
+
+#ifdef SCRNCHNG_H
+#error "header already included"
+#else
+#define SCRNCHNG_H
+#endif
+
+/*
+	block type - for operating on multiple ui3b elements
+		at a time.
+*/
+
+#if LittleEndianUnaligned || BigEndianUnaligned
+
+#define uibb ui5b
+#define uibr ui5r
+#define ln2uiblockn 2
+
+#if 0
+#define uibb long long
+#define uibr long long
+#define ln2uiblockn 3
+#endif
+
+#else
+
+#define uibb ui3b
+#define uibr ui3r
+#define ln2uiblockn 0
+
+#endif
+
+#define uiblockn (1 << ln2uiblockn)
+#define ln2uiblockbitsn (3 + ln2uiblockn)
+#define uiblockbitsn (8 * uiblockn)
+
+#ifndef WantScrnRowMasks
+#define WantScrnRowMasks 1
+#endif
+
+#define ScrnRowMasks (WantScrnRowMasks \
+	&& (0 == (vMacScreenWidth & 31)) && (vMacScreenWidth <= 1024))
+
+#if (0 != vMacScreenDepth) || ! ScrnRowMasks
+
+LOCALFUNC blnr FindFirstChangeInLVecs(uibb *ptr1, uibb *ptr2,
+					uimr L, uimr *j)
+{
+/*
+	find index of first difference
+*/
+	uibb *p1 = ptr1;
+	uibb *p2 = ptr2;
+	uimr i;
+
+	for (i = L; i != 0; --i) {
+		if (*p1++ != *p2++) {
+			--p1;
+			*j = p1 - ptr1;
+			return trueblnr;
+		}
+	}
+	return falseblnr;
+}
+
+LOCALPROC FindLastChangeInLVecs(uibb *ptr1, uibb *ptr2,
+					uimr L, uimr *j)
+{
+/*
+	find index of last difference, assuming there is one
+*/
+	uibb *p1 = ptr1 + L;
+	uibb *p2 = ptr2 + L;
+
+	while (*--p1 == *--p2) {
+	}
+	*j = p1 - ptr1;
+}
+
+LOCALPROC FindLeftRightChangeInLMat(uibb *ptr1, uibb *ptr2,
+	uimr width, uimr top, uimr bottom,
+	uimr *LeftMin0, uibr *LeftMask0,
+	uimr *RightMax0, uibr *RightMask0)
+{
+	uimr i;
+	uimr j;
+	uibb *p1;
+	uibb *p2;
+	uibr x;
+	ui5r offset = top * width;
+	uibb *p10 = (uibb *)ptr1 + offset;
+	uibb *p20 = (uibb *)ptr2 + offset;
+	uimr LeftMin = *LeftMin0;
+	uimr RightMax = *RightMax0;
+	uibr LeftMask = 0;
+	uibr RightMask = 0;
+	for (i = top; i < bottom; ++i) {
+		p1 = p10;
+		p2 = p20;
+		for (j = 0; j < LeftMin; ++j) {
+			x = *p1++ ^ *p2++;
+			if (0 != x) {
+				LeftMin = j;
+				LeftMask = x;
+				goto Label_3;
+			}
+		}
+		LeftMask |= (*p1 ^ *p2);
+Label_3:
+		p1 = p10 + RightMax;
+		p2 = p20 + RightMax;
+		RightMask |= (*p1++ ^ *p2++);
+		for (j = RightMax + 1; j < width; ++j) {
+			x = *p1++ ^ *p2++;
+			if (0 != x) {
+				RightMax = j;
+				RightMask = x;
+			}
+		}
+
+		p10 += width;
+		p20 += width;
+	}
+	*LeftMin0 = LeftMin;
+	*RightMax0 = RightMax;
+	*LeftMask0 = LeftMask;
+	*RightMask0 = RightMask;
+}
+
+#endif
+
+LOCALVAR ui3p screencomparebuff = nullpr;
+
+LOCALVAR uimr NextDrawRow = 0;
+
+
+#if BigEndianUnaligned
+
+#define FlipCheckMonoBits (uiblockbitsn - 1)
+
+#else
+
+#define FlipCheckMonoBits 7
+
+#endif
+
+#define FlipCheckBits (FlipCheckMonoBits >> vMacScreenDepth)
+
+#ifndef WantColorTransValid
+#define WantColorTransValid 0
+#endif
+
+#if WantColorTransValid
+LOCALVAR blnr ColorTransValid = falseblnr;
+#endif
+
+#ifndef kMaxScrnRects
+#define kMaxScrnRects 8
+#endif
+
+struct ScrnRect {
+	si4b top;
+	si4b left;
+	si4b bottom;
+	si4b right;
+};
+typedef struct ScrnRect ScrnRect;
+
+#if (0 != vMacScreenDepth) || ! ScrnRowMasks
+LOCALFUNC blnr ScreenFindChanges(ui3p screencurrentbuff,
+	si3b TimeAdjust, si4b *top, si4b *left, si4b *bottom, si4b *right)
+{
+	uimr j0;
+	uimr j1;
+	uimr j0h;
+	uimr j1h;
+	uimr j0v;
+	uimr j1v;
+	uimr copysize;
+	uimr copyoffset;
+	uimr copyrows;
+	uimr LimitDrawRow;
+	uimr MaxRowsDrawnPerTick;
+	uimr LeftMin;
+	uimr RightMax;
+	uibr LeftMask;
+	uibr RightMask;
+	int j;
+
+	if (TimeAdjust < 4) {
+		MaxRowsDrawnPerTick = vMacScreenHeight;
+	} else if (TimeAdjust < 6) {
+		MaxRowsDrawnPerTick = vMacScreenHeight / 2;
+	} else {
+		MaxRowsDrawnPerTick = vMacScreenHeight / 4;
+	}
+
+#if 0 != vMacScreenDepth
+	if (UseColorMode) {
+		if (ColorMappingChanged) {
+			ColorMappingChanged = falseblnr;
+			j0h = 0;
+			j1h = vMacScreenWidth;
+			j0v = 0;
+			j1v = vMacScreenHeight;
+#if WantColorTransValid
+			ColorTransValid = falseblnr;
+#endif
+		} else {
+			if (! FindFirstChangeInLVecs(
+				(uibb *)screencurrentbuff
+					+ NextDrawRow * (vMacScreenBitWidth / uiblockbitsn),
+				(uibb *)screencomparebuff
+					+ NextDrawRow * (vMacScreenBitWidth / uiblockbitsn),
+				((uimr)(vMacScreenHeight - NextDrawRow)
+					* (uimr)vMacScreenBitWidth) / uiblockbitsn,
+				&j0))
+			{
+				NextDrawRow = 0;
+				return falseblnr;
+			}
+			j0v = j0 / (vMacScreenBitWidth / uiblockbitsn);
+			j0h = j0 - j0v * (vMacScreenBitWidth / uiblockbitsn);
+			j0v += NextDrawRow;
+			LimitDrawRow = j0v + MaxRowsDrawnPerTick;
+			if (LimitDrawRow >= vMacScreenHeight) {
+				LimitDrawRow = vMacScreenHeight;
+				NextDrawRow = 0;
+			} else {
+				NextDrawRow = LimitDrawRow;
+			}
+			FindLastChangeInLVecs((uibb *)screencurrentbuff,
+				(uibb *)screencomparebuff,
+				((uimr)LimitDrawRow
+					* (uimr)vMacScreenBitWidth) / uiblockbitsn,
+				&j1);
+			j1v = j1 / (vMacScreenBitWidth / uiblockbitsn);
+			j1h = j1 - j1v * (vMacScreenBitWidth / uiblockbitsn);
+			j1v++;
+
+			if (j0h < j1h) {
+				LeftMin = j0h;
+				RightMax = j1h;
+			} else {
+				LeftMin = j1h;
+				RightMax = j0h;
+			}
+
+			FindLeftRightChangeInLMat((uibb *)screencurrentbuff,
+				(uibb *)screencomparebuff,
+				(vMacScreenBitWidth / uiblockbitsn),
+				j0v, j1v, &LeftMin, &LeftMask, &RightMax, &RightMask);
+
+#if vMacScreenDepth > ln2uiblockbitsn
+			j0h =  (LeftMin >> (vMacScreenDepth - ln2uiblockbitsn));
+#elif ln2uiblockbitsn > vMacScreenDepth
+			for (j = 0; j < (1 << (ln2uiblockbitsn - vMacScreenDepth));
+				++j)
+			{
+				if (0 != (LeftMask
+					& (((((uibr)1) << (1 << vMacScreenDepth)) - 1)
+						<< ((j ^ FlipCheckBits) << vMacScreenDepth))))
+				{
+					goto Label_1c;
+				}
+			}
+Label_1c:
+			j0h =  (LeftMin << (ln2uiblockbitsn - vMacScreenDepth)) + j;
+#else
+			j0h =  LeftMin;
+#endif
+
+#if vMacScreenDepth > ln2uiblockbitsn
+			j1h = (RightMax >> (vMacScreenDepth - ln2uiblockbitsn)) + 1;
+#elif ln2uiblockbitsn > vMacScreenDepth
+			for (j = (uiblockbitsn >> vMacScreenDepth); --j >= 0; ) {
+				if (0 != (RightMask
+					& (((((uibr)1) << (1 << vMacScreenDepth)) - 1)
+						<< ((j ^ FlipCheckBits) << vMacScreenDepth))))
+				{
+					goto Label_2c;
+				}
+			}
+Label_2c:
+			j1h = (RightMax << (ln2uiblockbitsn - vMacScreenDepth))
+				+ j + 1;
+#else
+			j1h = RightMax + 1;
+#endif
+		}
+
+		copyrows = j1v - j0v;
+		copyoffset = j0v * vMacScreenByteWidth;
+		copysize = copyrows * vMacScreenByteWidth;
+	} else
+#endif
+	{
+#if 0 != vMacScreenDepth
+		if (ColorMappingChanged) {
+			ColorMappingChanged = falseblnr;
+			j0h = 0;
+			j1h = vMacScreenWidth;
+			j0v = 0;
+			j1v = vMacScreenHeight;
+#if WantColorTransValid
+			ColorTransValid = falseblnr;
+#endif
+		} else
+#endif
+		{
+			if (! FindFirstChangeInLVecs(
+				(uibb *)screencurrentbuff
+					+ NextDrawRow * (vMacScreenWidth / uiblockbitsn),
+				(uibb *)screencomparebuff
+					+ NextDrawRow * (vMacScreenWidth / uiblockbitsn),
+				((uimr)(vMacScreenHeight - NextDrawRow)
+					* (uimr)vMacScreenWidth) / uiblockbitsn,
+				&j0))
+			{
+				NextDrawRow = 0;
+				return falseblnr;
+			}
+			j0v = j0 / (vMacScreenWidth / uiblockbitsn);
+			j0h = j0 - j0v * (vMacScreenWidth / uiblockbitsn);
+			j0v += NextDrawRow;
+			LimitDrawRow = j0v + MaxRowsDrawnPerTick;
+			if (LimitDrawRow >= vMacScreenHeight) {
+				LimitDrawRow = vMacScreenHeight;
+				NextDrawRow = 0;
+			} else {
+				NextDrawRow = LimitDrawRow;
+			}
+			FindLastChangeInLVecs((uibb *)screencurrentbuff,
+				(uibb *)screencomparebuff,
+				((uimr)LimitDrawRow
+					* (uimr)vMacScreenWidth) / uiblockbitsn,
+				&j1);
+			j1v = j1 / (vMacScreenWidth / uiblockbitsn);
+			j1h = j1 - j1v * (vMacScreenWidth / uiblockbitsn);
+			j1v++;
+
+			if (j0h < j1h) {
+				LeftMin = j0h;
+				RightMax = j1h;
+			} else {
+				LeftMin = j1h;
+				RightMax = j0h;
+			}
+
+			FindLeftRightChangeInLMat((uibb *)screencurrentbuff,
+				(uibb *)screencomparebuff,
+				(vMacScreenWidth / uiblockbitsn),
+				j0v, j1v, &LeftMin, &LeftMask, &RightMax, &RightMask);
+
+			for (j = 0; j < uiblockbitsn; ++j) {
+				if (0 != (LeftMask
+					& (((uibr)1) << (j ^ FlipCheckMonoBits))))
+				{
+					goto Label_1;
+				}
+			}
+Label_1:
+			j0h = LeftMin * uiblockbitsn + j;
+
+			for (j = uiblockbitsn; --j >= 0; ) {
+				if (0 != (RightMask
+					& (((uibr)1) << (j ^ FlipCheckMonoBits))))
+				{
+					goto Label_2;
+				}
+			}
+Label_2:
+			j1h = RightMax * uiblockbitsn + j + 1;
+		}
+
+		copyrows = j1v - j0v;
+		copyoffset = j0v * vMacScreenMonoByteWidth;
+		copysize = copyrows * vMacScreenMonoByteWidth;
+	}
+
+	MyMoveBytes((anyp)screencurrentbuff + copyoffset,
+		(anyp)screencomparebuff + copyoffset,
+		copysize);
+
+	*top = j0v;
+	*left = j0h;
+	*bottom = j1v;
+	*right = j1h;
+
+	return trueblnr;
+}
+#endif
+
+#if ScrnRowMasks
+
+/*
+	For a black and white screen, first find which 32 pixel
+	chunks of each row changed, all rows in one pass, which
+	can be done with SIMD compares. Then each run of changed
+	rows, and within it each run of changed chunks, becomes
+	its own rectangle. So two small changes far apart don't
+	turn into one big rectangle.
+*/
+
+#define ScrnRowChunks (vMacScreenWidth >> 5)
+
+LOCALVAR ui5b ScrnRowMask[vMacScreenHeight];
+	/* bit k set if chunk k of the row changed */
+
+typedef void (*ScrnRowMasksP)(ui3p p1, ui3p p2,
+	uimr top, uimr bottom);
+
+LOCALVAR ScrnRowMasksP ScrnRowMasks_Do = nullpr;
+
+LOCALPROC ScrnRowMasks_C(ui3p p1, ui3p p2, uimr top, uimr bottom)
+{
+	uimr i;
+	int k;
+	ui5r m;
+
+	p1 += top * vMacScreenMonoByteWidth;
+	p2 += top * vMacScreenMonoByteWidth;
+	for (i = top; i < bottom; ++i) {
+		m = 0;
+		for (k = 0; k < ScrnRowChunks; ++k) {
+			if ((p1[0] != p2[0]) || (p1[1] != p2[1])
+				|| (p1[2] != p2[2]) || (p1[3] != p2[3]))
+			{
+				m |= ((ui5r)1 << k);
+			}
+			p1 += 4;
+			p2 += 4;
+		}
+		ScrnRowMask[i] = m;
+	}
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+	&& (0 == (ScrnRowChunks & 3))
+#define ScrnRowMasks_X86 1
+#else
+#define ScrnRowMasks_X86 0
+#endif
+
+#if ScrnRowMasks_X86
+
+#include <immintrin.h>
+
+__attribute__((target("sse2")))
+LOCALPROC ScrnRowMasks_SSE2(ui3p p1, ui3p p2, uimr top, uimr bottom)
+{
+	uimr i;
+	int k;
+	ui5r m;
+	__m128i *v1 = (__m128i *)(p1 + top * vMacScreenMonoByteWidth);
+	__m128i *v2 = (__m128i *)(p2 + top * vMacScreenMonoByteWidth);
+
+	for (i = top; i < bottom; ++i) {
+		m = 0;
+		for (k = 0; k < ScrnRowChunks; k += 4) {
+			__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128(v1++),
+				_mm_loadu_si128(v2++));
+
+			m |= (ui5r)(_mm_movemask_ps(_mm_castsi128_ps(eq)) ^ 0xF)
+				<< k;
+		}
+		ScrnRowMask[i] = m;
+	}
+}
+
+#if 0 == (ScrnRowChunks & 7)
+__attribute__((target("avx2")))
+LOCALPROC ScrnRowMasks_AVX2(ui3p p1, ui3p p2, uimr top, uimr bottom)
+{
+	uimr i;
+	int k;
+	ui5r m;
+	__m256i *v1 = (__m256i *)(p1 + top * vMacScreenMonoByteWidth);
+	__m256i *v2 = (__m256i *)(p2 + top * vMacScreenMonoByteWidth);
+
+	for (i = top; i < bottom; ++i) {
+		m = 0;
+		for (k = 0; k < ScrnRowChunks; k += 8) {
+			__m256i eq = _mm256_cmpeq_epi32(
+				_mm256_loadu_si256(v1++), _mm256_loadu_si256(v2++));
+
+			m |= (ui5r)(_mm256_movemask_ps(_mm256_castsi256_ps(eq))
+				^ 0xFF) << k;
+		}
+		ScrnRowMask[i] = m;
+	}
+}
+#endif
+
+#endif /* ScrnRowMasks_X86 */
+
+LOCALPROC ScrnRowMasks_Select(void)
+{
+	ScrnRowMasks_Do = ScrnRowMasks_C;
+#if ScrnRowMasks_X86
+	__builtin_cpu_init();
+#if 0 == (ScrnRowChunks & 7)
+	if (__builtin_cpu_supports("avx2")) {
+		ScrnRowMasks_Do = ScrnRowMasks_AVX2;
+	} else
+#endif
+	if (__builtin_cpu_supports("sse2")) {
+		ScrnRowMasks_Do = ScrnRowMasks_SSE2;
+	}
+#endif
+}
+
+LOCALPROC ScrnRectRefine(ui3p screencurrentbuff, ScrnRect *r)
+{
+	/*
+		r->left and r->right are the first and last changed
+		chunks, narrow them down to pixels.
+	*/
+	ui3b lm[4];
+	ui3b rm[4];
+	ui3p p1;
+	ui3p p2;
+	si4b i;
+	int b;
+	int k;
+
+	for (b = 0; b < 4; ++b) {
+		lm[b] = 0;
+		rm[b] = 0;
+	}
+	for (i = r->top; i < r->bottom; ++i) {
+		p1 = screencurrentbuff + i * vMacScreenMonoByteWidth;
+		p2 = screencomparebuff + i * vMacScreenMonoByteWidth;
+		for (b = 0; b < 4; ++b) {
+			lm[b] |= p1[r->left * 4 + b] ^ p2[r->left * 4 + b];
+			rm[b] |= p1[r->right * 4 + b] ^ p2[r->right * 4 + b];
+		}
+	}
+
+	for (k = 0; k < 32; ++k) {
+		if (0 != (lm[k >> 3] & (0x80 >> (k & 7)))) {
+			break;
+		}
+	}
+	r->left = r->left * 32 + k;
+
+	for (k = 32; --k > 0; ) {
+		if (0 != (rm[k >> 3] & (0x80 >> (k & 7)))) {
+			break;
+		}
+	}
+	r->right = r->right * 32 + k + 1;
+}
+
+LOCALFUNC int ScreenFindMonoRects(ui3p screencurrentbuff,
+	uimr MaxRowsDrawnPerTick, ScrnRect *r)
+{
+	uimr i;
+	uimr i0;
+	uimr j0v;
+	uimr j1v;
+	uimr LimitDrawRow;
+	ui5r u;
+	ui5r run;
+	int c0;
+	int c1;
+	ScrnRect t;
+	int n = 0;
+
+	if (nullpr == ScrnRowMasks_Do) {
+		ScrnRowMasks_Select();
+	}
+	ScrnRowMasks_Do(screencurrentbuff, screencomparebuff,
+		NextDrawRow, vMacScreenHeight);
+
+	for (i = NextDrawRow; i < vMacScreenHeight; ++i) {
+		if (0 != ScrnRowMask[i]) {
+			break;
+		}
+	}
+	if (i >= vMacScreenHeight) {
+		NextDrawRow = 0;
+		return 0;
+	}
+
+	j0v = i;
+	LimitDrawRow = j0v + MaxRowsDrawnPerTick;
+	if (LimitDrawRow >= vMacScreenHeight) {
+		LimitDrawRow = vMacScreenHeight;
+		NextDrawRow = 0;
+	} else {
+		NextDrawRow = LimitDrawRow;
+	}
+
+	j1v = j0v;
+	while (i < LimitDrawRow) {
+		if (0 == ScrnRowMask[i]) {
+			++i;
+		} else {
+			/* a run of changed rows, from i0 to i */
+			i0 = i;
+			u = 0;
+			do {
+				u |= ScrnRowMask[i];
+				++i;
+			} while ((i < LimitDrawRow) && (0 != ScrnRowMask[i]));
+			j1v = i;
+
+			/* each run of changed chunks in it */
+			while (0 != u) {
+				for (c0 = 0; 0 == (u & ((ui5r)1 << c0)); ++c0) {
+				}
+				for (c1 = c0; (c1 + 1 < ScrnRowChunks)
+					&& (0 != (u & ((ui5r)1 << (c1 + 1)))); ++c1)
+				{
+				}
+				run = (((c1 + 1 < 32) ? ((ui5r)1 << (c1 + 1)) : 0)
+					- ((ui5r)1 << c0));
+				u &= ~ run;
+
+				t.top = i0;
+				while (0 == (ScrnRowMask[t.top] & run)) {
+					++t.top;
+				}
+				t.bottom = i;
+				while (0 == (ScrnRowMask[t.bottom - 1] & run)) {
+					--t.bottom;
+				}
+				t.left = c0;
+				t.right = c1;
+
+				if (n < kMaxScrnRects) {
+					r[n++] = t;
+				} else {
+					/* out of room, add to the last one */
+					ScrnRect *p = &r[n - 1];
+
+					if (t.top < p->top) {
+						p->top = t.top;
+					}
+					if (t.bottom > p->bottom) {
+						p->bottom = t.bottom;
+					}
+					if (t.left < p->left) {
+						p->left = t.left;
+					}
+					if (t.right > p->right) {
+						p->right = t.right;
+					}
+				}
+			}
+		}
+	}
+
+	for (c0 = 0; c0 < n; ++c0) {
+		ScrnRectRefine(screencurrentbuff, &r[c0]);
+	}
+
+	MyMoveBytes(
+		(anyp)screencurrentbuff + j0v * vMacScreenMonoByteWidth,
+		(anyp)screencomparebuff + j0v * vMacScreenMonoByteWidth,
+		(j1v - j0v) * vMacScreenMonoByteWidth);
+
+	return n;
+}
+
+#endif /* ScrnRowMasks */
+
+LOCALFUNC int ScreenFindChangedRects(ui3p screencurrentbuff,
+	si3b TimeAdjust, ScrnRect *r)
+{
+	/*
+		fill in r with up to kMaxScrnRects rectangles
+		that have changed, and return how many.
+	*/
+#if ScrnRowMasks
+#if 0 != vMacScreenDepth
+	if (! (UseColorMode || ColorMappingChanged))
+#endif
+	{
+		uimr MaxRowsDrawnPerTick;
+
+		if (TimeAdjust < 4) {
+			MaxRowsDrawnPerTick = vMacScreenHeight;
+		} else if (TimeAdjust < 6) {
+			MaxRowsDrawnPerTick = vMacScreenHeight / 2;
+		} else {
+			MaxRowsDrawnPerTick = vMacScreenHeight / 4;
+		}
+
+		return ScreenFindMonoRects(screencurrentbuff,
+			MaxRowsDrawnPerTick, r);
+	}
+#endif
+#if (0 != vMacScreenDepth) || ! ScrnRowMasks
+	return ScreenFindChanges(screencurrentbuff, TimeAdjust,
+		&r->top, &r->left, &r->bottom, &r->right) ? 1 : 0;
+#endif
+}
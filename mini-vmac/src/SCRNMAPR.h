@@ -45,6 +45,15 @@
 #define ScrnMapr_Scale 1
 #endif
 
+#ifndef ScrnMapr_DstAtRect
+#define ScrnMapr_DstAtRect 0
+	/*
+		1 if ScrnMapr_Dst is where the output for top and left
+		(rounded down to a whole source byte) goes, rather than
+		for the top left of the screen
+	*/
+#endif
+
 /* check of parameters */
 
 #if (ScrnMapr_SrcDepth < 0) || (ScrnMapr_SrcDepth > 3)
@@ -59,6 +68,7 @@
 
 #define ScrnMapr_MapElSz \
 	(ScrnMapr_Scale << (ScrnMapr_DstDepth - ScrnMapr_SrcDepth))
+	/* bytes of one output row per source byte */
 
 #if 0 == (ScrnMapr_MapElSz & 3)
 #define ScrnMapr_TranT ui5b
@@ -72,9 +82,20 @@
 #endif
 
 #define ScrnMapr_TranN (ScrnMapr_MapElSz >> ScrnMapr_TranLn2Sz)
+	/* ScrnMapr_TranT per source byte */
 
 #define ScrnMapr_ScrnWB (vMacScreenWidth >> (3 - ScrnMapr_SrcDepth))
 
+/* vector version from SCRNMAPV.h, if included and available */
+
+#if defined(SCRNMAPV_H) && HaveScrnMapV \
+	&& (0 == ScrnMapr_SrcDepth) && (5 == ScrnMapr_DstDepth) \
+	&& (2 == ScrnMapr_Scale)
+#define ScrnMapr_UseV 1
+#else
+#define ScrnMapr_UseV 0
+#endif
+
 /* now define the procedure */
 
 LOCALPROC ScrnMapr_DoMap(si4b top, si4b left,
@@ -98,16 +119,38 @@ LOCALPROC ScrnMapr_DoMap(si4b top, si4b left,
 	ui4r SrcSkip = ScrnMapr_ScrnWB - jn;
 	ui3b *pSrc = ((ui3b *)ScrnMapr_Src)
 		+ leftB + ScrnMapr_ScrnWB * (ui5r)top;
+#if ScrnMapr_DstAtRect
+	ScrnMapr_TranT *pDst = (ScrnMapr_TranT *)ScrnMapr_Dst;
+#else
 	ScrnMapr_TranT *pDst = ((ScrnMapr_TranT *)ScrnMapr_Dst)
 		+ ((leftB + ScrnMapr_ScrnWB * ScrnMapr_Scale * (ui5r)top)
 			* ScrnMapr_TranN);
+#endif
 	ui5r DstSkip = SrcSkip * ScrnMapr_TranN;
+#if ScrnMapr_Scale > 1
+	ui5r RowSz = jn * ScrnMapr_TranN * sizeof(ScrnMapr_TranT);
+#endif
+#if ScrnMapr_UseV
+	ui5r c0 = ((ScrnMapr_TranT *)ScrnMapr_Map)[0];
+	ui5r c1 = ((ScrnMapr_TranT *)ScrnMapr_Map)[255 * ScrnMapr_TranN];
+
+	if (! ScrnMapV_Selected) {
+		ScrnMapV_Select();
+	}
+#endif
 
 	for (i = bottom - top; --i >= 0; ) {
 #if ScrnMapr_Scale > 1
 		p3 = pDst;
 #endif
 
+#if ScrnMapr_UseV
+		if (nullpr != ScrnMapV_Row1to32x2) {
+			ScrnMapV_Row1to32x2(pSrc, (ui5b *)pDst, jn, c0, c1);
+			pSrc += jn;
+			pDst += jn * ScrnMapr_TranN;
+		} else
+#endif
 		for (j = jn; --j >= 0; ) {
 			t0 = *pSrc++;
 			pMap =
@@ -137,15 +180,13 @@ LOCALPROC ScrnMapr_DoMap(si4b top, si4b left,
 		pDst += DstSkip;
 
 #if ScrnMapr_Scale > 1
+		/* the other rows are the same as the one just done */
 #if ScrnMapr_Scale > 2
 		for (k = ScrnMapr_Scale - 1; --k >= 0; )
 #endif
 		{
-			pMap = p3;
-			for (j = ScrnMapr_TranN * jn; --j >= 0; ) {
-				*pDst++ = *pMap++;
-			}
-			pDst += DstSkip;
+			MyMoveBytes((anyp)p3, (anyp)pDst, RowSz);
+			pDst += jn * ScrnMapr_TranN + DstSkip;
 		}
 #endif /* ScrnMapr_Scale > 1 */
 	}
@@ -153,6 +194,7 @@ LOCALPROC ScrnMapr_DoMap(si4b top, si4b left,
 
 /* undefine template locals and parameters */
 
+#undef ScrnMapr_UseV
 #undef ScrnMapr_ScrnWB
 #undef ScrnMapr_TranN
 #undef ScrnMapr_TranLn2Sz
@@ -166,3 +208,4 @@ LOCALPROC ScrnMapr_DoMap(si4b top, si4b left,
 #undef ScrnMapr_DstDepth
 #undef ScrnMapr_Map
 #undef ScrnMapr_Scale
+#undef ScrnMapr_DstAtRect
@@ -0,0 +1,184 @@
+/*
+	SCRNMAPV.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	SCReeN MAPper, Vector versions
+
+	SIMD replacements for the inner loop of SCRNMAPR.h in
+	the case of a 1 bit screen mapped to 32 bit pixels at
+	scale 2. Rather than copying 16 pixels out of the table
+	for each source byte, each bit is turned into a mask and
+	used to pick between the two colors, which are taken from
+	the table itself, so the result is the same.
+
+	Include this once, before SCRNMAPR.h. The kernel is picked
+	the first time it is needed: AVX2 or SSE2 on x86, as the cpu
+	allows, NEON on ARM. Anywhere else, or with
+	WantScrnMapV 0, SCRNMAPR.h uses the table as before.
+*/
+
+#ifdef SCRNMAPV_H
+#error "header already included"
+#else
+#define SCRNMAPV_H
+#endif
+
+#ifndef WantScrnMapV
+#define WantScrnMapV 1
+#endif
+
+#if WantScrnMapV && defined(__GNUC__) \
+	&& (defined(__x86_64__) || defined(__i386__))
+#define ScrnMapV_X86 1
+#else
+#define ScrnMapV_X86 0
+#endif
+
+#if WantScrnMapV && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define ScrnMapV_NEON 1
+#else
+#define ScrnMapV_NEON 0
+#endif
+
+#define HaveScrnMapV (ScrnMapV_X86 || ScrnMapV_NEON)
+
+#if HaveScrnMapV
+
+#if ScrnMapV_X86
+#include <immintrin.h>
+#endif
+#if ScrnMapV_NEON
+#include <arm_neon.h>
+#endif
+
+/*
+	expand n source bytes into n * 16 pixels, c0 for
+	clear bits, c1 for set bits, most significant bit first.
+*/
+typedef void (*ScrnMapV_RowP)(ui3p pSrc, ui5b *pDst, ui4r n,
+	ui5r c0, ui5r c1);
+
+LOCALVAR ScrnMapV_RowP ScrnMapV_Row1to32x2 = nullpr;
+LOCALVAR blnr ScrnMapV_Selected = falseblnr;
+
+#if ScrnMapV_X86
+
+__attribute__((target("sse2")))
+LOCALPROC ScrnMapV_Row1to32x2_SSE2(ui3p pSrc, ui5b *pDst, ui4r n,
+	ui5r c0, ui5r c1)
+{
+	__m128i vc0 = _mm_set1_epi32((int)c0);
+	__m128i vd = _mm_set1_epi32((int)(c0 ^ c1));
+	__m128i m0 = _mm_setr_epi32(0x80, 0x80, 0x40, 0x40);
+	__m128i m1 = _mm_setr_epi32(0x20, 0x20, 0x10, 0x10);
+	__m128i m2 = _mm_setr_epi32(0x08, 0x08, 0x04, 0x04);
+	__m128i m3 = _mm_setr_epi32(0x02, 0x02, 0x01, 0x01);
+	__m128i *p = (__m128i *)pDst;
+
+	for (; n != 0; --n) {
+		__m128i v = _mm_set1_epi32(*pSrc++);
+
+#define ScrnMapV_SSE2Pixels(m) _mm_xor_si128(vc0, _mm_and_si128(vd, \
+	_mm_cmpeq_epi32(_mm_and_si128(v, m), m)))
+
+		_mm_storeu_si128(p++, ScrnMapV_SSE2Pixels(m0));
+		_mm_storeu_si128(p++, ScrnMapV_SSE2Pixels(m1));
+		_mm_storeu_si128(p++, ScrnMapV_SSE2Pixels(m2));
+		_mm_storeu_si128(p++, ScrnMapV_SSE2Pixels(m3));
+
+#undef ScrnMapV_SSE2Pixels
+	}
+}
+
+__attribute__((target("avx2")))
+LOCALPROC ScrnMapV_Row1to32x2_AVX2(ui3p pSrc, ui5b *pDst, ui4r n,
+	ui5r c0, ui5r c1)
+{
+	__m256i vc0 = _mm256_set1_epi32((int)c0);
+	__m256i vd = _mm256_set1_epi32((int)(c0 ^ c1));
+	__m256i m0 = _mm256_setr_epi32(0x80, 0x80, 0x40, 0x40,
+		0x20, 0x20, 0x10, 0x10);
+	__m256i m1 = _mm256_setr_epi32(0x08, 0x08, 0x04, 0x04,
+		0x02, 0x02, 0x01, 0x01);
+	__m256i *p = (__m256i *)pDst;
+
+	for (; n != 0; --n) {
+		__m256i v = _mm256_set1_epi32(*pSrc++);
+
+#define ScrnMapV_AVX2Pixels(m) _mm256_xor_si256(vc0, \
+	_mm256_and_si256(vd, _mm256_cmpeq_epi32(_mm256_and_si256(v, m), m)))
+
+		_mm256_storeu_si256(p++, ScrnMapV_AVX2Pixels(m0));
+		_mm256_storeu_si256(p++, ScrnMapV_AVX2Pixels(m1));
+
+#undef ScrnMapV_AVX2Pixels
+	}
+}
+
+#endif /* ScrnMapV_X86 */
+
+#if ScrnMapV_NEON
+
+LOCALPROC ScrnMapV_Row1to32x2_NEON(ui3p pSrc, ui5b *pDst, ui4r n,
+	ui5r c0, ui5r c1)
+{
+	static const uint32_t m[16] = {
+		0x80, 0x80, 0x40, 0x40, 0x20, 0x20, 0x10, 0x10,
+		0x08, 0x08, 0x04, 0x04, 0x02, 0x02, 0x01, 0x01
+	};
+	uint32x4_t vc0 = vdupq_n_u32(c0);
+	uint32x4_t vd = vdupq_n_u32(c0 ^ c1);
+	uint32x4_t m0 = vld1q_u32(m);
+	uint32x4_t m1 = vld1q_u32(m + 4);
+	uint32x4_t m2 = vld1q_u32(m + 8);
+	uint32x4_t m3 = vld1q_u32(m + 12);
+
+	for (; n != 0; --n) {
+		uint32x4_t v = vdupq_n_u32(*pSrc++);
+
+#define ScrnMapV_NEONPixels(m) \
+	veorq_u32(vc0, vandq_u32(vd, vtstq_u32(v, m)))
+
+		vst1q_u32(pDst, ScrnMapV_NEONPixels(m0));
+		vst1q_u32(pDst + 4, ScrnMapV_NEONPixels(m1));
+		vst1q_u32(pDst + 8, ScrnMapV_NEONPixels(m2));
+		vst1q_u32(pDst + 12, ScrnMapV_NEONPixels(m3));
+		pDst += 16;
+
+#undef ScrnMapV_NEONPixels
+	}
+}
+
+#endif /* ScrnMapV_NEON */
+
+LOCALPROC ScrnMapV_Select(void)
+{
+#if ScrnMapV_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		ScrnMapV_Row1to32x2 = ScrnMapV_Row1to32x2_AVX2;
+	} else if (__builtin_cpu_supports("sse2")) {
+		ScrnMapV_Row1to32x2 = ScrnMapV_Row1to32x2_SSE2;
+	}
+#endif
+#if ScrnMapV_NEON
+	ScrnMapV_Row1to32x2 = ScrnMapV_Row1to32x2_NEON;
+#endif
+
+	ScrnMapV_Selected = trueblnr;
+}
+
+#endif /* HaveScrnMapV */
@@ -0,0 +1,568 @@
+/*
+	SCRNSCAL.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	SCReeN SCALer
+
+	Scales the 1 bit emulated screen to 32 bit pixels in a
+	buffer of any size, for full screen mode without help
+	from a GPU. The modes are:
+
+	kScrnScalInteger - the largest whole multiple that fits,
+		centered with black borders.
+	kScrnScalNearest - as big as the aspect ratio allows,
+		each output pixel taking the nearest source pixel,
+		so some rows and columns come out a pixel wider
+		than others.
+	kScrnScalSharp - the same size, but blending two source
+		pixels where a source pixel edge falls inside an
+		output pixel, which evens out the widths without
+		blurring the rest of the image.
+
+	ScrnScal_Setup works out, for each output column and row,
+	which source pixel it takes and how much of the next one,
+	so it only needs to be redone when the output size or
+	mode changes. ScrnScal_DrawRect redraws just the part of
+	the output that depends on a changed source rectangle,
+	filling runs of identical output rows by copying.
+
+	Include after COMOSGLU.h. Assumes vMacScreenDepth is 0.
+*/
+
+#ifdef SCRNSCAL_H
+#error "header already included"
+#else
+#define SCRNSCAL_H
+#endif
+
+#define kScrnScalOff 0
+#define kScrnScalInteger 1
+#define kScrnScalNearest 2
+#define kScrnScalSharp 3
+
+#ifndef WantInitScrnScal
+#define WantInitScrnScal kScrnScalSharp
+#endif
+
+#ifndef WantScrnScalV
+#define WantScrnScalV 1
+#endif
+
+#if WantScrnScalV && defined(__GNUC__) \
+	&& (defined(__x86_64__) || defined(__i386__))
+#define ScrnScal_SSE2 1
+#include <emmintrin.h>
+#else
+#define ScrnScal_SSE2 0
+#endif
+
+#if WantScrnScalV && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define ScrnScal_NEON 1
+#include <arm_neon.h>
+#else
+#define ScrnScal_NEON 0
+#endif
+
+LOCALVAR int ScrnScalMode = WantInitScrnScal; /* set by --fs-scale */
+
+LOCALVAR ui5b *ScrnScal_Buff = nullpr;
+LOCALVAR ui4r ScrnScal_Width = 0;
+LOCALVAR ui4r ScrnScal_Height = 0;
+LOCALVAR int ScrnScal_CurMode = kScrnScalOff;
+LOCALVAR ScrnRect ScrnScal_Dst;
+	/* where the emulated screen goes in ScrnScal_Buff */
+
+/*
+	A span is a run of output columns, starting at column d of
+	ScrnScal_Dst, that all take source column x and the weight
+	w, out of 256, of the column after. In nearest modes there
+	is one span per source column, in kScrnScalSharp at most
+	two, so a row is drawn a span at a time, mostly by storing
+	the same color several times over.
+*/
+struct ScrnScalSpan {
+	ui4b x;
+	ui4b w;
+	ui4b n;
+	ui4b d;
+};
+typedef struct ScrnScalSpan ScrnScalSpan;
+
+LOCALVAR ScrnScalSpan *ScrnScal_Span = nullpr;
+
+/*
+	For each output row of ScrnScal_Dst, the source row it
+	takes and the weight of the row after.
+*/
+LOCALVAR si5b *ScrnScal_YSrc = nullpr;
+LOCALVAR si5b *ScrnScal_YW = nullpr;
+
+/* first span (output row) taking source column (row) i or later */
+LOCALVAR ui4b ScrnScal_XFirst[vMacScreenWidth + 1];
+LOCALVAR ui4b ScrnScal_YFirst[vMacScreenHeight + 1];
+
+/* source rows expanded to 0 or 256 per pixel, and a spare zero */
+LOCALVAR si5b ScrnScal_Row[2][vMacScreenWidth + 1];
+LOCALVAR si5b ScrnScal_RowY[2];
+
+/* color for each amount, out of 256, of a set pixel */
+LOCALVAR ui5b ScrnScal_Level[257];
+
+LOCALFUNC ui5r ScrnScal_SpanColor(si5b *a, si5b *b, si5b wy,
+	ScrnScalSpan *sp)
+{
+	si5b x = sp->x;
+	si5b w = sp->w;
+	si5b t = (a[x] << 8) + (a[x + 1] - a[x]) * w;
+	si5b u = (b[x] << 8) + (b[x + 1] - b[x]) * w;
+
+	return ScrnScal_Level[((t << 8) + (u - t) * wy) >> 16];
+}
+
+typedef void (*ScrnScal_RowP)(si5b *a, si5b *b, si5b wy,
+	ScrnScalSpan *sp, ui4r nSpans, ui5b *pDst, ui5b *pEnd);
+
+LOCALVAR ScrnScal_RowP ScrnScal_DoRow = nullpr;
+
+LOCALPROC ScrnScal_Row_C(si5b *a, si5b *b, si5b wy,
+	ScrnScalSpan *sp, ui4r nSpans, ui5b *pDst, ui5b *pEnd)
+{
+	ui5b c;
+	ui4r n;
+
+	UnusedParam(pEnd);
+
+	for (; nSpans != 0; --nSpans) {
+		c = ScrnScal_SpanColor(a, b, wy, sp);
+		for (n = sp->n; n != 0; --n) {
+			*pDst++ = c;
+		}
+		++sp;
+	}
+}
+
+/*
+	The vector versions store four pixels at a time, which may
+	run into the next span, since that is drawn afterwards.
+	Only near pEnd is there need to be exact.
+*/
+
+#if ScrnScal_SSE2
+
+__attribute__((target("sse2")))
+LOCALPROC ScrnScal_Row_SSE2(si5b *a, si5b *b, si5b wy,
+	ScrnScalSpan *sp, ui4r nSpans, ui5b *pDst, ui5b *pEnd)
+{
+	__m128i v;
+	ui4r n;
+
+	for (; nSpans != 0; --nSpans) {
+		n = sp->n;
+		v = _mm_set1_epi32((int)ScrnScal_SpanColor(a, b, wy, sp));
+		if (pDst + ((n + 3) & ~ 3) <= pEnd) {
+			_mm_storeu_si128((__m128i *)pDst, v);
+			if (n > 4) {
+				ui4r i;
+
+				for (i = 4; i < n; i += 4) {
+					_mm_storeu_si128((__m128i *)(pDst + i), v);
+				}
+			}
+			pDst += n;
+		} else {
+			ScrnScal_Row_C(a, b, wy, sp, nSpans, pDst, pEnd);
+			return;
+		}
+		++sp;
+	}
+}
+
+#endif /* ScrnScal_SSE2 */
+
+#if ScrnScal_NEON
+
+LOCALPROC ScrnScal_Row_NEON(si5b *a, si5b *b, si5b wy,
+	ScrnScalSpan *sp, ui4r nSpans, ui5b *pDst, ui5b *pEnd)
+{
+	uint32x4_t v;
+	ui4r n;
+	ui4r i;
+
+	for (; nSpans != 0; --nSpans) {
+		n = sp->n;
+		if (pDst + ((n + 3) & ~ 3) <= pEnd) {
+			v = vdupq_n_u32(ScrnScal_SpanColor(a, b, wy, sp));
+			for (i = 0; i < n; i += 4) {
+				vst1q_u32(pDst + i, v);
+			}
+			pDst += n;
+		} else {
+			ScrnScal_Row_C(a, b, wy, sp, nSpans, pDst, pEnd);
+			return;
+		}
+		++sp;
+	}
+}
+
+#endif /* ScrnScal_NEON */
+
+LOCALPROC ScrnScal_Select(void)
+{
+	ScrnScal_DoRow = ScrnScal_Row_C;
+#if ScrnScal_SSE2
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		ScrnScal_DoRow = ScrnScal_Row_SSE2;
+	}
+#endif
+#if ScrnScal_NEON
+	ScrnScal_DoRow = ScrnScal_Row_NEON;
+#endif
+}
+
+LOCALPROC ScrnScal_SetColors(ui5r c0, ui5r c1)
+{
+	int i;
+	int k;
+	ui5r v;
+
+	for (i = 0; i <= 256; ++i) {
+		v = 0;
+		for (k = 0; k < 32; k += 8) {
+			v |= ((((c0 >> k) & 0xFF) * (256 - i)
+				+ ((c1 >> k) & 0xFF) * i + 128) >> 8) << k;
+		}
+		ScrnScal_Level[i] = v;
+	}
+}
+
+/*
+	fill in Src and W for one axis, n source pixels going to
+	m output pixels.
+*/
+LOCALPROC ScrnScal_SetUpAxis(si5b *Src, si5b *W,
+	si5b n, si5b m, int mode)
+{
+	si5b d;
+	si5b i;
+	si5b x0;
+	si5b w;
+	si5b k = m / n;
+	double r;
+	double t;
+	double c;
+	double f;
+	double p;
+
+	if (k < 1) {
+		k = 1;
+	}
+	r = 0.5 - 0.5 / k;
+
+	for (d = 0; d < m; ++d) {
+		/* source position of the output pixel's center */
+		t = (d + 0.5) * n / m;
+		x0 = (si5b)t;
+		w = 0;
+
+		if (kScrnScalSharp == mode) {
+			/*
+				as if scaled up k times by repeating pixels,
+				then the rest of the way with bilinear
+				filtering: flat in the middle of a source
+				pixel, a ramp 1/k wide across each edge.
+			*/
+			i = x0;
+			c = t - i - 0.5;
+			if (c < - r) {
+				f = (c + r) * k + 0.5;
+			} else if (c > r) {
+				f = (c - r) * k + 0.5;
+			} else {
+				f = 0.5;
+			}
+			p = i + f - 0.5;
+			x0 = (si5b)(p + 1.0) - 1;
+			w = (si5b)((p - x0) * 256 + 0.5);
+			if (w >= 256) {
+				++x0;
+				w = 0;
+			}
+		}
+
+		if (x0 < 0) {
+			x0 = 0;
+			w = 0;
+		} else if (x0 >= n - 1) {
+			x0 = n - 1;
+			w = 0;
+		}
+
+		Src[d] = x0;
+		W[d] = w;
+	}
+}
+
+LOCALPROC ScrnScal_UnSetup(void)
+{
+	if (nullpr != ScrnScal_Buff) {
+		free(ScrnScal_Buff);
+		ScrnScal_Buff = nullpr;
+	}
+	if (nullpr != ScrnScal_YSrc) {
+		free(ScrnScal_YSrc);
+		ScrnScal_YSrc = nullpr;
+	}
+	ScrnScal_Width = 0;
+	ScrnScal_Height = 0;
+	ScrnScal_CurMode = kScrnScalOff;
+}
+
+/*
+	get ready to draw into a Width by Height buffer, with
+	clear pixels c0 and set pixels c1. Returns falseblnr if
+	out of memory.
+*/
+LOCALFUNC blnr ScrnScal_Setup(ui4r Width, ui4r Height, int mode,
+	ui5r c0, ui5r c1)
+{
+	si5b dw;
+	si5b dh;
+	si5b k;
+	si5b d;
+	si5b i;
+	si5b nSpans;
+	si5b *XSrc;
+	si5b *XW;
+	ScrnScalSpan *sp;
+
+	if (nullpr == ScrnScal_DoRow) {
+		ScrnScal_Select();
+	}
+
+	ScrnScal_SetColors(c0, c1);
+
+	if ((nullpr != ScrnScal_Buff) && (Width == ScrnScal_Width)
+		&& (Height == ScrnScal_Height) && (mode == ScrnScal_CurMode))
+	{
+		return trueblnr;
+	}
+
+	ScrnScal_UnSetup();
+
+	k = Width / vMacScreenWidth;
+	if (Height / vMacScreenHeight < k) {
+		k = Height / vMacScreenHeight;
+	}
+	if ((kScrnScalInteger == mode) && (k != 0)) {
+		dw = vMacScreenWidth * k;
+		dh = vMacScreenHeight * k;
+	} else if ((ui5r)Width * vMacScreenHeight
+		<= (ui5r)Height * vMacScreenWidth)
+	{
+		dw = Width;
+		dh = ((ui5r)Width * vMacScreenHeight + vMacScreenWidth / 2)
+			/ vMacScreenWidth;
+	} else {
+		dh = Height;
+		dw = ((ui5r)Height * vMacScreenWidth + vMacScreenHeight / 2)
+			/ vMacScreenHeight;
+	}
+
+	ScrnScal_Buff = (ui5b *)calloc((ui5r)Width * Height, 4);
+		/* zero is black, for the borders */
+	ScrnScal_YSrc = (si5b *)malloc(2 * (dh + dw) * sizeof(si5b)
+		+ (dw + 1) * sizeof(ScrnScalSpan));
+	if ((nullpr == ScrnScal_Buff) || (nullpr == ScrnScal_YSrc)) {
+		ScrnScal_UnSetup();
+		return falseblnr;
+	}
+	ScrnScal_YW = ScrnScal_YSrc + dh;
+	XSrc = ScrnScal_YW + dh;
+	XW = XSrc + dw;
+	ScrnScal_Span = (ScrnScalSpan *)(XW + dw);
+
+	ScrnScal_SetUpAxis(ScrnScal_YSrc, ScrnScal_YW,
+		vMacScreenHeight, dh, mode);
+	ScrnScal_SetUpAxis(XSrc, XW, vMacScreenWidth, dw, mode);
+
+	/* runs of columns alike become spans */
+	sp = ScrnScal_Span;
+	nSpans = 0;
+	for (d = 0; d < dw; ++d) {
+		if ((0 == nSpans) || (XSrc[d] != sp[nSpans - 1].x)
+			|| (XW[d] != sp[nSpans - 1].w))
+		{
+			sp[nSpans].x = XSrc[d];
+			sp[nSpans].w = XW[d];
+			sp[nSpans].n = 0;
+			sp[nSpans].d = d;
+			++nSpans;
+		}
+		++sp[nSpans - 1].n;
+	}
+	sp[nSpans].x = vMacScreenWidth;
+	sp[nSpans].d = dw;
+
+	d = 0;
+	for (i = 0; i <= vMacScreenWidth; ++i) {
+		while ((d < nSpans) && (sp[d].x < i)) {
+			++d;
+		}
+		ScrnScal_XFirst[i] = d;
+	}
+	d = 0;
+	for (i = 0; i <= vMacScreenHeight; ++i) {
+		while ((d < dh) && (ScrnScal_YSrc[d] < i)) {
+			++d;
+		}
+		ScrnScal_YFirst[i] = d;
+	}
+
+	ScrnScal_Dst.left = (Width - dw) / 2;
+	ScrnScal_Dst.top = (Height - dh) / 2;
+	ScrnScal_Dst.right = ScrnScal_Dst.left + dw;
+	ScrnScal_Dst.bottom = ScrnScal_Dst.top + dh;
+
+	ScrnScal_Width = Width;
+	ScrnScal_Height = Height;
+	ScrnScal_CurMode = mode;
+
+	return trueblnr;
+}
+
+LOCALFUNC si5b *ScrnScal_GetRow(ui3p src, si5b y, si5b s0, si5b s1)
+{
+	si5b x;
+	ui3p p = src + y * vMacScreenMonoByteWidth;
+	si5b *a = ScrnScal_Row[y & 1];
+
+	if (y != ScrnScal_RowY[y & 1]) {
+		for (x = s0; x < s1; ++x) {
+			a[x] = ((p[x >> 3] >> (7 - (x & 7))) & 1) << 8;
+		}
+		ScrnScal_RowY[y & 1] = y;
+	}
+
+	return a;
+}
+
+/*
+	redraw what depends on the given rectangle of src, and
+	return in r the part of the buffer that changed.
+*/
+LOCALFUNC blnr ScrnScal_DrawRect(ui3p src,
+	ui4r top, ui4r left, ui4r bottom, ui4r right, ScrnRect *r)
+{
+	si5b j0;
+	si5b j1;
+	si5b d0;
+	si5b d1;
+	si5b e0;
+	si5b e1;
+	si5b s0;
+	si5b s1;
+	si5b dy;
+	si5b y0;
+	si5b wy;
+	si5b *a;
+	si5b *b;
+	ui5b *pDst;
+	ui4r n;
+
+	/* bilinear columns and rows also look one pixel ahead */
+	j0 = ScrnScal_XFirst[(left > 0) ? left - 1 : 0];
+	j1 = ScrnScal_XFirst[right];
+	e0 = ScrnScal_YFirst[(top > 0) ? top - 1 : 0];
+	e1 = ScrnScal_YFirst[bottom];
+	if ((j0 >= j1) || (e0 >= e1)) {
+		return falseblnr;
+	}
+
+	d0 = ScrnScal_Span[j0].d;
+	d1 = ScrnScal_Span[j1].d;
+	n = d1 - d0;
+	s0 = ScrnScal_Span[j0].x;
+	s1 = ScrnScal_Span[j1 - 1].x + 2;
+	if (s1 > vMacScreenWidth) {
+		s1 = vMacScreenWidth;
+	}
+
+	/* source rows may have changed since last time */
+	ScrnScal_RowY[0] = -1;
+	ScrnScal_RowY[1] = -1;
+
+	pDst = ScrnScal_Buff
+		+ (ScrnScal_Dst.top + e0) * (ui5r)ScrnScal_Width
+		+ ScrnScal_Dst.left + d0;
+	for (dy = e0; dy < e1; ++dy) {
+		y0 = ScrnScal_YSrc[dy];
+		wy = ScrnScal_YW[dy];
+		if ((dy != e0) && (y0 == ScrnScal_YSrc[dy - 1])
+			&& (wy == ScrnScal_YW[dy - 1]))
+		{
+			MyMoveBytes((anyp)(pDst - ScrnScal_Width), (anyp)pDst,
+				n * 4);
+		} else {
+			a = ScrnScal_GetRow(src, y0, s0, s1);
+			b = (0 == wy) ? a : ScrnScal_GetRow(src, y0 + 1, s0, s1);
+			ScrnScal_DoRow(a, b, wy, ScrnScal_Span + j0, j1 - j0,
+				pDst, pDst + n);
+		}
+		pDst += ScrnScal_Width;
+	}
+
+	r->top = ScrnScal_Dst.top + e0;
+	r->left = ScrnScal_Dst.left + d0;
+	r->bottom = ScrnScal_Dst.top + e1;
+	r->right = ScrnScal_Dst.left + d1;
+
+	return trueblnr;
+}
+
+/* output coordinates to emulated screen coordinates, and back */
+
+LOCALFUNC si5b ScrnScal_ToSrcH(si5b h)
+{
+	h -= ScrnScal_Dst.left;
+	if (h < 0) {
+		return -1;
+	}
+	return h * vMacScreenWidth / (ScrnScal_Dst.right - ScrnScal_Dst.left);
+}
+
+LOCALFUNC si5b ScrnScal_ToSrcV(si5b v)
+{
+	v -= ScrnScal_Dst.top;
+	if (v < 0) {
+		return -1;
+	}
+	return v * vMacScreenHeight / (ScrnScal_Dst.bottom - ScrnScal_Dst.top);
+}
+
+LOCALFUNC si5b ScrnScal_FromSrcH(si5b h)
+{
+	return ScrnScal_Dst.left + (2 * h + 1)
+		* (ScrnScal_Dst.right - ScrnScal_Dst.left)
+		/ (2 * vMacScreenWidth);
+}
+
+LOCALFUNC si5b ScrnScal_FromSrcV(si5b v)
+{
+	return ScrnScal_Dst.top + (2 * v + 1)
+		* (ScrnScal_Dst.bottom - ScrnScal_Dst.top)
+		/ (2 * vMacScreenHeight);
+}
@@ -0,0 +1,220 @@
+/*
+	SCRNVRFY.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	SCReeN VeRiFY
+
+	Hash the (1 bit) emulated screen every so many ticks and
+	either write the hashes to a "golden" list, or compare them
+	with one, to tell whether a build draws a session (usually
+	a replay, see EVTRPLAY.h) exactly the same. A screen that
+	differs is written out as a PBM file, so it can be looked at.
+
+	The list is plain text, a line per check with the tick
+	(counted from the start, one per emulated tick) and the
+	hash in hex, by MyHashBytes of COMOSGLU.h, as for the replay
+	checks.
+
+	What is hashed is the emulated Mac's own screen buffer
+	(VidMem, or the main or alternate buffer in RAM), as it is
+	at the end of each emulated tick. Not screencomparebuff,
+	which only holds what has been presented, and so depends on
+	the host's timing: ticks emulated while catching up aren't
+	drawn, and while lagging rows are only partly scanned.
+	Screen_OutputFrame passes on the buffer every tick, drawn or
+	not, so a replay checks the same ticks every time.
+
+	A check run that finds the golden list ending early, or
+	naming a different tick, counts as a failure, rather than
+	quietly checking no more.
+
+	The OSGLUxxx file includes this after COMOSGLU.h, calls
+	ScrnVrfy_Init after the command line is read, and
+	ScrnVrfy_UnInit when done (or ScrnVrfy_CheckEnd first, to
+	report the count itself). The paths and ScrnVrfyEvery are
+	set by --hash-record, --hash-check and --hash-every.
+*/
+
+#ifdef SCRNVRFY_H
+#error "header already included"
+#else
+#define SCRNVRFY_H
+#endif
+
+#ifndef ScrnVrfyMaxDumps
+#define ScrnVrfyMaxDumps 8
+#endif
+
+LOCALVAR char *ScrnVrfyRecordPath = NULL;
+LOCALVAR char *ScrnVrfyCheckPath = NULL;
+LOCALVAR ui5r ScrnVrfyEvery = 60;
+LOCALVAR FILE *ScrnVrfyFile = NULL;
+LOCALVAR blnr ScrnVrfyOutOfStep = falseblnr;
+
+LOCALVAR ui5r ScrnVrfyTicks = 0;
+LOCALVAR ui5r ScrnVrfyChecks = 0;
+LOCALVAR ui5r ScrnVrfyMismatches = 0;
+LOCALVAR ui5r ScrnVrfyFirstBadTick = 0;
+
+LOCALPROC ScrnVrfyDump(ui3p screencurrentbuff)
+{
+	/* PBM, like the Mac, has 1 for black */
+	FILE *f;
+	char *s = (char *)malloc(strlen(ScrnVrfyCheckPath) + 20);
+
+	if (NULL != s) {
+		sprintf(s, "%s.%u.pbm", ScrnVrfyCheckPath,
+			(unsigned int)ScrnVrfyTicks);
+		f = fopen(s, "wb");
+		if (NULL == f) {
+			fprintf(stderr, "Couldn't create %s\n", s);
+		} else {
+			fprintf(f, "P4\n%d %d\n",
+				vMacScreenWidth, vMacScreenHeight);
+			(void) fwrite(screencurrentbuff, 1,
+				vMacScreenMonoNumBytes, f);
+			fclose(f);
+		}
+		free(s);
+	}
+}
+
+LOCALPROC ScrnVrfyCheck(ui3p screencurrentbuff, ui5r h)
+{
+	unsigned long t;
+	unsigned long g;
+
+	if (ScrnVrfyOutOfStep) {
+		return;
+	}
+	if ((2 != fscanf(ScrnVrfyFile, "%lu %lx", &t, &g))
+		|| (t != ScrnVrfyTicks))
+	{
+		/* golden list from another session, or cut short */
+		fprintf(stderr, "hash list out of step at tick %u\n",
+			(unsigned int)ScrnVrfyTicks);
+		ScrnVrfyOutOfStep = trueblnr;
+		if (0 == ScrnVrfyMismatches) {
+			ScrnVrfyFirstBadTick = ScrnVrfyTicks;
+		}
+		++ScrnVrfyMismatches;
+		return;
+	}
+
+	++ScrnVrfyChecks;
+	if (g != h) {
+		if (0 == ScrnVrfyMismatches) {
+			ScrnVrfyFirstBadTick = ScrnVrfyTicks;
+		}
+		if (ScrnVrfyMismatches < ScrnVrfyMaxDumps) {
+			ScrnVrfyDump(screencurrentbuff);
+		}
+		++ScrnVrfyMismatches;
+	}
+}
+
+/* --- interface for OSGLUxxx --- */
+
+LOCALFUNC blnr ScrnVrfy_Init(void)
+{
+	if (0 == ScrnVrfyEvery) {
+		ScrnVrfyEvery = 1;
+	}
+
+	if (NULL != ScrnVrfyCheckPath) {
+		ScrnVrfyFile = fopen(ScrnVrfyCheckPath, "r");
+		if (NULL == ScrnVrfyFile) {
+			fprintf(stderr, "Couldn't open hash list %s\n",
+				ScrnVrfyCheckPath);
+			return falseblnr;
+		}
+	} else if (NULL != ScrnVrfyRecordPath) {
+		ScrnVrfyFile = fopen(ScrnVrfyRecordPath, "w");
+		if (NULL == ScrnVrfyFile) {
+			fprintf(stderr, "Couldn't create hash list %s\n",
+				ScrnVrfyRecordPath);
+			return falseblnr;
+		}
+	}
+
+	return trueblnr;
+}
+
+LOCALPROC ScrnVrfy_CheckEnd(void)
+{
+	/*
+		call when the run is over, before reporting
+		ScrnVrfyMismatches. A golden list that goes on
+		past the run is a failure too.
+	*/
+	unsigned long t;
+	unsigned long g;
+
+	if ((NULL != ScrnVrfyFile) && (NULL != ScrnVrfyCheckPath)
+		&& ! ScrnVrfyOutOfStep)
+	{
+		if (2 == fscanf(ScrnVrfyFile, "%lu %lx", &t, &g)) {
+			fprintf(stderr, "hash list goes on past tick %u\n",
+				(unsigned int)ScrnVrfyTicks);
+			if (0 == ScrnVrfyMismatches) {
+				ScrnVrfyFirstBadTick = ScrnVrfyTicks;
+			}
+			++ScrnVrfyMismatches;
+		}
+		ScrnVrfyOutOfStep = trueblnr;
+	}
+}
+
+LOCALPROC ScrnVrfy_UnInit(void)
+{
+	ScrnVrfy_CheckEnd();
+	if (NULL != ScrnVrfyFile) {
+		if (NULL != ScrnVrfyCheckPath) {
+			fprintf(stderr, "hash: %u checks,",
+				(unsigned int)ScrnVrfyChecks);
+			if (0 == ScrnVrfyMismatches) {
+				fprintf(stderr, " all matched\n");
+			} else {
+				fprintf(stderr, " %u differed, first at tick %u\n",
+					(unsigned int)ScrnVrfyMismatches,
+					(unsigned int)ScrnVrfyFirstBadTick);
+			}
+		}
+		fclose(ScrnVrfyFile);
+		ScrnVrfyFile = NULL;
+	}
+}
+
+LOCALPROC ScrnVrfy_Frame(ui3p screencurrentbuff)
+{
+	ui5r h;
+
+	if (NULL == ScrnVrfyFile) {
+		return;
+	}
+
+	++ScrnVrfyTicks;
+	if (0 == (ScrnVrfyTicks % ScrnVrfyEvery)) {
+		h = MyHashBytes(screencurrentbuff, vMacScreenMonoNumBytes,
+			MyHashInit);
+		if (NULL != ScrnVrfyCheckPath) {
+			ScrnVrfyCheck(screencurrentbuff, h);
+		} else {
+			fprintf(ScrnVrfyFile, "%u %08x\n",
+				(unsigned int)ScrnVrfyTicks, (unsigned int)h);
+		}
+	}
+}
@@ -24,6 +24,10 @@
 #define RaspbianWorkAround 0
 #endif
 
+#ifndef UseSoundThread
+#define UseSoundThread 0
+#endif
+
 #if 0
 
 #include "alsa/asoundlib.h"
@@ -154,6 +158,10 @@
 	snd_pcm_hw_params_set_rate_near
 #define HaveMy_snd_pcm_hw_params_set_rate_near() (1)
 
+#define My_snd_pcm_hw_params_set_rate_resample \
+	snd_pcm_hw_params_set_rate_resample
+#define HaveMy_snd_pcm_hw_params_set_rate_resample() (1)
+
 #define My_snd_pcm_hw_params_set_channels \
 	snd_pcm_hw_params_set_channels
 #define HaveMy_snd_pcm_hw_params_set_channels() (1)
@@ -217,6 +225,9 @@
 #define My_snd_pcm_drop snd_pcm_drop
 #define HaveMy_snd_pcm_drop() (1)
 
+#define My_snd_pcm_delay snd_pcm_delay
+#define HaveMy_snd_pcm_delay() (1)
+
 #if RaspbianWorkAround
 #define My_snd_pcm_status_malloc snd_pcm_status_malloc
 #define HaveMy_snd_pcm_status_malloc() (1)
@@ -639,6 +650,30 @@ LOCALFUNC blnr HaveMy_snd_pcm_hw_params_set_rate_near(void)
 	return (My_snd_pcm_hw_params_set_rate_near != NULL);
 }
 
+#if UseSoundThread
+typedef int (*snd_pcm_hw_params_set_rate_resample_ProcPtr)
+	(My_snd_pcm_t *pcm, My_snd_pcm_hw_params_t *params,
+		unsigned int val);
+LOCALVAR snd_pcm_hw_params_set_rate_resample_ProcPtr
+	My_snd_pcm_hw_params_set_rate_resample = NULL;
+LOCALVAR blnr Did_snd_pcm_hw_params_set_rate_resample = falseblnr;
+
+LOCALFUNC blnr HaveMy_snd_pcm_hw_params_set_rate_resample(void)
+{
+	/* optional, only wanted when resampling ourselves */
+	if (! Did_snd_pcm_hw_params_set_rate_resample) {
+		if (HaveAlsaLib()) {
+			My_snd_pcm_hw_params_set_rate_resample =
+				(snd_pcm_hw_params_set_rate_resample_ProcPtr)
+				dlsym(alsa_handle,
+					"snd_pcm_hw_params_set_rate_resample");
+		}
+		Did_snd_pcm_hw_params_set_rate_resample = trueblnr;
+	}
+	return (My_snd_pcm_hw_params_set_rate_resample != NULL);
+}
+#endif
+
 typedef int (*snd_pcm_hw_params_set_channels_ProcPtr)
 	(My_snd_pcm_t *pcm, My_snd_pcm_hw_params_t *params,
 	unsigned int val);
@@ -1052,6 +1087,26 @@ LOCALFUNC blnr HaveMy_snd_pcm_drop(void)
 	return (My_snd_pcm_drop != NULL);
 }
 
+#if UseSoundThread
+typedef int (*snd_pcm_delay_ProcPtr)
+	(My_snd_pcm_t *pcm, My_snd_pcm_sframes_t *delayp);
+LOCALVAR snd_pcm_delay_ProcPtr My_snd_pcm_delay = NULL;
+LOCALVAR blnr Did_snd_pcm_delay = falseblnr;
+
+LOCALFUNC blnr HaveMy_snd_pcm_delay(void)
+{
+	/* optional, only for measuring latency */
+	if (! Did_snd_pcm_delay) {
+		if (HaveAlsaLib()) {
+			My_snd_pcm_delay = (snd_pcm_delay_ProcPtr)
+				dlsym(alsa_handle, "snd_pcm_delay");
+		}
+		Did_snd_pcm_delay = trueblnr;
+	}
+	return (My_snd_pcm_delay != NULL);
+}
+#endif
+
 #if RaspbianWorkAround
 typedef int (*snd_pcm_status_malloc_ProcPtr)
 	(My_snd_pcm_status_t **ptr);
@@ -1158,7 +1213,7 @@ LOCALPROC ConvertSoundBlockToNative(tpSoundSamp p)
 {
 	int i;
 
-	for (i = kOneBuffLen; --i >= 0; ) {
+	for (i = MySoundOneBuffLen; --i >= 0; ) {
 		*p++ -= 0x8000;
 	}
 }
@@ -1166,8 +1221,13 @@ LOCALPROC ConvertSoundBlockToNative(tpSoundSamp p)
 #define ConvertSoundBlockToNative(p)
 #endif
 
+#if UseSoundThread
+#define desired_alsa_buffer_size MySoundDevBuffLen
+#define desired_alsa_period_size MySoundOneBuffLen
+#else
 #define desired_alsa_buffer_size kAllBuffLen
 #define desired_alsa_period_size kOneBuffLen
+#endif
 
 LOCALVAR char *alsadev_name = NULL;
 
@@ -1176,7 +1236,9 @@ LOCALVAR My_snd_pcm_uframes_t buffer_size;
 LOCALVAR My_snd_pcm_uframes_t period_size;
 
 
+#if ! UseSoundThread
 LOCALVAR blnr MySound_StartPend = falseblnr;
+#endif
 
 #if RaspbianWorkAround
 LOCALVAR My_snd_pcm_status_t *my_status = NULL;
@@ -1200,6 +1262,7 @@ LOCALFUNC blnr HaveMyStatusAlloc(void)
 }
 #endif
 
+#if ! UseSoundThread
 LOCALPROC MySound_WriteOut(void)
 {
 	int retry_count = 32;
@@ -1354,6 +1417,7 @@ LOCALPROC MySound_Stop(void)
 		My_snd_pcm_drop(pcm_handle);
 	}
 }
+#endif /* ! UseSoundThread */
 
 LOCALFUNC blnr HaveAlsaRoutines(void)
 {
@@ -1399,15 +1463,49 @@ LOCALFUNC blnr HaveAlsaRoutines(void)
 #define MyDesiredFormat My_SND_PCM_FORMAT_U8
 #endif
 
+#if UseSoundThread
+#include "SNDRSMPL.h"
+
+LOCALVAR ui5r MySoundDevRate = SOUND_SAMPLERATE;
+LOCALVAR ui3r MySoundDevFrameSz = 1 << (kLn2SoundSampSz - 3);
+
+LOCALPROC MySoundDevSetRate(ui5r rate)
+{
+	/* what the device will be fed, resampled or not */
+	if (kRsmpOff == RsmpMode) {
+		MySoundDevRate = SOUND_SAMPLERATE;
+		MySoundDevFrameSz = 1 << (kLn2SoundSampSz - 3);
+	} else {
+		MySoundDevRate = rate;
+		MySoundDevFrameSz = 2;
+	}
+
+	/* about the same time as without resampling */
+	buffer_size = (My_snd_pcm_uframes_t)(((unsigned long long)
+		desired_alsa_buffer_size * MySoundDevRate) / SOUND_SAMPLERATE);
+	period_size = (My_snd_pcm_uframes_t)(((unsigned long long)
+		desired_alsa_period_size * MySoundDevRate) / SOUND_SAMPLERATE);
+}
+#endif
+
 LOCALPROC MySound_Init0(void)
 {
 	My_snd_pcm_hw_params_t *hw_params = NULL;
 	My_snd_pcm_sw_params_t *sw_params = NULL;
 	unsigned int rrate = SOUND_SAMPLERATE;
+	My_snd_pcm_format_t format = MyDesiredFormat;
 	int err;
 
+#if UseSoundThread
+	MySoundDevSetRate(RsmpWantRate);
+	if (kRsmpOff != RsmpMode) {
+		rrate = RsmpWantRate;
+		format = My_SND_PCM_FORMAT_S16;
+	}
+#else
 	buffer_size = desired_alsa_buffer_size;
 	period_size = desired_alsa_period_size;
+#endif
 
 	/* Open the sound device */
 	if (NULL == alsadev_name) {
@@ -1443,11 +1541,25 @@ LOCALPROC MySound_Init0(void)
 			My_snd_strerror(err));
 	} else
 	if ((err = My_snd_pcm_hw_params_set_format(pcm_handle,
-		hw_params, MyDesiredFormat)) < 0)
+		hw_params, format)) < 0)
 	{
 		fprintf(stderr, "cannot set sample format (%s)\n",
 			My_snd_strerror(err));
 	} else
+#if UseSoundThread
+	/*
+		when resampling here, ask for the rate the hardware
+		really has, rather than alsa resampling it again.
+	*/
+	if ((kRsmpOff != RsmpMode)
+		&& HaveMy_snd_pcm_hw_params_set_rate_resample()
+		&& ((err = My_snd_pcm_hw_params_set_rate_resample(pcm_handle,
+			hw_params, 0)) < 0))
+	{
+		fprintf(stderr, "cannot turn off alsa resampling (%s)\n",
+			My_snd_strerror(err));
+	} else
+#endif
 	if ((err = My_snd_pcm_hw_params_set_rate_near(pcm_handle,
 		hw_params, &rrate, NULL)) < 0)
 	{
@@ -1477,6 +1589,12 @@ LOCALPROC MySound_Init0(void)
 			My_snd_strerror(err));
 	} else
 	{
+#if UseSoundThread
+		if (kRsmpOff != RsmpMode) {
+			MySoundDevRate = rrate;
+			Rsmp_Init(SOUND_SAMPLERATE, rrate);
+		} else
+#endif
 		if (rrate != SOUND_SAMPLERATE) {
 			fprintf(stderr, "Warning: sample rate is off by %i Hz\n",
 				SOUND_SAMPLERATE - rrate);
@@ -1577,17 +1695,783 @@ label_done:
 	;
 }
 
+#if UseSoundThread
+
+/*
+	The sound thread
+
+	Without it, blocks only go to alsa when the emulation
+	finishes one, so a long tick or a stalled X server lets
+	the device run dry. Instead a thread of its own takes
+	finished blocks from TheSoundBuffer (the emulation never
+	waits for it) and hands them to the device with a blocking
+	write, so it sleeps on the device until there is room.
+	It is given real time priority if the system allows.
+
+	The device is one of several sinks, picked by --sound-sink,
+	each behind the MySoundDev_ routines:
+
+	pulse - a PulseAudio (or PipeWire) server, by the simple api
+		of SGLUPULS.h. The server starts and restarts playing by
+		itself once enough is queued, and the simple api doesn't
+		tell about underruns, so none are counted.
+
+	alsa - the alsa pcm, as before.
+
+	null - a pretend device with the same buffer size, playing
+		in real time by the clock, so the emulation is paced and
+		the sound code runs the same where there is no sound
+		hardware, underruns included.
+
+	With --sound-file, the null sink also writes the samples
+	(mono, as they would go to a device) to a file, as a WAV
+	file if the name ends with ".wav", otherwise raw.
+
+	The default is the first of pulse, alsa and null that works
+	(alsa first if --alsadev was given).
+
+	Unless --sound-resample off, the samples are first made
+	into 16 bit ones at --sound-rate (or what the device gets
+	closest to) by SNDRSMPL.h, and written a period at a time.
+
+	Underruns (the device ran dry, not known for pulse), samples
+	dropped because the thread fell behind, and the latency (how
+	long until a sample finished now is heard, by snd_pcm_delay
+	or pa_simple_get_latency, plus what is waiting in
+	TheSoundBuffer, sampled after each write) are printed when
+	done.
+*/
+
+#include <pthread.h>
+
+#include "SGLUPULS.h"
+	/* SNDWAVFL.h is included by the OSGLU */
+
+enum {
+	kMySoundSinkNone,
+	kMySoundSinkPulse,
+	kMySoundSinkAlsa,
+	kMySoundSinkNull
+};
+
+LOCALVAR int MySoundSinkWant = kMySoundSinkNone;
+	/* set by --sound-sink, none for the first that works */
+LOCALVAR int MySoundSink = kMySoundSinkNone;
+
+LOCALVAR char *MySoundFilePath = NULL;
+LOCALVAR FILE *MySoundFile = NULL;
+LOCALVAR blnr MySoundFileIsWav;
+LOCALVAR unsigned long long MySoundFileBytes;
+
+LOCALVAR My_pa_simple *MySoundPulse = NULL;
+
+LOCALVAR blnr MySoundClockRunning;
+LOCALVAR struct timespec MySoundClockStart;
+LOCALVAR ui5r MySoundClockQueued;
+	/* frames written since MySoundClockStart, or before it */
+
+LOCALVAR pthread_t MySoundThread;
+LOCALVAR blnr MySoundThreadOn = falseblnr;
+LOCALVAR blnr MySoundThreadQuit;
+LOCALVAR blnr MySoundThreadIdle = falseblnr;
+LOCALVAR pthread_mutex_t MySoundMutex = PTHREAD_MUTEX_INITIALIZER;
+LOCALVAR pthread_cond_t MySoundCond = PTHREAD_COND_INITIALIZER;
+
+LOCALVAR blnr MySoundDevRunning;
+LOCALVAR si4b *MySoundOut = NULL; /* a period of resampled frames */
+LOCALVAR ui5r MySoundOutLen;
+LOCALVAR struct timespec MySoundSteerLast;
+
+LOCALVAR ui5r MySoundStatUnderruns = 0;
+LOCALVAR ui5r MySoundStatLatency = 0; /* the last one */
+LOCALVAR ui5r MySoundStatWrites = 0;
+LOCALVAR unsigned long long MySoundStatLatencySum = 0;
+LOCALVAR ui5r MySoundStatLatencyMax = 0;
+
+#define MySoundHaveDev() (kMySoundSinkNone != MySoundSink)
+
+#define MySoundFramesToMs(n) \
+	((ui5r)(((unsigned long long)(n) * 1000) / SOUND_SAMPLERATE))
+
+#define MySoundDevToIn(n) \
+	((ui5r)(((unsigned long long)(n) * SOUND_SAMPLERATE) \
+		/ MySoundDevRate))
+
+LOCALFUNC ui5r MySoundClockPlayed(void)
+{
+	/* frames the pretend device has played since it started */
+	struct timespec t;
+
+	(void) clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return (ui5r)(((t.tv_sec - MySoundClockStart.tv_sec)
+		* (unsigned long long)MySoundDevRate)
+		+ ((t.tv_nsec - MySoundClockStart.tv_nsec)
+			* (long long)MySoundDevRate) / 1000000000);
+}
+
+LOCALPROC MySoundSleepFrames(ui5r n)
+{
+	/* n frames at the rate of the device */
+	struct timespec rqt;
+
+	rqt.tv_sec = n / MySoundDevRate;
+	rqt.tv_nsec = (long)(((unsigned long long)(n % MySoundDevRate)
+		* 1000000000) / MySoundDevRate);
+	(void) nanosleep(&rqt, NULL);
+}
+
+LOCALPROC MySoundDevStartRsmp(void)
+{
+	/* after MySoundDevSetRate, and the device settled the rate */
+	if (kRsmpOff != RsmpMode) {
+		Rsmp_Init(SOUND_SAMPLERATE, MySoundDevRate);
+	}
+}
+
+LOCALFUNC blnr MySoundPulse_Open(void)
+{
+	My_pa_sample_spec ss;
+	My_pa_buffer_attr attr;
+	int err;
+
+	if (! HavePulseRoutines()) {
+		if (kMySoundSinkPulse == MySoundSinkWant) {
+			fprintf(stderr, "libpulse-simple not found\n");
+		}
+		return falseblnr;
+	}
+
+	MySoundDevSetRate(RsmpWantRate);
+	if (kRsmpOff != RsmpMode) {
+		ss.format = My_PA_SAMPLE_S16NE;
+	} else {
+#if 4 == kLn2SoundSampSz
+		ss.format = My_PA_SAMPLE_S16NE;
+#else
+		ss.format = My_PA_SAMPLE_U8;
+#endif
+	}
+	ss.rate = MySoundDevRate;
+	ss.channels = 1;
+
+	/*
+		the server keeps about as much as an alsa device would,
+		and starts (or after running dry, starts again) once
+		there is as much as the sound thread prefills.
+	*/
+	attr.maxlength = (ui5b) -1;
+	attr.tlength = buffer_size * MySoundDevFrameSz;
+	attr.prebuf = (ui5b)(((unsigned long long)MySoundMinFilledWant
+		* MySoundOneBuffLen * MySoundDevRate) / SOUND_SAMPLERATE)
+		* MySoundDevFrameSz;
+	attr.minreq = period_size * MySoundDevFrameSz;
+	attr.fragsize = (ui5b) -1;
+
+	MySoundPulse = My_pa_simple_new(NULL, kStrAppName,
+		My_PA_STREAM_PLAYBACK, NULL, "Emulated sound", &ss, NULL,
+		&attr, &err);
+	if (NULL == MySoundPulse) {
+		if (kMySoundSinkPulse == MySoundSinkWant) {
+			fprintf(stderr, "cannot connect to sound server (%s)\n",
+				My_pa_strerror(err));
+		}
+		return falseblnr;
+	}
+
+	MySoundDevStartRsmp();
+
+	return trueblnr;
+}
+
+LOCALFUNC ui5r MySoundPulse_Delay(void)
+{
+	int err;
+	My_pa_usec_t t = My_pa_simple_get_latency(MySoundPulse, &err);
+
+	if ((My_pa_usec_t) -1 == t) {
+		return 0;
+	}
+
+	return (ui5r)((t * MySoundDevRate) / 1000000);
+}
+
+LOCALFUNC blnr MySoundAlsa_Open(void)
+{
+	if (HaveAlsaRoutines()) {
+		MySound_Init0();
+	}
+
+	return (NULL != pcm_handle);
+}
+
+LOCALFUNC blnr MySoundNull_Open(void)
+{
+	MySoundDevSetRate(RsmpWantRate);
+
+	if (NULL != MySoundFilePath) {
+		MySoundFile = fopen(MySoundFilePath, "wb");
+		if (NULL == MySoundFile) {
+			fprintf(stderr, "Couldn't create %s\n", MySoundFilePath);
+			return falseblnr;
+		}
+		MySoundFileIsWav = WavFl_IsWavPath(MySoundFilePath);
+		MySoundFileBytes = 0;
+		if (MySoundFileIsWav
+			&& ! WavFl_Header(MySoundFile, MySoundDevRate,
+				MySoundDevFrameSz * 8, 0))
+		{
+			fprintf(stderr, "Couldn't write %s\n", MySoundFilePath);
+			return falseblnr;
+		}
+	}
+
+	MySoundDevStartRsmp();
+
+	return trueblnr;
+}
+
+LOCALFUNC ui5r MySoundDev_Queued(void)
+{
+	/* frames given to the device not yet played */
+	My_snd_pcm_sframes_t avail;
+	ui5r played;
+
+	switch (MySoundSink) {
+		case kMySoundSinkPulse:
+			return MySoundPulse_Delay();
+		case kMySoundSinkAlsa:
+			avail = My_snd_pcm_avail_update(pcm_handle);
+			if ((avail < 0)
+				|| ((My_snd_pcm_uframes_t)avail > buffer_size))
+			{
+				return 0;
+			}
+			return buffer_size - avail;
+		default:
+			if (! MySoundClockRunning) {
+				return MySoundClockQueued;
+			}
+			played = MySoundClockPlayed();
+			return (played >= MySoundClockQueued)
+				? 0 : MySoundClockQueued - played;
+	}
+}
+
+LOCALFUNC ui5r MySoundDev_Delay(void)
+{
+	/*
+		frames until one written now would be heard, which
+		may be more than MySoundDev_Queued.
+	*/
+	My_snd_pcm_sframes_t delay;
+
+	if ((kMySoundSinkAlsa == MySoundSink) && HaveMy_snd_pcm_delay()
+		&& (My_snd_pcm_delay(pcm_handle, &delay) >= 0)
+		&& (delay >= 0))
+	{
+		return (ui5r)delay;
+	}
+
+	return MySoundDev_Queued();
+}
+
+LOCALFUNC long MySoundDev_Write(ui3p p, ui5r n)
+{
+	/*
+		frames written, which may be fewer than n, or less than
+		zero on error, - EPIPE if the device ran dry.
+	*/
+	ui5r played;
+	ui5r queued;
+	int err;
+
+	switch (MySoundSink) {
+		case kMySoundSinkPulse:
+			if (My_pa_simple_write(MySoundPulse, p,
+				n * MySoundDevFrameSz, &err) < 0)
+			{
+				fprintf(stderr, "sound server write error: %s\n",
+					My_pa_strerror(err));
+				return - EIO;
+			}
+			return n;
+		case kMySoundSinkAlsa:
+			return My_snd_pcm_writei(pcm_handle, p, n);
+		default:
+			if (MySoundClockRunning) {
+				for (; ; ) {
+					played = MySoundClockPlayed();
+					if (played > MySoundClockQueued) {
+						return - EPIPE;
+					}
+					queued = MySoundClockQueued - played;
+					if (queued + n <= buffer_size) {
+						break;
+					}
+					MySoundSleepFrames(queued + n - buffer_size);
+				}
+			}
+			if (NULL != MySoundFile) {
+				if (n != fwrite(p, MySoundDevFrameSz, n, MySoundFile))
+				{
+					return - EIO;
+				}
+				MySoundFileBytes += n * MySoundDevFrameSz;
+			}
+			MySoundClockQueued += n;
+			return n;
+	}
+}
+
+LOCALPROC MySoundDev_Start(void)
+{
+	int err;
+
+	switch (MySoundSink) {
+		case kMySoundSinkPulse:
+			/* the server starts by itself */
+			break;
+		case kMySoundSinkAlsa:
+			if (My_SND_PCM_STATE_PREPARED
+				== My_snd_pcm_state(pcm_handle))
+			{
+				if ((err = My_snd_pcm_start(pcm_handle)) < 0) {
+					fprintf(stderr, "pcm start error: %s\n",
+						My_snd_strerror(err));
+				}
+			}
+			break;
+		default:
+			(void) clock_gettime(CLOCK_MONOTONIC, &MySoundClockStart);
+			MySoundClockRunning = trueblnr;
+			break;
+	}
+}
+
+LOCALPROC MySoundDev_Prepare(void)
+{
+	/* get ready to be filled and started again */
+	int err;
+	My_snd_pcm_state_t cur_state;
+
+	switch (MySoundSink) {
+		case kMySoundSinkPulse:
+			break;
+		case kMySoundSinkAlsa:
+			cur_state = My_snd_pcm_state(pcm_handle);
+			if (My_SND_PCM_STATE_SUSPENDED == cur_state) {
+				while (- EAGAIN
+					== (err = My_snd_pcm_resume(pcm_handle)))
+				{
+					MySoundSleepFrames(period_size);
+				}
+				if (err >= 0) {
+					return;
+				}
+			} else if (My_SND_PCM_STATE_PREPARED == cur_state) {
+				return;
+			}
+			if ((err = My_snd_pcm_prepare(pcm_handle)) < 0) {
+				fprintf(stderr, "pcm prepare error: %s\n",
+					My_snd_strerror(err));
+			}
+			break;
+		default:
+			MySoundClockRunning = falseblnr;
+			MySoundClockQueued = 0;
+			break;
+	}
+}
+
+LOCALPROC MySoundDev_Drop(void)
+{
+	/* stop playing, throwing away what is queued */
+	int err;
+
+	switch (MySoundSink) {
+		case kMySoundSinkPulse:
+			(void) My_pa_simple_flush(MySoundPulse, &err);
+			break;
+		case kMySoundSinkAlsa:
+			My_snd_pcm_drop(pcm_handle);
+			break;
+		default:
+			break;
+	}
+}
+
+LOCALPROC MySoundDev_Close(void)
+{
+	switch (MySoundSink) {
+		case kMySoundSinkPulse:
+			My_pa_simple_free(MySoundPulse);
+			MySoundPulse = NULL;
+			break;
+		case kMySoundSinkAlsa:
+			/* by MySound_UnInit */
+			break;
+		default:
+			if (NULL != MySoundFile) {
+				if ((MySoundFileIsWav
+						&& ! WavFl_Finish(MySoundFile, MySoundDevRate,
+							MySoundDevFrameSz * 8, MySoundFileBytes))
+					|| (0 != fclose(MySoundFile)))
+				{
+					fprintf(stderr, "Couldn't write %s\n",
+						MySoundFilePath);
+				}
+				MySoundFile = NULL;
+			}
+			break;
+	}
+	MySoundSink = kMySoundSinkNone;
+}
+
+LOCALPROC MySoundThreadWait(ui4b OldFill)
+{
+	/* until MySound_EndWrite fills a block, or a block's time */
+	struct timespec t;
+
+	pthread_mutex_lock(&MySoundMutex);
+	MySoundAtomicPut(MySoundThreadIdle, trueblnr);
+	MySoundAtomicFence();
+		/* so either this sees the block, or the emulation sees idle */
+	if ((OldFill == MySoundAtomicGet(TheFillOffset))
+		&& ! MySoundAtomicGet(MySoundThreadQuit))
+	{
+		(void) clock_gettime(CLOCK_REALTIME, &t);
+		t.tv_nsec += (long)((MySoundOneBuffLen * 1000000000ULL)
+			/ SOUND_SAMPLERATE);
+		if (t.tv_nsec >= 1000000000) {
+			t.tv_nsec -= 1000000000;
+			++t.tv_sec;
+		}
+		(void) pthread_cond_timedwait(&MySoundCond, &MySoundMutex, &t);
+	}
+	MySoundAtomicPut(MySoundThreadIdle, falseblnr);
+	pthread_mutex_unlock(&MySoundMutex);
+}
+
+LOCALPROC MySoundDev_Error(long r)
+{
+	if (- EPIPE == r) {
+		++MySoundStatUnderruns;
+	} else if (- ESTRPIPE != r) {
+		if (kMySoundSinkAlsa == MySoundSink) {
+			fprintf(stderr, "pcm write error: %s\n",
+				My_snd_strerror(r));
+		} else if (kMySoundSinkNull == MySoundSink) {
+			fprintf(stderr, "Couldn't write %s\n", MySoundFilePath);
+		}
+		MySoundSleepFrames(period_size);
+	}
+	MySoundDev_Prepare();
+	MySoundDevRunning = falseblnr;
+	RsmpSteering = falseblnr; /* find the level again */
+}
+
+LOCALFUNC long MySoundDev_Put(ui3p p, ui5r n)
+{
+	if ((! MySoundDevRunning) && (MySoundDev_Queued() + n > buffer_size))
+	{
+		/* would block before starting, so start now */
+		MySoundDev_Start();
+		MySoundDevRunning = trueblnr;
+	}
+
+	return MySoundDev_Write(p, n);
+}
+
+LOCALFUNC ui5r MySoundWriteIn(tpSoundSamp p, ui4r n)
+{
+	/*
+		give n samples of TheSoundBuffer to the device, returning
+		how many were used up (zero if there was an error).
+	*/
+	long r;
+	ui5r k;
+
+	if (kRsmpOff == RsmpMode) {
+		r = MySoundDev_Put((ui3p)p, n);
+		if (r < 0) {
+			MySoundDev_Error(r);
+			return 0;
+		}
+		return (ui5r)r;
+	}
+
+	Rsmp_In(p, n);
+	for (; ; ) {
+		MySoundOutLen += Rsmp_Out(MySoundOut + MySoundOutLen,
+			period_size - MySoundOutLen);
+		if (MySoundOutLen < period_size) {
+			break;
+		}
+		for (k = 0; k < period_size; k += r) {
+			r = MySoundDev_Put((ui3p)(MySoundOut + k), period_size - k);
+			if (r < 0) {
+				/* the period is lost, the sound stutters anyway */
+				MySoundDev_Error(r);
+				break;
+			}
+		}
+		MySoundOutLen = 0;
+	}
+
+	return n;
+}
+
+LOCALFUNC ui5r MySoundPending(void)
+{
+	/* samples given to the device but not played yet */
+	ui5r n = MySoundDevToIn(MySoundDev_Queued());
+
+	if (kRsmpOff != RsmpMode) {
+		n += MySoundDevToIn(MySoundOutLen) + (RsmpInLen - RsmpInPos);
+	}
+
+	return n;
+}
+
+LOCALPROC MySoundSteer(ui5r queued)
+{
+	struct timespec t;
+	double dt;
+
+	(void) clock_gettime(CLOCK_MONOTONIC, &t);
+	if (RsmpSteering) {
+		dt = (t.tv_sec - MySoundSteerLast.tv_sec)
+			+ (t.tv_nsec - MySoundSteerLast.tv_nsec) / 1e9;
+	} else {
+		dt = 0;
+	}
+	MySoundSteerLast = t;
+
+	/*
+		keep it where the rest of this file keeps it, which
+		follows --audio-latency-ms, plus half a tick since the
+		samples come a tick at a time.
+	*/
+	Rsmp_Steer(queued,
+		(double)MySoundMinFilledWant * MySoundOneBuffLen
+			+ SOUND_SAMPLERATE / 60 / 2,
+		dt);
+}
+
+LOCALFUNC void *MySoundThreadMain(void *arg)
+{
+	ui4b play = ThePlayOffset;
+	ui4b fill;
+	ui4b n;
+	ui4b contig;
+	ui5r queued;
+	ui5r latency;
+	ui5r r;
+	struct sched_param sp;
+
+	(void) arg;
+
+	sp.sched_priority = sched_get_priority_min(SCHED_FIFO);
+	(void) pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+		/* fine if not allowed */
+
+	MySoundDev_Prepare();
+	MySoundDevRunning = falseblnr;
+
+	while (! MySoundAtomicGet(MySoundThreadQuit)) {
+		fill = MySoundAtomicGet(TheFillOffset);
+		n = fill - play;
+		if ((0 == n) || ((! MySoundDevRunning)
+			&& (MySoundPending() + n
+				< (ui5r)MySoundMinFilledWant * MySoundOneBuffLen)))
+		{
+			/* nothing to play, or not enough yet to start */
+			MySoundThreadWait(fill);
+			continue;
+		}
+
+		contig = MySoundOneBuffLen - (play & MySoundOneBuffMask);
+		if (n > contig) {
+			n = contig;
+		}
+		r = MySoundWriteIn(TheSoundBuffer + (play & kAllBuffMask), n);
+		if (0 == r) {
+			continue;
+		}
+
+		play += r;
+		MySoundAtomicPut(ThePlayOffset, play);
+
+		if (! MySoundDevRunning) {
+			if (MySoundPending()
+				>= (ui5r)MySoundMinFilledWant * MySoundOneBuffLen)
+			{
+				/* enough is in the device */
+				MySoundDev_Start();
+				MySoundDevRunning = trueblnr;
+			}
+		} else {
+			/* in samples of TheSoundBuffer, wherever they are */
+			n = MySoundAtomicGet(TheFillOffset) - play;
+			queued = MySoundPending() + n;
+			if (kRsmpOff != RsmpMode) {
+				MySoundSteer(queued);
+			}
+			latency = queued - MySoundDevToIn(MySoundDev_Queued())
+				+ MySoundDevToIn(MySoundDev_Delay());
+			++MySoundStatWrites;
+			MySoundStatLatencySum += latency;
+			if (latency > MySoundStatLatencyMax) {
+				MySoundStatLatencyMax = latency;
+			}
+			MySoundAtomicPut(MySoundStatLatency, latency);
+			if ((queued >> MySoundLnOneBuffLen)
+				< MySoundAtomicGet(MinFilledSoundBuffs))
+			{
+				MySoundAtomicPut(MinFilledSoundBuffs,
+					queued >> MySoundLnOneBuffLen);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+LOCALPROC MySound_Start(void)
+{
+	if (MySoundHaveDev() && ! MySoundThreadOn) {
+		MySound_Start0();
+		if (kRsmpOff != RsmpMode) {
+			Rsmp_Reset();
+			MySoundOutLen = 0;
+		}
+		MySoundThreadQuit = falseblnr;
+		if (0 != pthread_create(&MySoundThread, NULL,
+			MySoundThreadMain, NULL))
+		{
+			fprintf(stderr, "Couldn't start sound thread\n");
+		} else {
+			MySoundThreadOn = trueblnr;
+		}
+	}
+}
+
+LOCALPROC MySound_Stop(void)
+{
+	if (MySoundThreadOn) {
+		pthread_mutex_lock(&MySoundMutex);
+		MySoundAtomicPut(MySoundThreadQuit, trueblnr);
+		pthread_cond_signal(&MySoundCond);
+		pthread_mutex_unlock(&MySoundMutex);
+		(void) pthread_join(MySoundThread, NULL);
+		MySoundThreadOn = falseblnr;
+
+		MySoundDev_Drop();
+	}
+}
+
+LOCALPROC MySound_Report(void)
+{
+	char underruns[32];
+
+	if (MySoundHaveDev()) {
+		if (kMySoundSinkPulse == MySoundSink) {
+			/* the simple api has no way to find out */
+			(void) strcpy(underruns, "underruns not known");
+		} else {
+			(void) sprintf(underruns, "%u underruns",
+				(unsigned int)MySoundStatUnderruns);
+		}
+		fprintf(stderr,
+			"sound: %s, %s, %u samples dropped,"
+			" latency %u ms average, %u ms most\n",
+			(kMySoundSinkPulse == MySoundSink) ? "pulse"
+				: (kMySoundSinkAlsa == MySoundSink) ? "alsa"
+				: (NULL != MySoundFile) ? "file" : "null",
+			underruns,
+			(unsigned int)MySoundStatDropped,
+			(0 == MySoundStatWrites) ? 0 : MySoundFramesToMs(
+				MySoundStatLatencySum / MySoundStatWrites),
+			MySoundFramesToMs(MySoundStatLatencyMax));
+		if (0 != MySoundLatencyMs) {
+			fprintf(stderr,
+				"sound: aiming for %u ms, blocks of %u samples,"
+				" device period %lu and buffer %lu frames\n",
+				(unsigned int)MySoundLatencyMs,
+				(unsigned int)MySoundOneBuffLen,
+				(unsigned long)period_size, (unsigned long)buffer_size);
+		}
+		if (kRsmpOff != RsmpMode) {
+			Rsmp_Report();
+		}
+	}
+}
+
+#endif /* UseSoundThread */
+
 LOCALFUNC blnr MySound_Init(void)
 {
+#if UseSoundThread
+	MySound_SetLatency();
+	if (NULL != MySoundFilePath) {
+		MySoundSinkWant = kMySoundSinkNull;
+	} else if ((kMySoundSinkNone == MySoundSinkWant)
+		&& (NULL != alsadev_name))
+	{
+		MySoundSinkWant = kMySoundSinkAlsa;
+	}
+
+	if (((kMySoundSinkNone == MySoundSinkWant)
+			|| (kMySoundSinkPulse == MySoundSinkWant))
+		&& MySoundPulse_Open())
+	{
+		MySoundSink = kMySoundSinkPulse;
+	} else
+	if (((kMySoundSinkNone == MySoundSinkWant)
+			|| (kMySoundSinkAlsa == MySoundSinkWant))
+		&& MySoundAlsa_Open())
+	{
+		MySoundSink = kMySoundSinkAlsa;
+	} else
+	if ((kMySoundSinkNone == MySoundSinkWant)
+		|| (kMySoundSinkNull == MySoundSinkWant))
+	{
+		if (! MySoundNull_Open()) {
+			return falseblnr;
+		}
+		MySoundSink = kMySoundSinkNull;
+	}
+
+	if ((kRsmpOff != RsmpMode) && MySoundHaveDev()) {
+		MySoundOut = (si4b *)malloc(period_size * sizeof(si4b));
+		MySoundOutLen = 0;
+		if (NULL == MySoundOut) {
+			fprintf(stderr, "Couldn't allocate sound buffer\n");
+			return falseblnr;
+		}
+	}
+#else
 	if (HaveAlsaRoutines()) {
 		MySound_Init0();
 	}
+#endif
 
 	return trueblnr; /* keep going, even if no sound */
 }
 
 LOCALPROC MySound_UnInit(void)
 {
+#if UseSoundThread
+	MySound_Report();
+	MySoundDev_Close();
+	MyClosePulseLib();
+	if (NULL != MySoundOut) {
+		free(MySoundOut);
+		MySoundOut = NULL;
+	}
+	Rsmp_UnInit();
+#endif
 	if (NULL != pcm_handle) {
 		if (HaveMy_snd_pcm_close()) {
 			My_snd_pcm_close(pcm_handle);
@@ -1600,17 +2484,52 @@ LOCALPROC MySound_UnInit(void)
 GLOBALOSGLUPROC MySound_EndWrite(ui4r actL)
 {
 	if (MySound_EndWrite0(actL)) {
+#if UseSoundThread
+		ConvertSoundBlockToNative(TheSoundBuffer
+			+ ((TheWriteOffset - MySoundOneBuffLen) & kAllBuffMask));
+		MySoundAtomicPut(TheFillOffset, TheWriteOffset);
+		MySoundAtomicFence(); /* see MySoundThreadWait */
+		if (MySoundAtomicGet(MySoundThreadIdle)) {
+			pthread_mutex_lock(&MySoundMutex);
+			pthread_cond_signal(&MySoundCond);
+			pthread_mutex_unlock(&MySoundMutex);
+		}
+#else
 		ConvertSoundBlockToNative(TheSoundBuffer
 			+ ((TheFillOffset - kOneBuffLen) & kAllBuffMask));
 		if (NULL != pcm_handle) {
 			MySound_WriteOut();
 		}
+#endif
 	}
 }
 
 LOCALPROC MySound_SecondNotify(void)
 {
-	if (NULL != pcm_handle) {
+#if UseSoundThread
+#if dbglog_SoundBuffStats
+	if (MySoundHaveDev()) {
+		dbglog_writeCStr("sound latency ms ");
+		dbglog_writeNum(MySoundFramesToMs(
+			MySoundAtomicGet(MySoundStatLatency)));
+		dbglog_writeCStr(", min filled ");
+		dbglog_writeNum(MySoundAtomicGet(MinFilledSoundBuffs));
+		if (kMySoundSinkPulse != MySoundSink) {
+			dbglog_writeCStr(", underruns ");
+			dbglog_writeNum(MySoundStatUnderruns);
+		}
+		dbglog_writeReturn();
+	}
+#endif
+	/*
+		when resampling, the rate is steered to match instead
+		of the emulation being slowed or hurried.
+	*/
+	if (MySoundHaveDev() && (kRsmpOff == RsmpMode))
+#else
+	if (NULL != pcm_handle)
+#endif
+	{
 		MySound_SecondNotify0();
 	}
 }
@@ -0,0 +1,153 @@
+/*
+	SGLUPULS.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	Sound GLUe for PULSEaudio
+
+	The "simple" api of libpulse-simple, which PipeWire also
+	provides, so on most desktops the samples go straight to the
+	sound server instead of through its alsa plugin. Like alsa in
+	SGLUALSA.h, the library is found with dlopen, so the program
+	still runs where it isn't installed. Only used as one of the
+	sinks of the sound thread.
+*/
+
+#ifdef SGLUPULS_H
+#error "header already included"
+#else
+#define SGLUPULS_H
+#endif
+
+static void *pulse_handle = NULL;
+
+LOCALVAR blnr DidPulseLib = falseblnr;
+
+LOCALFUNC blnr HavePulseLib(void)
+{
+	if (! DidPulseLib) {
+		pulse_handle = dlopen("libpulse-simple.so.0", RTLD_NOW);
+		DidPulseLib = trueblnr;
+	}
+	return (pulse_handle != NULL);
+}
+
+LOCALPROC MyClosePulseLib(void)
+{
+	if (NULL != pulse_handle) {
+		if (0 != dlclose(pulse_handle)) {
+			fprintf(stderr, "dlclose libpulse-simple failed\n");
+		}
+		pulse_handle = NULL;
+	}
+}
+
+/* An opaque simple connection object */
+typedef struct My__pa_simple My_pa_simple;
+
+/* Sample format */
+typedef enum My__pa_sample_format {
+	My_PA_SAMPLE_U8 = 0,
+	My_PA_SAMPLE_ALAW,
+	My_PA_SAMPLE_ULAW,
+	My_PA_SAMPLE_S16LE,
+	My_PA_SAMPLE_S16BE
+} My_pa_sample_format_t;
+
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+#define My_PA_SAMPLE_S16NE My_PA_SAMPLE_S16LE
+#else
+#define My_PA_SAMPLE_S16NE My_PA_SAMPLE_S16BE
+#endif
+
+/* A sample format and attribute specification */
+typedef struct My__pa_sample_spec {
+	My_pa_sample_format_t format;
+	ui5b rate;
+	ui3b channels;
+} My_pa_sample_spec;
+
+/* Playback and record buffer metrics, in bytes */
+typedef struct My__pa_buffer_attr {
+	ui5b maxlength;
+	ui5b tlength;
+	ui5b prebuf;
+	ui5b minreq;
+	ui5b fragsize;
+} My_pa_buffer_attr;
+
+/* The direction of a pa_stream object */
+typedef enum My__pa_stream_direction {
+	My_PA_STREAM_NODIRECTION,
+	My_PA_STREAM_PLAYBACK,
+	My_PA_STREAM_RECORD,
+	My_PA_STREAM_UPLOAD
+} My_pa_stream_direction_t;
+
+/* Type for usec specifications */
+typedef unsigned long long My_pa_usec_t;
+
+typedef My_pa_simple * (*pa_simple_new_ProcPtr)
+	(const char *server, const char *name,
+		My_pa_stream_direction_t dir, const char *dev,
+		const char *stream_name, const My_pa_sample_spec *ss,
+		const void *map, const My_pa_buffer_attr *attr, int *error);
+LOCALVAR pa_simple_new_ProcPtr My_pa_simple_new = NULL;
+
+typedef void (*pa_simple_free_ProcPtr)(My_pa_simple *s);
+LOCALVAR pa_simple_free_ProcPtr My_pa_simple_free = NULL;
+
+typedef int (*pa_simple_write_ProcPtr)
+	(My_pa_simple *s, const void *data, size_t bytes, int *error);
+LOCALVAR pa_simple_write_ProcPtr My_pa_simple_write = NULL;
+
+typedef int (*pa_simple_flush_ProcPtr)(My_pa_simple *s, int *error);
+LOCALVAR pa_simple_flush_ProcPtr My_pa_simple_flush = NULL;
+
+typedef My_pa_usec_t (*pa_simple_get_latency_ProcPtr)
+	(My_pa_simple *s, int *error);
+LOCALVAR pa_simple_get_latency_ProcPtr My_pa_simple_get_latency = NULL;
+
+typedef const char * (*pa_strerror_ProcPtr)(int error);
+LOCALVAR pa_strerror_ProcPtr My_pa_strerror = NULL;
+	/* from libpulse, which libpulse-simple brings along */
+
+LOCALVAR blnr DidPulseRoutines = falseblnr;
+
+LOCALFUNC blnr HavePulseRoutines(void)
+{
+	if ((! DidPulseRoutines) && HavePulseLib()) {
+		My_pa_simple_new = (pa_simple_new_ProcPtr)
+			dlsym(pulse_handle, "pa_simple_new");
+		My_pa_simple_free = (pa_simple_free_ProcPtr)
+			dlsym(pulse_handle, "pa_simple_free");
+		My_pa_simple_write = (pa_simple_write_ProcPtr)
+			dlsym(pulse_handle, "pa_simple_write");
+		My_pa_simple_flush = (pa_simple_flush_ProcPtr)
+			dlsym(pulse_handle, "pa_simple_flush");
+		My_pa_simple_get_latency = (pa_simple_get_latency_ProcPtr)
+			dlsym(pulse_handle, "pa_simple_get_latency");
+		My_pa_strerror = (pa_strerror_ProcPtr)
+			dlsym(pulse_handle, "pa_strerror");
+		DidPulseRoutines = trueblnr;
+	}
+
+	return (NULL != My_pa_simple_new)
+		&& (NULL != My_pa_simple_free)
+		&& (NULL != My_pa_simple_write)
+		&& (NULL != My_pa_simple_flush)
+		&& (NULL != My_pa_simple_get_latency)
+		&& (NULL != My_pa_strerror);
+}
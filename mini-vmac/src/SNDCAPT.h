@@ -0,0 +1,248 @@
+/*
+	SNDCAPT.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	SouND CAPTure
+
+	Write every sample the emulated machine makes to a file, to
+	go with a screen capture (see SCRNCAPT.h) in a video. The
+	OSGLU's MySound_EndWrite hands over what ASC_SubTick (and
+	anything mixed in with it) just made, before the host sound
+	code sees it, along with OnTrueTime, the tick screen captures
+	are stamped with, and SoundSubTick. So the samples are the
+	same, whether or not the host kept up, and the same from run
+	to run when replaying a recording. As with the screen
+	capture, a separate thread writes the file (see
+	CAPTWRTR.h).
+
+	If the name ends with ".wav", it is a WAV file. Ticks that
+	weren't emulated are filled with silence, so tick t starts at
+	sample (t - t0) * kSndCaptTickLen, t0 being the tick capturing
+	started at, which is also the tick of the first frame of a
+	screen capture started with it.
+
+	Otherwise the file starts with "MnvMSndC", then the version,
+	sample rate and bits per sample as 4, 4 and 2 byte little
+	endian numbers. Then come sample records:
+
+		'S', tick (4 bytes), sub tick (1 byte), number of
+		samples (2 bytes), then the samples.
+
+	Samples are as in a WAV file, 8 bit unsigned or 16 bit
+	signed little endian. The file ends with 'E' and the tick
+	capturing stopped at.
+
+	The OSGLUxxx file includes this after COMOSGLU.h, CAPTWRTR.h
+	and SNDWAVFL.h, calls SndCapt_Init and SndCapt_UnInit along
+	with ScrnCapt_Init and ScrnCapt_UnInit, and SndCapt_Samples
+	from MySound_EndWrite. SndCaptPath is set by the
+	--sound-capture argument.
+*/
+
+#ifdef SNDCAPT_H
+#error "header already included"
+#else
+#define SNDCAPT_H
+#endif
+
+#define kSndCaptVersion 1
+
+#define kSndCaptTagSamples 'S'
+#define kSndCaptTagEnd 'E'
+
+#define kSndCaptRate 22255
+#define kSndCaptTickLen 370
+	/* samples ASC_SubTick makes in a tick, the sum of SubTick_n */
+
+#define kSndCaptSampSz (1 << (kLn2SoundSampSz - 3))
+
+#ifndef SndCaptBuffSz
+#define SndCaptBuffSz (256 * 1024)
+	/* about 10 seconds of 8 bit sound */
+#endif
+
+#define kSndCaptRecMax 512
+	/* most samples in a record, more are split */
+
+LOCALVAR char *SndCaptPath = NULL;
+LOCALVAR FILE *SndCaptFile = NULL;
+LOCALVAR blnr SndCaptOn = falseblnr;
+LOCALVAR blnr SndCaptWav;
+
+LOCALVAR ui5r SndCaptTick; /* of the last samples */
+LOCALVAR ui5r SndCaptTickDone; /* samples of SndCaptTick so far */
+
+LOCALVAR ui3b SndCaptRec[8 + kSndCaptRecMax * kSndCaptSampSz];
+	/* one record is put together here */
+
+LOCALVAR CaptWrtrR SndCaptWrtr;
+
+LOCALVAR unsigned long long SndCaptStatSamples = 0;
+LOCALVAR unsigned long long SndCaptStatSilence = 0;
+
+LOCALFUNC ui3p SndCaptPutSamps(ui3p p, tpSoundSamp s, ui4r n)
+{
+	/* as they go in a WAV file */
+	ui4r i;
+
+#if 4 == kLn2SoundSampSz
+	for (i = 0; i < n; ++i) {
+		ui4r v = s[i] - 0x8000;
+
+		*p++ = v & 0xFF;
+		*p++ = (v >> 8) & 0xFF;
+	}
+#else
+	for (i = 0; i < n; ++i) {
+		*p++ = s[i];
+	}
+#endif
+
+	return p;
+}
+
+LOCALPROC SndCaptSilence(ui5r n)
+{
+	/* n samples of silence, in a WAV file */
+	ui4r m;
+
+	SndCaptStatSilence += n;
+#if 4 == kLn2SoundSampSz
+	(void) memset(SndCaptRec, 0, sizeof(SndCaptRec));
+#else
+	(void) memset(SndCaptRec, 0x80, sizeof(SndCaptRec));
+#endif
+	while (0 != n) {
+		m = (n > kSndCaptRecMax) ? kSndCaptRecMax : n;
+		CaptWrtr_Put(&SndCaptWrtr, SndCaptRec, (ui5r)m * kSndCaptSampSz);
+		n -= m;
+	}
+}
+
+LOCALPROC SndCapt_Samples(tpSoundSamp s, ui4r n)
+{
+	ui3p p;
+	ui4r m;
+
+	if (! SndCaptOn) {
+		return;
+	}
+
+	SndCaptStatSamples += n;
+
+	if (SndCaptWav && (OnTrueTime != SndCaptTick)) {
+		if ((OnTrueTime - SndCaptTick) < 0x80000000) {
+			/* the rest of this tick, and any skipped */
+			SndCaptSilence((OnTrueTime - SndCaptTick)
+				* (ui5r)kSndCaptTickLen
+				- ((SndCaptTickDone < kSndCaptTickLen)
+					? SndCaptTickDone : kSndCaptTickLen));
+		}
+		SndCaptTick = OnTrueTime;
+		SndCaptTickDone = 0;
+	}
+
+	while (0 != n) {
+		m = (n > kSndCaptRecMax) ? kSndCaptRecMax : n;
+		p = SndCaptRec;
+		if (! SndCaptWav) {
+			*p++ = kSndCaptTagSamples;
+			p = CaptPut4(p, OnTrueTime);
+			*p++ = SoundSubTick;
+			p = CaptPut2(p, m);
+		}
+		p = SndCaptPutSamps(p, s, m);
+		CaptWrtr_Put(&SndCaptWrtr, SndCaptRec, p - SndCaptRec);
+		SndCaptTickDone += m;
+		s += m;
+		n -= m;
+	}
+}
+
+LOCALFUNC blnr SndCapt_Init(void)
+{
+	ui3b h[18];
+
+	if (NULL == SndCaptPath) {
+		return trueblnr;
+	}
+
+	SndCaptFile = fopen(SndCaptPath, "wb");
+	if (NULL == SndCaptFile) {
+		fprintf(stderr, "Couldn't create sound capture %s\n",
+			SndCaptPath);
+		return falseblnr;
+	}
+
+	SndCaptWav = WavFl_IsWavPath(SndCaptPath);
+	if (SndCaptWav) {
+		(void) WavFl_Header(SndCaptFile, kSndCaptRate,
+			kSndCaptSampSz * 8, 0);
+	} else {
+		MyMoveBytes((anyp)"MnvMSndC", (anyp)h, 8);
+		(void) CaptPut2(CaptPut4(
+			CaptPut4(h + 8, kSndCaptVersion),
+			kSndCaptRate), kSndCaptSampSz * 8);
+		(void) fwrite(h, 1, 18, SndCaptFile);
+	}
+	SndCaptTick = OnTrueTime;
+	SndCaptTickDone = 0;
+
+	if (! CaptWrtr_Start(&SndCaptWrtr, SndCaptFile, SndCaptBuffSz)) {
+		return falseblnr;
+	}
+	SndCaptOn = trueblnr;
+
+	return trueblnr;
+}
+
+LOCALPROC SndCapt_UnInit(void)
+{
+	ui3b h[5];
+
+	if (SndCaptOn) {
+		if (! SndCaptWav) {
+			h[0] = kSndCaptTagEnd;
+			(void) CaptPut4(h + 1, OnTrueTime);
+			CaptWrtr_Put(&SndCaptWrtr, h, 5);
+		}
+
+		CaptWrtr_Stop(&SndCaptWrtr);
+		SndCaptOn = falseblnr;
+
+		if (SndCaptWav && ! WavFl_Finish(SndCaptFile, kSndCaptRate,
+			kSndCaptSampSz * 8, SndCaptWrtr.StatBytes))
+		{
+			SndCaptWrtr.Failed = trueblnr;
+		}
+
+		fprintf(stderr,
+			"sound capture: %llu samples, %llu of silence added,"
+			" %u waits for the writer\n",
+			SndCaptStatSamples, SndCaptStatSilence,
+			(unsigned int)SndCaptWrtr.StatWaits);
+	} else {
+		CaptWrtr_Stop(&SndCaptWrtr);
+	}
+
+	if (NULL != SndCaptFile) {
+		if ((0 != fclose(SndCaptFile)) || SndCaptWrtr.Failed) {
+			fprintf(stderr, "Couldn't write sound capture %s\n",
+				SndCaptPath);
+		}
+		SndCaptFile = NULL;
+	}
+}
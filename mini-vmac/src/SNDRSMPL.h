@@ -0,0 +1,400 @@
+/*
+	SNDRSMPL.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	SouND ReSaMPLer
+
+	The emulated machine makes sound at 22255 Hz, which sound
+	hardware doesn't do, so it is converted somewhere, usually
+	by the alsa plug layer or the sound server, adding latency.
+	Instead the sound thread of SGLUALSA.h can use this to
+	make 16 bit samples at the rate the device runs at (such as
+	44100 or 48000) itself.
+
+	kRsmpSinc is a polyphase filter, a windowed sinc of
+	kRsmpTaps taps for each of kRsmpPhases fractional positions,
+	in 16 bit fixed point, the dot product done with SSE2 or
+	NEON where there is one. Each output sample is interpolated
+	between the two nearest positions. kRsmpLinear just
+	interpolates between two samples, for slow machines.
+
+	Measured from the coefficients as made (14 bit) and by
+	resampling sines to 48000 Hz: flat to 8 kHz, -0.5 dB at
+	9 kHz and -6 dB at 10 kHz, images of anything up to 10 kHz
+	(so from 12.3 kHz up) at least 74 dB down, and about 77 dB
+	signal to noise for a sine at half of full scale from 1 to
+	5 kHz. With 16 taps the images were only 29 dB down, and
+	without interpolating between positions the noise was 50 dB
+	down at 5 kHz.
+
+	The emulation runs from the host clock at (about) 60.15
+	ticks a second, while the device plays from a clock of its
+	own, and also with --frame-pacing lock the tick follows the
+	display. So the ratio of the rates is steered slightly (at
+	most kRsmpMaxAdjust) to keep the samples waiting to be
+	played at the level the caller asks for each time, rather
+	than adjusting the emulated time as MySound_SecondNotify0
+	does.
+
+	Rsmp_In takes up to kRsmpMaxIn samples of the emulation's
+	sound at a time, then Rsmp_Out is called until it can't
+	give as many samples as asked for.
+*/
+
+#ifdef SNDRSMPL_H
+#error "header already included"
+#else
+#define SNDRSMPL_H
+#endif
+
+#include <math.h>
+
+#define kRsmpOff 0
+#define kRsmpLinear 1
+#define kRsmpSinc 2
+
+#ifndef WantInitRsmpMode
+#define WantInitRsmpMode kRsmpSinc
+#endif
+
+#ifndef WantInitRsmpRate
+#define WantInitRsmpRate 48000
+#endif
+
+#define kRsmpTaps 32
+#define kLnRsmpPhases 8
+#define kRsmpPhases (1 << kLnRsmpPhases)
+#define kLnRsmpCoefOne 14
+#define kRsmpMaxIn kOneBuffLen
+#define kRsmpInSz (kRsmpMaxIn + kRsmpTaps)
+#define kRsmpMaxAdjust 0.01
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define Rsmp_SSE2 1
+#else
+#define Rsmp_SSE2 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define Rsmp_NEON 1
+#else
+#define Rsmp_NEON 0
+#endif
+
+#if Rsmp_SSE2
+#include <emmintrin.h>
+#endif
+#if Rsmp_NEON
+#include <arm_neon.h>
+#endif
+
+LOCALVAR int RsmpMode = WantInitRsmpMode; /* set by --sound-resample */
+LOCALVAR ui5r RsmpWantRate = WantInitRsmpRate; /* set by --sound-rate */
+
+LOCALVAR ui5r RsmpInRate;
+LOCALVAR ui5r RsmpOutRate;
+LOCALVAR si4b *RsmpCoef = nullpr;
+LOCALVAR si4b RsmpIn[kRsmpInSz];
+LOCALVAR ui4r RsmpInLen;
+LOCALVAR ui4r RsmpInPos; /* where the next window starts */
+LOCALVAR ui5r RsmpInFrac; /* and how far past it, in 2^-32 */
+LOCALVAR unsigned long long RsmpBaseStep;
+LOCALVAR unsigned long long RsmpStep; /* 32.32 */
+
+LOCALVAR blnr RsmpSteering;
+LOCALVAR double RsmpQueuedAvg;
+LOCALVAR double RsmpAdjustI;
+LOCALVAR double RsmpAdjust;
+LOCALVAR double RsmpAdjustSum = 0;
+LOCALVAR ui5r RsmpAdjustN = 0;
+
+/* --- making the filter --- */
+
+#define RsmpPi 3.14159265358979323846
+
+LOCALFUNC double RsmpTap(double t, double fc)
+{
+	/*
+		sinc cut off at fc of the input's Nyquist frequency,
+		t in input samples from the center, Blackman window.
+	*/
+	double u = t / (kRsmpTaps / 2);
+	double x = RsmpPi * fc * t;
+	double w;
+
+	if ((u <= -1.0) || (u >= 1.0)) {
+		return 0;
+	}
+	w = 0.42 + 0.5 * cos(RsmpPi * u) + 0.08 * cos(2 * RsmpPi * u);
+
+	return w * ((t == 0) ? fc : (fc * sin(x) / x));
+}
+
+LOCALFUNC blnr RsmpMakeCoef(void)
+{
+	int p;
+	int j;
+	int v;
+	int sum;
+	double h[kRsmpTaps];
+	double hsum;
+	si4b *c;
+
+	if (nullpr == RsmpCoef) {
+		RsmpCoef = (si4b *)malloc(
+			(kRsmpPhases + 1) * kRsmpTaps * sizeof(si4b));
+		if (nullpr == RsmpCoef) {
+			return falseblnr;
+		}
+	}
+
+	for (p = 0; p <= kRsmpPhases; ++p) {
+		/*
+			window starts kRsmpTaps / 2 - 1 samples
+			before the one the output is p / kRsmpPhases past.
+			The extra last one is for interpolating past
+			kRsmpPhases - 1.
+		*/
+		hsum = 0;
+		for (j = 0; j < kRsmpTaps; ++j) {
+			h[j] = RsmpTap(j - (kRsmpTaps / 2 - 1)
+				- (double)p / kRsmpPhases, 0.9);
+			hsum += h[j];
+		}
+
+		/* each phase sums to one, rounding left in the middle */
+		c = RsmpCoef + p * kRsmpTaps;
+		sum = 0;
+		for (j = 0; j < kRsmpTaps; ++j) {
+			v = (int)(h[j] / hsum * (1 << kLnRsmpCoefOne)
+				+ ((h[j] < 0) ? -0.5 : 0.5));
+			c[j] = v;
+			sum += v;
+		}
+		c[kRsmpTaps / 2 - 1] += (1 << kLnRsmpCoefOne) - sum;
+	}
+
+	return trueblnr;
+}
+
+/* --- the filter --- */
+
+#if Rsmp_SSE2
+LOCALFUNC si5r RsmpDot(si4b *x, si4b *c)
+{
+	int j;
+	__m128i a = _mm_setzero_si128();
+
+	for (j = 0; j < kRsmpTaps; j += 8) {
+		a = _mm_add_epi32(a, _mm_madd_epi16(
+			_mm_loadu_si128((__m128i *)(x + j)),
+			_mm_loadu_si128((__m128i *)(c + j))));
+	}
+	a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0x4E));
+	a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0xB1));
+
+	return _mm_cvtsi128_si32(a);
+}
+#elif Rsmp_NEON
+LOCALFUNC si5r RsmpDot(si4b *x, si4b *c)
+{
+	int j;
+	int32x4_t a = vmull_s16(vld1_s16(x), vld1_s16(c));
+	int32x2_t b;
+
+	for (j = 4; j < kRsmpTaps; j += 4) {
+		a = vmlal_s16(a, vld1_s16(x + j), vld1_s16(c + j));
+	}
+	b = vadd_s32(vget_low_s32(a), vget_high_s32(a));
+
+	return vget_lane_s32(vpadd_s32(b, b), 0);
+}
+#else
+LOCALFUNC si5r RsmpDot(si4b *x, si4b *c)
+{
+	int j;
+	si5r a = 0;
+
+	for (j = 0; j < kRsmpTaps; ++j) {
+		a += (si5r)x[j] * c[j];
+	}
+
+	return a;
+}
+#endif
+
+/* --- interface for SGLUALSA.h --- */
+
+LOCALPROC Rsmp_Reset(void)
+{
+	int j;
+
+	/* start with silence before the first sample */
+	for (j = 0; j < kRsmpTaps / 2 - 1; ++j) {
+		RsmpIn[j] = 0;
+	}
+	RsmpInLen = kRsmpTaps / 2 - 1;
+	RsmpInPos = 0;
+	RsmpInFrac = 0;
+	RsmpSteering = falseblnr;
+	RsmpAdjust = 0;
+	RsmpStep = RsmpBaseStep;
+}
+
+LOCALPROC Rsmp_Init(ui5r InRate, ui5r OutRate)
+{
+	RsmpInRate = InRate;
+	RsmpOutRate = OutRate;
+	if (OutRate < InRate) {
+		/* the filter is only made for going up */
+		RsmpMode = kRsmpLinear;
+	}
+	if ((kRsmpSinc == RsmpMode) && ! RsmpMakeCoef()) {
+		RsmpMode = kRsmpLinear;
+	}
+	RsmpBaseStep = ((unsigned long long)InRate << 32) / OutRate;
+	Rsmp_Reset();
+}
+
+LOCALPROC Rsmp_UnInit(void)
+{
+	if (nullpr != RsmpCoef) {
+		free(RsmpCoef);
+		RsmpCoef = nullpr;
+	}
+}
+
+LOCALPROC Rsmp_In(tpSoundSamp p, ui4r n)
+{
+	/* n is at most kRsmpMaxIn */
+	si4b *d;
+	ui4r k = RsmpInLen - RsmpInPos;
+
+	if (0 != RsmpInPos) {
+		MyMoveBytes((anyp)(RsmpIn + RsmpInPos), (anyp)RsmpIn,
+			k * sizeof(si4b));
+		RsmpInPos = 0;
+		RsmpInLen = k;
+	}
+
+	d = RsmpIn + RsmpInLen;
+	RsmpInLen += n;
+	for (; n > 0; --n) {
+#if 3 == kLn2SoundSampSz
+		*d++ = ((si4b)*p++ - 0x80) * 0x100;
+#else
+		*d++ = (si4b)*p++; /* already made signed */
+#endif
+	}
+}
+
+LOCALFUNC ui4r Rsmp_Out(si4b *p, ui4r n)
+{
+	/* as many as n samples, fewer when Rsmp_In is needed */
+	ui4r i;
+	si5r v;
+	si5r v1;
+	si4b *x;
+	si4b *c;
+	unsigned long long t;
+
+	for (i = 0; i < n; ++i) {
+		if (RsmpInPos + kRsmpTaps > RsmpInLen) {
+			break;
+		}
+		x = RsmpIn + RsmpInPos;
+		if (kRsmpSinc == RsmpMode) {
+			/* between the two nearest positions */
+			c = RsmpCoef
+				+ (RsmpInFrac >> (32 - kLnRsmpPhases)) * kRsmpTaps;
+			v = RsmpDot(x, c);
+			v1 = RsmpDot(x, c + kRsmpTaps);
+			v = (v + (si5r)(((long long)(v1 - v)
+				* (si5r)((RsmpInFrac >> (16 - kLnRsmpPhases))
+					& 0xFFFF)) >> 16))
+				>> kLnRsmpCoefOne;
+			if (v > 0x7FFF) {
+				v = 0x7FFF;
+			} else if (v < -0x8000) {
+				v = -0x8000;
+			}
+		} else {
+			x += kRsmpTaps / 2 - 1;
+			v = x[0] + (si5r)(((x[1] - x[0])
+				* (si5r)(RsmpInFrac >> 17)) >> 15);
+		}
+		p[i] = v;
+
+		t = (unsigned long long)RsmpInFrac + RsmpStep;
+		RsmpInPos += (ui4r)(t >> 32);
+		RsmpInFrac = (ui5r)t;
+	}
+
+	return i;
+}
+
+LOCALPROC Rsmp_Steer(double Queued, double Want, double dt)
+{
+	/*
+		Queued is how many input samples are waiting, in the
+		device and before it, Want how many there should be,
+		dt the seconds since the last call. Average it, then
+		nudge the ratio towards keeping it at Want
+		(proportional and integral, slow enough for the pitch
+		change not to be heard). Want is asked for each time,
+		so it follows any change in what the caller aims for.
+	*/
+	double e;
+	double a = dt / 0.5;
+
+	if (! RsmpSteering) {
+		RsmpSteering = trueblnr;
+		RsmpQueuedAvg = Queued;
+		RsmpAdjustI = RsmpAdjust;
+		return;
+	}
+
+	RsmpQueuedAvg += (Queued - RsmpQueuedAvg) * ((a > 1) ? 1 : a);
+
+	e = (RsmpQueuedAvg - Want) / RsmpInRate;
+		/* in seconds */
+	RsmpAdjustI += e * dt * 0.03;
+	if (RsmpAdjustI > kRsmpMaxAdjust) {
+		RsmpAdjustI = kRsmpMaxAdjust;
+	} else if (RsmpAdjustI < - kRsmpMaxAdjust) {
+		RsmpAdjustI = - kRsmpMaxAdjust;
+	}
+	RsmpAdjust = RsmpAdjustI + e * 0.3;
+	if (RsmpAdjust > kRsmpMaxAdjust) {
+		RsmpAdjust = kRsmpMaxAdjust;
+	} else if (RsmpAdjust < - kRsmpMaxAdjust) {
+		RsmpAdjust = - kRsmpMaxAdjust;
+	}
+
+	RsmpStep = (unsigned long long)((double)RsmpBaseStep
+		* (1.0 + RsmpAdjust));
+	RsmpAdjustSum += RsmpAdjust;
+	++RsmpAdjustN;
+}
+
+LOCALPROC Rsmp_Report(void)
+{
+	fprintf(stderr, "sound: resampled to %u Hz (%s), rate adjusted"
+		" by %+.0f ppm on average\n",
+		(unsigned int)RsmpOutRate,
+		(kRsmpSinc == RsmpMode) ? "sinc" : "linear",
+		(0 == RsmpAdjustN) ? 0.0 : RsmpAdjustSum / RsmpAdjustN * 1e6);
+}
@@ -0,0 +1,90 @@
+/*
+	SNDWAVFL.h
+
+	Copyright (C) 2026 Blah Blob developers
+
+	You can redistribute this file and/or modify it under the terms
+	of version 2 of the GNU General Public License as published by
+	the Free Software Foundation.  You should have received a copy
+	of the license along with this file; see the file COPYING.
+
+	This file is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	license for more details.
+*/
+
+/*
+	SouND WAVe FiLe
+
+	Mono 8 bit (unsigned) or 16 bit (signed, little endian)
+	samples written to a file are made into a WAV file by
+	WavFl_Header, called once before the samples with a length
+	of zero to leave room, and once after, at the start of the
+	file again, with the real length. If the file can't be
+	rewound (a pipe), most programs still read the samples,
+	as the length is then the largest there is.
+*/
+
+#ifdef SNDWAVFL_H
+#error "header already included"
+#else
+#define SNDWAVFL_H
+#endif
+
+#define kWavFlHeaderSz 44
+
+LOCALPROC WavFl_Put4(ui3p p, ui5r v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+LOCALFUNC blnr WavFl_Header(FILE *f, ui5r rate, ui3r bits, ui5r n)
+{
+	/* n bytes of samples */
+	ui3b h[kWavFlHeaderSz];
+	ui3r sz = bits >> 3;
+
+	if ((0 == n) || (n > 0xFFFFFFFF - (kWavFlHeaderSz - 8))) {
+		n = 0xFFFFFFFF - (kWavFlHeaderSz - 8);
+	}
+
+	(void) memcpy(h + 0, "RIFF", 4);
+	WavFl_Put4(h + 4, n + (kWavFlHeaderSz - 8));
+	(void) memcpy(h + 8, "WAVEfmt ", 8);
+	WavFl_Put4(h + 16, 16);
+	WavFl_Put4(h + 20, 1 /* pcm */ | (1 << 16) /* mono */);
+	WavFl_Put4(h + 24, rate);
+	WavFl_Put4(h + 28, rate * sz);
+	WavFl_Put4(h + 32, sz | (bits << 16));
+	(void) memcpy(h + 36, "data", 4);
+	WavFl_Put4(h + 40, n);
+
+	return (1 == fwrite(h, kWavFlHeaderSz, 1, f));
+}
+
+LOCALFUNC blnr WavFl_IsWavPath(char *path)
+{
+	/* ends with ".wav", in any case */
+	size_t L = strlen(path);
+
+	return (L >= 4)
+		&& ('.' == path[L - 4])
+		&& ('w' == (path[L - 3] | 0x20))
+		&& ('a' == (path[L - 2] | 0x20))
+		&& ('v' == (path[L - 1] | 0x20));
+}
+
+LOCALFUNC blnr WavFl_Finish(FILE *f, ui5r rate, ui3r bits,
+	unsigned long long n)
+{
+	/* fill in the length, if the file can be rewound */
+	if (0 != fseek(f, 0, SEEK_SET)) {
+		return trueblnr;
+	}
+
+	return WavFl_Header(f, rate, bits, (n > 0xFFFFFFFF) ? 0 : (ui5r)n);
+}
@@ -476,9 +476,74 @@ LOCALVAR ui4r DelayUntilNextInsert;
 
 LOCALVAR CPTR MountCallBack = 0;
 
+#if IncludeSonyAsync
+/*
+	A Prime call that isn't immediate can be handed to the OSGLU
+	(vSonyTransferStart), and the driver told it is in progress,
+	so the emulation goes on while the host reads or writes the
+	image. Sony_Update then checks for it to be done, and goes to
+	sony_done in the ROM (see ROMEMDEV.c), which gets the result
+	with kCmndSonyDone and calls IODone.
+*/
+
+LOCALVAR blnr SonyAsyncPending = falseblnr;
+	/* handed to the OSGLU, not done yet */
+LOCALVAR blnr SonyAsyncFinished = falseblnr;
+	/* done, waiting for kCmndSonyDone */
+LOCALVAR CPTR SonyAsyncParamBlk;
+LOCALVAR CPTR SonyAsyncDeviceCtl;
+LOCALVAR tDrive SonyAsyncDrive_No;
+LOCALVAR blnr SonyAsyncIsWrite;
+LOCALVAR ui5r SonyAsyncStart;
+LOCALVAR ui5r SonyAsyncCount;
+LOCALVAR blnr SonyAsyncHitEOF;
+LOCALVAR tMacErr SonyAsyncResult;
+LOCALVAR ui5r SonyAsyncActCount;
+
+#define kSonyInProgress ((tMacErr) 0x0001)
+	/* ioResult while the Device Manager waits */
+
+#if (CurEmMd == kEmMd_II) || (CurEmMd == kEmMd_IIx)
+#define SonyDoneCallBack (my_sony_done_addr | 0x40000000)
+#else
+#define SonyDoneCallBack my_sony_done_addr
+#endif
+
+LOCALPROC SonyAsyncForget(void)
+{
+	/*
+		The transfer can't be stopped, so wait for it, then act
+		as if it never was.
+	*/
+	tMacErr r;
+	ui5r n;
+
+	if (SonyAsyncPending) {
+		(void) vSonyTransferDone(trueblnr, &r, &n);
+	}
+	SonyAsyncPending = falseblnr;
+	SonyAsyncFinished = falseblnr;
+}
+#endif
+
 /* This checks to see if a disk (image) has been inserted */
 GLOBALPROC Sony_Update (void)
 {
+#if IncludeSonyAsync
+	/*
+		finish only where a real interrupt could, not in
+		the middle of something done with interrupts masked
+	*/
+	if (SonyAsyncPending && (0 == GetInterruptMask())
+		&& vSonyTransferDone(falseblnr,
+			&SonyAsyncResult, &SonyAsyncActCount))
+	{
+		SonyAsyncPending = falseblnr;
+		SonyAsyncFinished = trueblnr;
+		DiskInsertedPsuedoException(SonyDoneCallBack, 0);
+	}
+#endif
+
 	if (DelayUntilNextInsert != 0) {
 		--DelayUntilNextInsert;
 	} else {
@@ -550,6 +615,66 @@ LOCALFUNC tMacErr Drive_Transfer(blnr IsWrite, CPTR Buffera,
 	return result;
 }
 
+#if IncludeSonyAsync
+LOCALFUNC blnr Drive_TransferStart(blnr IsWrite, CPTR Buffera,
+	tDrive Drive_No, ui5r Sony_Start, ui5r Sony_Count)
+{
+	/*
+		Like Drive_Transfer, but only starts it, if the OSGLU
+		takes it. If false, nothing was done, and Drive_Transfer
+		should be used, which also takes care of any errors.
+	*/
+	ui5r DataSize = ImageDataSize[Drive_No];
+	ui5r L;
+	ui5b contig;
+	ui3p Buffer;
+
+	if ((0 == my_sony_done_addr)
+		|| SonyAsyncPending || SonyAsyncFinished
+		|| (mnvm_noErr != CheckReadableDrive(Drive_No))
+		|| (IsWrite && vSonyIsLocked(Drive_No))
+		|| (Sony_Start >= DataSize))
+	{
+		return falseblnr;
+	}
+
+	L = DataSize - Sony_Start;
+	SonyAsyncHitEOF = (L < Sony_Count);
+	if (! SonyAsyncHitEOF) {
+		L = Sony_Count;
+	}
+
+	/* the host works on emulated memory, which must be in one piece */
+	Buffer = get_real_address0(L, ! IsWrite, Buffera, &contig);
+	if ((contig < L)
+		|| ! vSonyTransferStart(IsWrite, Buffer, Drive_No,
+			ImageDataOffset[Drive_No] + Sony_Start, L))
+	{
+		return falseblnr;
+	}
+
+	QuietEnds();
+
+	SonyAsyncDrive_No = Drive_No;
+	SonyAsyncIsWrite = IsWrite;
+	SonyAsyncStart = Sony_Start;
+	SonyAsyncCount = Sony_Count;
+
+	return trueblnr;
+}
+#endif
+
+#if IncludeSonyAsync
+LOCALFUNC tMacErr Drive_TransferEnd(tMacErr result)
+{
+	if ((mnvm_noErr == result) && SonyAsyncHitEOF) {
+		result = mnvm_eofErr;
+	}
+
+	return result;
+}
+#endif
+
 LOCALVAR blnr QuitOnEject = falseblnr;
 
 GLOBALPROC Sony_SetQuitOnEject(void)
@@ -617,6 +742,9 @@ GLOBALPROC Sony_Reset(void)
 	DelayUntilNextInsert = 0;
 	QuitOnEject = falseblnr;
 	MountCallBack = 0;
+#if IncludeSonyAsync
+	SonyAsyncForget();
+#endif
 }
 
 /*
@@ -1125,6 +1253,17 @@ label_fail:
 #endif
 
 /* Handles I/O to disks */
+LOCALPROC Sony_PrimeResult(CPTR ParamBlk, tMacErr result,
+	ui5r Sony_ActCount)
+{
+	put_vm_word(ParamBlk + kioResult, result);
+	put_vm_long(ParamBlk + kioActCount, Sony_ActCount);
+
+	if (mnvm_noErr != result) {
+		put_vm_word(0x0142 /* DskErr */, result);
+	}
+}
+
 LOCALFUNC tMacErr Sony_Prime(CPTR p)
 {
 	tMacErr result;
@@ -1257,8 +1396,26 @@ LOCALFUNC tMacErr Sony_Prime(CPTR p)
 			result = mnvm_wPrErr;
 		} else {
 			CPTR Buffera = get_vm_long(ParamBlk + kioBuffer);
-			result = Drive_Transfer(IsWrite, Buffera, Drive_No,
+#if IncludeSonyAsync
+			if ((0 == (IOTrap & 0x0200)) /* queued, can finish later */
+				&& Drive_TransferStart(IsWrite, Buffera, Drive_No,
+					Sony_Start, Sony_Count))
+			{
+				if (! vSonyTransferDone(falseblnr,
+					&result, &Sony_ActCount))
+				{
+					SonyAsyncParamBlk = ParamBlk;
+					SonyAsyncDeviceCtl = DeviceCtl;
+					SonyAsyncPending = trueblnr;
+					return kSonyInProgress;
+				}
+				result = Drive_TransferEnd(result);
+			} else
+#endif
+			{
+				result = Drive_Transfer(IsWrite, Buffera, Drive_No,
 					Sony_Start, Sony_Count, &Sony_ActCount);
+			}
 #if Sony_SupportTags
 			if (mnvm_noErr == result) {
 				result = Sony_PrimeTags(Drive_No,
@@ -1271,15 +1428,40 @@ LOCALFUNC tMacErr Sony_Prime(CPTR p)
 	}
 
 label_fail:
-	put_vm_word(ParamBlk + kioResult, result);
-	put_vm_long(ParamBlk + kioActCount, Sony_ActCount);
+	Sony_PrimeResult(ParamBlk, result, Sony_ActCount);
 
-	if (mnvm_noErr != result) {
-		put_vm_word(0x0142 /* DskErr */, result);
-	}
 	return result;
 }
 
+#if IncludeSonyAsync
+LOCALFUNC tMacErr Sony_Done(CPTR p)
+{
+	tMacErr result;
+
+	if (! SonyAsyncFinished) {
+		/* killed, or reset, since */
+		return mnvm_miscErr;
+	}
+	SonyAsyncFinished = falseblnr;
+
+	result = Drive_TransferEnd(SonyAsyncResult);
+#if Sony_SupportTags
+	if (mnvm_noErr == result) {
+		result = Sony_PrimeTags(SonyAsyncDrive_No,
+			SonyAsyncStart, SonyAsyncCount, SonyAsyncIsWrite);
+	}
+#endif
+	put_vm_long(SonyAsyncDeviceCtl + kdCtlPosition,
+		SonyAsyncStart + SonyAsyncActCount);
+	Sony_PrimeResult(SonyAsyncParamBlk, result, SonyAsyncActCount);
+
+	put_vm_long(p + ExtnDat_params + 0, SonyAsyncDeviceCtl);
+	put_vm_word(p + ExtnDat_params + 4, result);
+
+	return mnvm_noErr;
+}
+#endif
+
 /* Implements control csCodes for the Sony driver */
 LOCALFUNC tMacErr Sony_Control(CPTR p)
 {
@@ -1293,7 +1475,15 @@ LOCALFUNC tMacErr Sony_Control(CPTR p)
 		dbglog_WriteNote("Sony : Control : kKillIO");
 #endif
 
-		result = mnvm_miscErr;
+#if IncludeSonyAsync
+		if (SonyAsyncPending || SonyAsyncFinished) {
+			SonyAsyncForget();
+			result = mnvm_noErr;
+		} else
+#endif
+		{
+			result = mnvm_miscErr;
+		}
 	} else if (kSetTagBuffer == OpCode) {
 #if Sony_dolog
 		dbglog_WriteNote("Sony : Control : kSetTagBuffer");
@@ -1642,6 +1832,9 @@ LOCALFUNC tMacErr Sony_OpenC(CPTR p)
 #define kCmndSonyOpenB 6
 #define kCmndSonyOpenC 7
 #define kCmndSonyMount 8
+#if IncludeSonyAsync
+#define kCmndSonyDone 9
+#endif
 
 GLOBALPROC ExtnSony_Access(CPTR p)
 {
@@ -1676,6 +1869,11 @@ GLOBALPROC ExtnSony_Access(CPTR p)
 		case kCmndSonyMount:
 			result = Sony_Mount(p);
 			break;
+#if IncludeSonyAsync
+		case kCmndSonyDone:
+			result = Sony_Done(p);
+			break;
+#endif
 		default:
 			result = mnvm_controlErr;
 			break;
@@ -0,0 +1,236 @@
+/*
+ XFCN that plays a MOD file using the MOD player built into our version
+ of Mini vMac, which mixes it on the host instead of on the emulated Mac.
+ Meant to be called in place of PlayMOD when it's available:
+
+   HostMOD()                        -> "true" if the host can play MODs
+   HostMOD("play", path [, "loop"]) -> "" or an error number
+   HostMOD("stop")
+   HostMOD("volume", 0 to 256)
+   HostMOD("position")              -> "order,row,playing"
+
+ The module is read into a handle just long enough for the emulator
+ to copy it, so nothing is left in HyperCard's heap while it plays.
+
+ To use it in the stack, where it plays music with PlayMOD:
+
+   if HostMOD() is "true" then
+     get HostMOD("play", modPath, "loop")
+   else
+     -- PlayMOD as before
+   end if
+
+ and HostMOD("stop") where it stops the music.
+*/
+
+#include "HyperXCmd.h"
+#include "Files.h"
+
+#define SonyVarsPtr 0x0134
+#define kcom_checkval 0x841339E2
+#define kcom_callcheck 0x5B17
+
+#define kExtnFindExtn 0
+#define kCmndFindExtnFind 1
+#define kHostModPlayerExtension 0x4D8A3C19
+
+#define kCmndModPlayerLoad 2
+#define kCmndModPlayerPlay 3
+#define kCmndModPlayerStop 4
+#define kCmndModPlayerSetVolume 5
+#define kCmndModPlayerGetPosition 6
+#define kCmndModPlayerUnload 7
+
+typedef struct {
+    unsigned short checkval;
+    unsigned short extension;
+    unsigned short commnd;
+    short result;
+    unsigned short params[8];
+} ExtnBlock;
+
+Ptr findPokeAddr(void)
+{
+    Ptr sonyVars = *(Ptr *)SonyVarsPtr;
+
+    if (sonyVars == nil || *(long *)(sonyVars + 16) != kcom_checkval) {
+        return nil;
+    }
+
+    return *(Ptr *)(sonyVars + 20);
+}
+
+short callExtn(Ptr pokeAddr, ExtnBlock *block, short extension,
+    short commnd)
+{
+    long addr = (long)StripAddress((Ptr)block);
+
+    block->checkval = kcom_callcheck;
+    block->extension = extension;
+    block->commnd = commnd;
+    block->result = -1;
+
+    *(volatile unsigned short *)(pokeAddr + 0) = addr >> 16;
+    *(volatile unsigned short *)(pokeAddr + 2) = addr & 0xFFFF;
+
+    return block->result;
+}
+
+short findModPlayer(Ptr pokeAddr)
+{
+    ExtnBlock block;
+
+    block.params[0] = kHostModPlayerExtension >> 16;
+    block.params[1] = kHostModPlayerExtension & 0xFFFF;
+    if (callExtn(pokeAddr, &block, kExtnFindExtn, kCmndFindExtnFind) != 0) {
+        return -1;
+    }
+
+    return block.params[2];
+}
+
+void returnString(XCmdPtr paramPtr, char *s)
+{
+    Str255 str;
+    short i;
+
+    for (i = 0; s[i] != 0 && i < 255; ++i) {
+        str[i + 1] = s[i];
+    }
+    str[0] = i;
+    paramPtr->returnValue = PasToZero(paramPtr, str);
+}
+
+void returnNumber(XCmdPtr paramPtr, long n)
+{
+    Str255 str;
+
+    NumToStr(paramPtr, n, str);
+    paramPtr->returnValue = PasToZero(paramPtr, str);
+}
+
+Boolean paramIs(XCmdPtr paramPtr, short i, char *s)
+{
+    Str255 str;
+    short k;
+
+    if (paramPtr->paramCount <= i || paramPtr->params[i] == nil) {
+        return false;
+    }
+    ZeroToPas(paramPtr, *paramPtr->params[i], str);
+    for (k = 0; s[k] != 0; ++k) {
+        if (k >= str[0] || (str[k + 1] | 0x20) != s[k]) {
+            return false;
+        }
+    }
+
+    return k == str[0];
+}
+
+short playModule(XCmdPtr paramPtr, Ptr pokeAddr, short id)
+{
+    ExtnBlock block;
+    Str255 path;
+    short refNum;
+    long size;
+    Handle data;
+    OSErr err;
+
+    if (paramPtr->paramCount < 2 || paramPtr->params[1] == nil) {
+        return paramErr;
+    }
+    ZeroToPas(paramPtr, *paramPtr->params[1], path);
+
+    err = FSOpen(path, 0, &refNum);
+    if (err != noErr) {
+        return err;
+    }
+    err = GetEOF(refNum, &size);
+    if (err == noErr) {
+        data = NewHandle(size);
+        err = MemError();
+    }
+    if (err == noErr) {
+        HLock(data);
+        err = FSRead(refNum, &size, *data);
+        if (err != noErr) {
+            DisposHandle(data);
+        }
+    }
+    FSClose(refNum);
+    if (err != noErr) {
+        return err;
+    }
+
+    block.params[0] = (long)StripAddress(*data) >> 16;
+    block.params[1] = (long)StripAddress(*data) & 0xFFFF;
+    block.params[2] = size >> 16;
+    block.params[3] = size & 0xFFFF;
+    err = callExtn(pokeAddr, &block, id, kCmndModPlayerLoad);
+    DisposHandle(data);
+    if (err != noErr) {
+        return err;
+    }
+
+    block.params[0] = 0;
+    block.params[1] = paramIs(paramPtr, 2, "loop") ? 1 : 0;
+
+    return callExtn(pokeAddr, &block, id, kCmndModPlayerPlay);
+}
+
+pascal void main(XCmdPtr paramPtr)
+{
+    ExtnBlock block;
+    Str255 str;
+    Str255 num;
+    Ptr pokeAddr;
+    short id = -1;
+    short err;
+    short i;
+
+    pokeAddr = findPokeAddr();
+    if (pokeAddr != nil) {
+        id = findModPlayer(pokeAddr);
+    }
+
+    if (paramPtr->paramCount == 0) {
+        returnString(paramPtr, (id >= 0) ? "true" : "false");
+        return;
+    }
+
+    if (id < 0) {
+        returnString(paramPtr, "not available");
+        return;
+    }
+
+    if (paramIs(paramPtr, 0, "play")) {
+        err = playModule(paramPtr, pokeAddr, id);
+        if (err != noErr) {
+            returnNumber(paramPtr, err);
+        }
+    } else if (paramIs(paramPtr, 0, "stop")) {
+        (void)callExtn(pokeAddr, &block, id, kCmndModPlayerUnload);
+    } else if (paramIs(paramPtr, 0, "volume")) {
+        if (paramPtr->paramCount < 2 || paramPtr->params[1] == nil) {
+            return;
+        }
+        ZeroToPas(paramPtr, *paramPtr->params[1], str);
+        block.params[0] = StrToNum(paramPtr, str);
+        (void)callExtn(pokeAddr, &block, id, kCmndModPlayerSetVolume);
+    } else if (paramIs(paramPtr, 0, "position")) {
+        if (callExtn(pokeAddr, &block, id, kCmndModPlayerGetPosition)
+            != noErr)
+        {
+            return;
+        }
+        NumToStr(paramPtr, block.params[0], str);
+        str[++str[0]] = ',';
+        NumToStr(paramPtr, block.params[1], num);
+        for (i = 1; i <= num[0]; ++i) {
+            str[++str[0]] = num[i];
+        }
+        str[++str[0]] = ',';
+        str[++str[0]] = block.params[2] ? '1' : '0';
+        paramPtr->returnValue = PasToZero(paramPtr, str);
+    }
+}